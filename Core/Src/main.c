@@ -60,8 +60,9 @@ int        main(void)
     uint32_t count = 0;
     while (1)
     {
-        log_i("get tick: %llu ms", BSP_GetTick());
+        log_i("get tick: %llu ms", BSP_GetTick64());
         DL_GPIO_togglePins(GPIO_LEDS_PORT, GPIO_LEDS_USER_LED_PIN);
+        elog_idle();
         bsp_delay_ms(500);
     }
 }
@@ -120,6 +121,8 @@ void app_elog_init(void)
  *
  * @note 1. Copy RW data from Flash to RAM
  *       2. Zero-initialize ZI data (BSS)
+ *       3. RW_NOINIT region is skipped, it keeps the crash record of
+ *          EasyLogger over reset
  *
  * @warning Cannot use memcpy/memset. Must be called in startup
  *          before C library initialization.
@@ -14,9 +14,12 @@
  * 1. Call BSP_Delay_Init() to initialize delay counter
  * 2. Use BSP_Delay_ms() for millisecond delays
  * 3. Use BSP_GetTick() to get system timestamp
+ * 4. Use BSP_GetTick64()/BSP_GetTimeUs64()/BSP_GetTimeCnt64() to get
+ *    tear-free 64-bit timestamp with sub-millisecond resolution
  *
- * @version V2.0 2025-11-15
+ * @version V2.1 2026-10-17
  * @note Changed from SysTick to TIMERG0, uses 64-bit counter internally
+ * @note 64-bit timestamp is read by sequence counter, safe in ISR
  * @note 1 tab == 4 spaces!
  *
  *****************************************************************************/
@@ -87,6 +90,56 @@ void bsp_delay_us_block(uint32_t us);
  ******************************************************************/
 uint32_t BSP_GetTick(void);
 
+/******************************************************************
+ * @brief  Get 64-bit system tick count in milliseconds
+ *
+ * @param[in] : None
+ *
+ * @param[out] : None
+ *
+ * @retval System tick count in milliseconds since initialization
+ *
+ * @note Tear-free, can be called in thread mode and any ISR
+ ******************************************************************/
+uint64_t BSP_GetTick64(void);
+
+/******************************************************************
+ * @brief  Get 64-bit system time in microseconds
+ *
+ * @param[in] : None
+ *
+ * @param[out] : None
+ *
+ * @retval System time in microseconds since initialization
+ *
+ * @note Combines millisecond counter with live TIMERG0 count
+ ******************************************************************/
+uint64_t BSP_GetTimeUs64(void);
+
+/******************************************************************
+ * @brief  Get 64-bit system time in TIMERG0 clock counts
+ *
+ * @param[in] : None
+ *
+ * @param[out] : None
+ *
+ * @retval System time in timer counts since initialization
+ *
+ * @note 1 count = 25ns at 40MHz timer clock, see BSP_GetTimeCntFreq()
+ ******************************************************************/
+uint64_t BSP_GetTimeCnt64(void);
+
+/******************************************************************
+ * @brief  Get TIMERG0 clock count frequency
+ *
+ * @param[in] : None
+ *
+ * @param[out] : None
+ *
+ * @retval Timer counts per second
+ ******************************************************************/
+uint32_t BSP_GetTimeCntFreq(void);
+
 //************************** Function Declarations **************************//
 
 #ifdef __cplusplus
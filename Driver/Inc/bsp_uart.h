@@ -0,0 +1,144 @@
+/******************************************************************************
+ * @file bsp_uart.h
+ *
+ * @par dependencies
+ * - <stdbool.h>
+ * - <stddef.h>
+ * - <stdint.h>
+ * - "ti_msp_dl_config.h" (implementation file)
+ *
+ * @author Ethan-Hang
+ *
+ * @brief BSP non-blocking UART transmit driver based on UART_0
+ *
+ * Processing flow:
+ *
+ * 1. Call bsp_uart_init() to set the baud rate and enable TX interrupt
+ * 2. Call bsp_uart_write() to copy data to the fill buffer, it never
+ *    waits for the UART
+ * 3. UART_0 ISR feeds the TX FIFO from the send buffer, then swaps
+ *    the two buffers when the send buffer is empty
+ * 4. Use bsp_uart_get_free()/bsp_uart_get_stat() for backpressure and
+ *    drop statistics
+ *
+ * @version V1.0 2026-10-17
+ * @note The data which has no space is dropped as a whole
+ * @note 1 tab == 4 spaces!
+ *
+ *****************************************************************************/
+
+#ifndef __BSP_UART_H
+#define __BSP_UART_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//******************************** Includes *********************************//
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+//******************************** Includes *********************************//
+
+//******************************** Defines **********************************//
+/* Size of each of the two TX buffers, one is sent while the other is filled
+ *
+ * Throughput and backpressure model at 921600 baud, 8N1 (10 bits per byte):
+ * - Line rate is 92160 B/s, 10.85 us per byte
+ * - One 512 byte buffer is shifted out in 5.56 ms, it is the max time a
+ *   write waits in the fill buffer before it starts to be sent
+ * - The fill buffer takes a 512 byte burst while the other one is sent, so
+ *   up to 1024 bytes are in flight, such as 12 lines of 80 bytes at once
+ * - The sustained rate must be under the line rate, 80 byte lines are
+ *   limited to 1152 lines/s, the write over it is dropped as a whole and
+ *   counted by drop_num/drop_bytes
+ * - TX FIFO is 4 bytes with the half empty threshold, the ISR runs every
+ *   2 bytes, about 46k times per second when the UART is saturated
+ * - RAM cost is 2 * BSP_UART_TX_BUF_SIZE, 1 KB of the 32 KB SRAM
+ */
+#ifndef BSP_UART_TX_BUF_SIZE
+#define BSP_UART_TX_BUF_SIZE 512U
+#endif
+
+/* UART transmit statistics */
+typedef struct
+{
+    uint32_t tx_bytes;   /* Bytes accepted by bsp_uart_write()           */
+    uint32_t drop_bytes; /* Bytes dropped because the fill buffer is full */
+    uint32_t drop_num;   /* Writes dropped because the fill buffer is full */
+    uint32_t swap_num;   /* Buffer swaps by ISR                          */
+    uint16_t max_used;   /* Max used bytes of the fill buffer            */
+} bsp_uart_stat_t;
+//******************************** Defines **********************************//
+
+//************************** Function Declarations **************************//
+
+/******************************************************************
+ * @brief  Initialize UART_0 transmit driver
+ *
+ * @param[in] : baud_rate - Baud rate, such as 921600
+ *
+ * @param[out] : None
+ *
+ * @retval None
+ *
+ * @note Pins, frame format and clock are configured by SysConfig,
+ *       the baud rate divisor and oversampling are reconfigured here
+ ******************************************************************/
+void bsp_uart_init(uint32_t baud_rate);
+
+/******************************************************************
+ * @brief  Write data to UART without waiting
+ *
+ * @param[in] : data - Data to transmit
+ *              size - Data size
+ *
+ * @param[out] : None
+ *
+ * @retval Written size, 0: no space in the fill buffer, data dropped
+ *
+ * @note Safe in thread mode and any ISR, only the buffer claim and
+ *       commit mask interrupts, the copy does not
+ ******************************************************************/
+size_t bsp_uart_write(const void *data, size_t size);
+
+/******************************************************************
+ * @brief  Get free space of the fill buffer
+ *
+ * @param[in] : None
+ *
+ * @param[out] : None
+ *
+ * @retval Bytes which can be written without dropping
+ ******************************************************************/
+size_t bsp_uart_get_free(void);
+
+/******************************************************************
+ * @brief  Check UART transmit is idle
+ *
+ * @param[in] : None
+ *
+ * @param[out] : None
+ *
+ * @retval true: both buffers are sent to TX FIFO
+ ******************************************************************/
+bool bsp_uart_is_idle(void);
+
+/******************************************************************
+ * @brief  Get UART transmit statistics
+ *
+ * @param[in] : None
+ *
+ * @param[out] : stat - Statistics
+ *
+ * @retval None
+ ******************************************************************/
+void bsp_uart_get_stat(bsp_uart_stat_t *stat);
+
+//************************** Function Declarations **************************//
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BSP_UART_H */
@@ -13,9 +13,13 @@
  *
  * TIMERG0 generates 1ms periodic interrupt to increment tick counter.
  * Delay functions use this counter for accurate timing.
+ * Sub-millisecond time is the tick counter plus the elapsed TIMERG0
+ * counts in current period (the timer counts down from LOAD_VALUE).
  *
- * @version V2.0 2025-11-15
+ * @version V2.1 2026-10-17
  * @note Changed from SysTick to TIMERG0, counter changed to uint64_t
+ * @note The 64-bit counter is updated with IRQ masked and read by a
+ *       sequence counter, the reader retries when the ISR ran meanwhile
  * @note 1 tab == 4 spaces!
  *
  ******************************************************************************/
@@ -26,12 +30,57 @@
 //******************************** Includes *********************************//
 
 //******************************** Defines **********************************//
+/* Timer counts per millisecond and per microsecond (40000 and 40 at 40MHz) */
+#define BSP_TIMER_CNT_PER_MS ((uint32_t)TIMER_Delay_INST_LOAD_VALUE + 1U)
+#define BSP_TIMER_CNT_PER_US (BSP_TIMER_CNT_PER_MS / 1000U)
+/* cnt / CNT_PER_US == (cnt * US_RECIP) >> 20 for cnt < CNT_PER_MS, M0+ has no divider */
+#define BSP_TIMER_US_RECIP   ((1UL << 20) / BSP_TIMER_CNT_PER_US + 1U)
+
 /* Private variables */
-static volatile uint64_t g_timer_ms = 0; /* Millisecond counter (64-bit) */
+static volatile uint64_t g_timer_ms  = 0; /* Millisecond counter (64-bit) */
+static volatile uint32_t g_timer_seq = 0; /* Changed on every counter update */
 //******************************** Defines **********************************//
 
 //************************** Function Implementations ***********************//
 
+/******************************************************************
+ * @brief  Read millisecond counter and elapsed counts consistently
+ *
+ * @param[in] : None
+ *
+ * @param[out] : ms      - Millisecond counter
+ *               elapsed - Elapsed timer counts in current millisecond
+ *
+ * @retval None
+ *
+ * @note The zero event may be pending when IRQ is masked or the ISR
+ *       is not entered yet, then the counter is one millisecond late
+ ******************************************************************/
+static void bsp_time_read(uint64_t *ms, uint32_t *elapsed)
+{
+    uint32_t seq;
+    uint32_t count;
+    uint32_t pending;
+
+    do
+    {
+        seq     = g_timer_seq;
+        *ms     = g_timer_ms;
+        count   = DL_Timer_getTimerCount(TIMER_Delay_INST);
+        pending = DL_TimerG_getRawInterruptStatus(TIMER_Delay_INST,
+                                                  DL_TIMERG_INTERRUPT_ZERO_EVENT);
+    } while (seq != g_timer_seq);
+
+    if (pending)
+    {
+        /* Zero event is not counted yet, re-read count after the event */
+        count = DL_Timer_getTimerCount(TIMER_Delay_INST);
+        (*ms)++;
+    }
+    /* The millisecond is counted at zero, then counts from LOAD_VALUE */
+    *elapsed = (count == 0U) ? 0U : (BSP_TIMER_CNT_PER_MS - count);
+}
+
 /******************************************************************
  * @brief  TIMERG0 interrupt handler (1ms period)
  *
@@ -41,18 +90,27 @@ static volatile uint64_t g_timer_ms = 0; /* Millisecond counter (64-bit) */
  *
  * @retval None
  *
- * @note This ISR is called every 1ms by TIMERG0 (TIMER_Delay)
+ * @note This ISR is called every 1ms by TIMERG0 (TIMER_Delay), the
+ *       interrupt index is not read because reading it clears the
+ *       zero event before the counter is updated
  ******************************************************************/
 void                     TIMER_Delay_INST_IRQHandler(void)
 {
-    switch (DL_TimerG_getPendingInterrupt(TIMER_Delay_INST))
+    uint32_t primask = __get_PRIMASK();
+
+    /* Higher priority ISR may read the counter, mask it while updating.
+     * The zero event is cleared only after it is counted, so the reader
+     * sees either the pending event or the new counter, never neither */
+    __disable_irq();
+    if (DL_TimerG_getRawInterruptStatus(TIMER_Delay_INST,
+                                        DL_TIMERG_INTERRUPT_ZERO_EVENT))
     {
-        case DL_TIMERG_IIDX_ZERO:
-            g_timer_ms++;
-            break;
-        default:
-            break;
+        g_timer_ms++;
+        g_timer_seq++;
+        DL_TimerG_clearInterruptStatus(TIMER_Delay_INST,
+                                       DL_TIMERG_INTERRUPT_ZERO_EVENT);
     }
+    __set_PRIMASK(primask);
 }
 
 /******************************************************************
@@ -73,6 +131,7 @@ void bsp_delay_init(uint32_t sysclk_freq)
     (void)sysclk_freq; /* Unused - timer configured by SysConfig */
 
     g_timer_ms = 0;
+    g_timer_seq++;
 
     /* Enable TIMERG0 interrupt in NVIC */
     NVIC_EnableIRQ(TIMER_Delay_INST_INT_IRQN);
@@ -91,9 +150,10 @@ void bsp_delay_init(uint32_t sysclk_freq)
  ******************************************************************/
 void bsp_delay_ms(uint32_t ms)
 {
-    uint64_t start = g_timer_ms;
+    uint32_t start = BSP_GetTick();
 
-    while ((g_timer_ms - start) < ms)
+    /* 32-bit difference is wrap-safe and needs no 64-bit atomic read */
+    while ((BSP_GetTick() - start) < ms)
     {
         /* Wait for time to elapse */
         // __WFI(); /* Enter sleep mode to save power */
@@ -131,7 +191,88 @@ void bsp_delay_us_block(uint32_t us)
  ******************************************************************/
 uint32_t BSP_GetTick(void)
 {
-    return (uint32_t)g_timer_ms; /* Cast to uint32 for compatibility */
+    return (uint32_t)g_timer_ms; /* Low word read is atomic */
+}
+
+/******************************************************************
+ * @brief  Get 64-bit system tick count in milliseconds
+ *
+ * @param[in] : None
+ *
+ * @param[out] : None
+ *
+ * @retval System tick count in milliseconds since initialization
+ *
+ * @note Retries when TIMERG0 ISR updates the counter meanwhile
+ ******************************************************************/
+uint64_t BSP_GetTick64(void)
+{
+    uint32_t seq;
+    uint64_t ms;
+
+    do
+    {
+        seq = g_timer_seq;
+        ms  = g_timer_ms;
+    } while (seq != g_timer_seq);
+
+    return ms;
+}
+
+/******************************************************************
+ * @brief  Get 64-bit system time in microseconds
+ *
+ * @param[in] : None
+ *
+ * @param[out] : None
+ *
+ * @retval System time in microseconds since initialization
+ *
+ * @note No division, the elapsed counts are scaled by reciprocal
+ ******************************************************************/
+uint64_t BSP_GetTimeUs64(void)
+{
+    uint64_t ms;
+    uint32_t elapsed;
+
+    bsp_time_read(&ms, &elapsed);
+
+    return ms * 1000U + ((elapsed * BSP_TIMER_US_RECIP) >> 20);
+}
+
+/******************************************************************
+ * @brief  Get 64-bit system time in TIMERG0 clock counts
+ *
+ * @param[in] : None
+ *
+ * @param[out] : None
+ *
+ * @retval System time in timer counts since initialization
+ *
+ * @note 25ns resolution at 40MHz timer clock
+ ******************************************************************/
+uint64_t BSP_GetTimeCnt64(void)
+{
+    uint64_t ms;
+    uint32_t elapsed;
+
+    bsp_time_read(&ms, &elapsed);
+
+    return ms * BSP_TIMER_CNT_PER_MS + elapsed;
+}
+
+/******************************************************************
+ * @brief  Get TIMERG0 clock count frequency
+ *
+ * @param[in] : None
+ *
+ * @param[out] : None
+ *
+ * @retval Timer counts per second
+ ******************************************************************/
+uint32_t BSP_GetTimeCntFreq(void)
+{
+    return BSP_TIMER_CNT_PER_MS * 1000U;
 }
 
 //************************** Function Implementations ***********************//
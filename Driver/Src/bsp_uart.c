@@ -0,0 +1,267 @@
+/******************************************************************************
+ * @file bsp_uart.c
+ *
+ * @par dependencies
+ * - <string.h>
+ * - "bsp_uart.h"
+ * - "ti_msp_dl_config.h"
+ *
+ * @author Ethan-Hang
+ *
+ * @brief BSP non-blocking UART transmit driver implementation
+ *
+ * Processing flow:
+ *
+ * Two TX buffers are used. The writer claims space in the fill buffer
+ * with IRQ masked, copies the data with IRQ enabled, then commits it.
+ * UART_0 ISR moves the send buffer to TX FIFO on the TX FIFO threshold
+ * and EOT interrupts. When the send buffer is empty and no writer is
+ * copying, the buffers are swapped, otherwise the TX interrupts are
+ * disabled and the last committing writer starts the ISR again.
+ *
+ * @version V1.0 2026-10-17
+ * @note No byte is busy-waited, the CPU only runs the ISR per half FIFO
+ * @note 1 tab == 4 spaces!
+ *
+ ******************************************************************************/
+
+//******************************** Includes *********************************//
+#include "bsp_uart.h"
+
+#include <string.h>
+
+#include "ti_msp_dl_config.h"
+//******************************** Includes *********************************//
+
+//******************************** Defines **********************************//
+/* TX interrupts: FIFO reaches threshold, and all data is shifted out */
+#define BSP_UART_TX_INTERRUPT                                                  \
+    (DL_UART_MAIN_INTERRUPT_TX | DL_UART_MAIN_INTERRUPT_EOT_DONE)
+
+/* Private variables */
+static uint8_t           g_tx_buf[2][BSP_UART_TX_BUF_SIZE];
+static volatile uint16_t g_tx_len[2]  = {0, 0}; /* Data size in buffer  */
+static volatile uint16_t g_tx_pos     = 0;      /* Send buffer position */
+static volatile uint8_t  g_tx_send    = 0;      /* Send buffer index    */
+static volatile uint8_t  g_tx_writing = 0;      /* Copying writers      */
+static volatile bool     g_tx_busy    = false;  /* TX interrupts on     */
+static bsp_uart_stat_t   g_tx_stat    = {0};    /* Transmit statistics  */
+//******************************** Defines **********************************//
+
+//************************** Function Implementations ***********************//
+
+/******************************************************************
+ * @brief  Move the send buffer to TX FIFO and swap the buffers
+ *
+ * @param[in] : None
+ *
+ * @param[out] : None
+ *
+ * @retval None
+ *
+ * @note Called in UART_0 ISR only
+ ******************************************************************/
+static void bsp_uart_tx_feed(void)
+{
+    uint8_t  send = g_tx_send;
+    uint16_t pos  = g_tx_pos;
+    uint16_t len  = g_tx_len[send];
+
+    while (1)
+    {
+        while (pos < len && !DL_UART_Main_isTXFIFOFull(UART_0_INST))
+        {
+            DL_UART_Main_transmitData(UART_0_INST, g_tx_buf[send][pos++]);
+        }
+        if (pos < len)
+        {
+            /* TX FIFO is full, continue on the next interrupt */
+            break;
+        }
+        /* Stop when the fill buffer is empty or still being copied, the
+         * committing writer starts TX again */
+        if (g_tx_writing || g_tx_len[send ^ 1U] == 0U)
+        {
+            g_tx_len[send] = 0;
+            pos            = 0;
+            g_tx_busy      = false;
+            DL_UART_Main_disableInterrupt(UART_0_INST, BSP_UART_TX_INTERRUPT);
+            break;
+        }
+        /* Swap the buffers, the sent buffer becomes the fill buffer */
+        g_tx_len[send] = 0;
+        send ^= 1U;
+        g_tx_send = send;
+        pos       = 0;
+        len       = g_tx_len[send];
+        g_tx_stat.swap_num++;
+    }
+    g_tx_pos = pos;
+}
+
+/******************************************************************
+ * @brief  UART_0 interrupt handler
+ *
+ * @param[in] : None
+ *
+ * @param[out] : None
+ *
+ * @retval None
+ *
+ * @note It is also entered by NVIC pending when a writer starts TX
+ ******************************************************************/
+void                     UART_0_INST_IRQHandler(void)
+{
+    /* Reading the index clears TX or EOT, software pending has none */
+    (void)DL_UART_Main_getPendingInterrupt(UART_0_INST);
+
+    if (g_tx_busy)
+    {
+        bsp_uart_tx_feed();
+    }
+}
+
+/******************************************************************
+ * @brief  Initialize UART_0 transmit driver
+ *
+ * @param[in] : baud_rate - Baud rate, such as 921600
+ *
+ * @param[out] : None
+ *
+ * @retval None
+ *
+ * @note The oversampling is selected by DriverLib, the max baud rate
+ *       is UART_0_INST_FREQUENCY / 3 (13.3Mbps at 40MHz)
+ ******************************************************************/
+void bsp_uart_init(uint32_t baud_rate)
+{
+    DL_UART_Main_disable(UART_0_INST);
+    DL_UART_Main_configBaudRate(UART_0_INST, UART_0_INST_FREQUENCY, baud_rate);
+    DL_UART_Main_enableFIFOs(UART_0_INST);
+    DL_UART_Main_setTXFIFOThreshold(UART_0_INST,
+                                    DL_UART_MAIN_TX_FIFO_LEVEL_1_2_EMPTY);
+    DL_UART_Main_disableInterrupt(UART_0_INST, BSP_UART_TX_INTERRUPT);
+    DL_UART_Main_enable(UART_0_INST);
+
+    g_tx_len[0]  = 0;
+    g_tx_len[1]  = 0;
+    g_tx_pos     = 0;
+    g_tx_send    = 0;
+    g_tx_writing = 0;
+    g_tx_busy    = false;
+
+    /* Enable UART_0 interrupt in NVIC */
+    NVIC_ClearPendingIRQ(UART_0_INST_INT_IRQN);
+    NVIC_EnableIRQ(UART_0_INST_INT_IRQN);
+}
+
+/******************************************************************
+ * @brief  Write data to UART without waiting
+ *
+ * @param[in] : data - Data to transmit
+ *              size - Data size
+ *
+ * @param[out] : None
+ *
+ * @retval Written size, 0: no space in the fill buffer, data dropped
+ *
+ * @note The buffers are not swapped while any writer is copying, so
+ *       a nested writer in ISR claims the space after the outer one
+ ******************************************************************/
+size_t bsp_uart_write(const void *data, size_t size)
+{
+    uint32_t primask;
+    uint8_t  fill;
+    uint16_t offset;
+
+    if (size == 0U)
+    {
+        return 0;
+    }
+
+    /* Claim the space in the fill buffer */
+    primask = __get_PRIMASK();
+    __disable_irq();
+    fill   = g_tx_send ^ 1U;
+    offset = g_tx_len[fill];
+    if (size > BSP_UART_TX_BUF_SIZE - offset)
+    {
+        g_tx_stat.drop_bytes += size;
+        g_tx_stat.drop_num++;
+        __set_PRIMASK(primask);
+        return 0;
+    }
+    g_tx_len[fill] = (uint16_t)(offset + size);
+    g_tx_writing++;
+    if (g_tx_len[fill] > g_tx_stat.max_used)
+    {
+        g_tx_stat.max_used = g_tx_len[fill];
+    }
+    __set_PRIMASK(primask);
+
+    memcpy(&g_tx_buf[fill][offset], data, size);
+
+    /* Commit, the last writer starts TX when the ISR is stopped */
+    __disable_irq();
+    g_tx_writing--;
+    g_tx_stat.tx_bytes += size;
+    if (!g_tx_busy && g_tx_writing == 0U)
+    {
+        g_tx_busy = true;
+        DL_UART_Main_enableInterrupt(UART_0_INST, BSP_UART_TX_INTERRUPT);
+        NVIC_SetPendingIRQ(UART_0_INST_INT_IRQN);
+    }
+    __set_PRIMASK(primask);
+
+    return size;
+}
+
+/******************************************************************
+ * @brief  Get free space of the fill buffer
+ *
+ * @param[in] : None
+ *
+ * @param[out] : None
+ *
+ * @retval Bytes which can be written without dropping
+ ******************************************************************/
+size_t bsp_uart_get_free(void)
+{
+    return BSP_UART_TX_BUF_SIZE - g_tx_len[g_tx_send ^ 1U];
+}
+
+/******************************************************************
+ * @brief  Check UART transmit is idle
+ *
+ * @param[in] : None
+ *
+ * @param[out] : None
+ *
+ * @retval true: both buffers are sent to TX FIFO
+ *
+ * @note The last bytes may be still in TX FIFO and shift register
+ ******************************************************************/
+bool bsp_uart_is_idle(void)
+{
+    return !g_tx_busy && g_tx_len[g_tx_send ^ 1U] == 0U;
+}
+
+/******************************************************************
+ * @brief  Get UART transmit statistics
+ *
+ * @param[in] : None
+ *
+ * @param[out] : stat - Statistics
+ *
+ * @retval None
+ ******************************************************************/
+void bsp_uart_get_stat(bsp_uart_stat_t *stat)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    *stat = g_tx_stat;
+    __set_PRIMASK(primask);
+}
+
+//************************** Function Implementations ***********************//
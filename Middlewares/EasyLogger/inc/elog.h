@@ -33,6 +33,12 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdarg.h>
+
+/* the timestamp unit is used by all time based features, there is no safe default for it */
+#if !defined(ELOG_TIMESTAMP_PER_MS)
+    #error "Please configure timestamp number per millisecond (in elog_cfg.h)"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -53,9 +59,32 @@ extern "C" {
 /* output log's level total number */
 #define ELOG_LVL_TOTAL_NUM                   6
 
+/* overflow policy of the buffered output when it is full */
+#define ELOG_OVERFLOW_DROP_NEWEST            0
+#define ELOG_OVERFLOW_DROP_OLDEST            1
+#define ELOG_OVERFLOW_BLOCK                  2
+#define ELOG_OVERFLOW_PRIORITY               3
+
+/* the record which has not taken the sequence number, it is taken when the log is output */
+#define ELOG_SEQ_NONE                        0xFFFFFFFF
+
+/* max decimal string length of the unsigned 32-bit number */
+#define ELOG_U32_STR_MAX_LEN                 10
+/* max decimal string length of the unsigned 64-bit number */
+#define ELOG_U64_STR_MAX_LEN                 20
+/* max rendered timestamp string length, the port's timestamp render must not exceed it */
+#define ELOG_TIME_STR_MAX_LEN                24
+
 /* EasyLogger software version number */
 #define ELOG_SW_VERSION                      "2.2.99"
 
+/* the pre-trigger logs are output before the default assert stops */
+#ifdef ELOG_TRIG_ENABLE
+    #define ELOG_ASSERT_TRIG_DRAIN()             elog_trig_drain(SIZE_MAX)
+#else
+    #define ELOG_ASSERT_TRIG_DRAIN()             ((void)0)
+#endif
+
 /* EasyLogger assert for developer. */
 #ifdef ELOG_ASSERT_ENABLE
     #define ELOG_ASSERT(EXPR)                                                 \
@@ -63,6 +92,7 @@ extern "C" {
     {                                                                         \
         if (elog_assert_hook == NULL) {                                       \
             elog_a("elog", "(%s) has assert failed at %s:%ld.", #EXPR, __FUNCTION__, __LINE__); \
+            ELOG_ASSERT_TRIG_DRAIN();                                         \
             while (1);                                                        \
         } else {                                                              \
             elog_assert_hook(#EXPR, __FUNCTION__, __LINE__);                  \
@@ -80,6 +110,9 @@ extern "C" {
     #define elog_info(tag, ...)
     #define elog_debug(tag, ...)
     #define elog_verbose(tag, ...)
+    #define elog_ratelimit(lvl, tag, ...)
+    #define elog_sample(lvl, n, tag, ...)
+    #define elog_kv(lvl, tag, event, ...)
 #else /* ELOG_OUTPUT_ENABLE */
 
     #ifdef ELOG_FMT_USING_FUNC
@@ -100,48 +133,118 @@ extern "C" {
     #define ELOG_OUTPUT_LINE 0
     #endif
 
+    /* call site section, every log call site is placed in it, so the site can be found by
+     * elog_site_set_enabled() and the binary output host decoder */
+    #define ELOG_SITE_SECTION_NAME "elog_site"
+    #define ELOG_FIRST_ARG(first, ...) first
+    /* the constant tag is kept in the call site, the variable tag buffer may be changed */
+    #if defined(__GNUC__) || defined(__ARMCC_VERSION)
+    #define ELOG_CONST_TAG(tag) (__builtin_constant_p(tag) ? (tag) : NULL)
+    #else
+    #define ELOG_CONST_TAG(tag) NULL
+    #endif
+    /* define the call site and it's state, the state is changed at runtime,
+     * the site alignment is fixed, so the sites are contiguous in the section */
+    #define ELOG_SITE_DEFINE(lvl, tag, format)                                \
+        static ElogSiteState elog_site_state;                                 \
+        static const ElogSite elog_site __attribute__((                       \
+                section(ELOG_SITE_SECTION_NAME), used, aligned(sizeof(void *)))) = { \
+            tag, ELOG_OUTPUT_DIR, ELOG_OUTPUT_FUNC, format,                   \
+            ELOG_OUTPUT_LINE, lvl, &elog_site_state                           \
+        }
+
+    #ifdef ELOG_BIN_OUTPUT_ENABLE
+    /* the site keeps it's format, so only the call site ID and arguments will be output */
+    #define ELOG_SITE(lvl, tag, ...)                                          \
+            ELOG_SITE_DEFINE(lvl, tag, ELOG_FIRST_ARG(__VA_ARGS__, 0))
+    #else
+    /* the call site caches it's tag ID, so the filter is only a table lookup */
+    #define ELOG_SITE(lvl, tag, ...)                                          \
+            ELOG_SITE_DEFINE(lvl, ELOG_CONST_TAG(tag), NULL)
+    #endif /* ELOG_BIN_OUTPUT_ENABLE */
+    #define ELOG_SITE_OUTPUT(lvl, tag, ...)                                   \
+            elog_output_site(&elog_site, tag, __VA_ARGS__)
+
+    /* the disabled site only costs a load and branch, the arguments are not evaluated */
+    #define ELOG_OUTPUT_SITE(lvl, tag, ...)                                   \
+    do {                                                                      \
+        ELOG_SITE(lvl, tag, __VA_ARGS__);                                     \
+        if (!elog_site_state.disabled) {                                      \
+            ELOG_SITE_OUTPUT(lvl, tag, __VA_ARGS__);                          \
+        }                                                                     \
+    } while (0)
+    /* the site is throttled by the check, it's limit state is kept by the site,
+     * the filtered log is checked before the check, so it doesn't take a token */
+    #define ELOG_OUTPUT_SITE_LIMIT(lvl, tag, check, ...)                      \
+    do {                                                                      \
+        ELOG_SITE(lvl, tag, __VA_ARGS__);                                     \
+        static ElogRateLimit elog_site_limit;                                 \
+        if ((lvl) <= ELOG_OUTPUT_LVL && !elog_site_state.disabled &&          \
+                elog_site_filter(&elog_site, tag) && (check)) {               \
+            ELOG_SITE_OUTPUT(lvl, tag, __VA_ARGS__);                          \
+        }                                                                     \
+    } while (0)
+
     #define elog_raw(...)  elog_raw_output(__VA_ARGS__)
     #if ELOG_OUTPUT_LVL >= ELOG_LVL_ASSERT
         #define elog_assert(tag, ...) \
-                elog_output(ELOG_LVL_ASSERT, tag, ELOG_OUTPUT_DIR, ELOG_OUTPUT_FUNC, ELOG_OUTPUT_LINE, __VA_ARGS__)
+                ELOG_OUTPUT_SITE(ELOG_LVL_ASSERT, tag, __VA_ARGS__)
     #else
         #define elog_assert(tag, ...)
     #endif /* ELOG_OUTPUT_LVL >= ELOG_LVL_ASSERT */
 
     #if ELOG_OUTPUT_LVL >= ELOG_LVL_ERROR
         #define elog_error(tag, ...) \
-                elog_output(ELOG_LVL_ERROR, tag, ELOG_OUTPUT_DIR, ELOG_OUTPUT_FUNC, ELOG_OUTPUT_LINE, __VA_ARGS__)
+                ELOG_OUTPUT_SITE(ELOG_LVL_ERROR, tag, __VA_ARGS__)
     #else
         #define elog_error(tag, ...)
     #endif /* ELOG_OUTPUT_LVL >= ELOG_LVL_ERROR */
 
     #if ELOG_OUTPUT_LVL >= ELOG_LVL_WARN
         #define elog_warn(tag, ...) \
-                elog_output(ELOG_LVL_WARN, tag, ELOG_OUTPUT_DIR, ELOG_OUTPUT_FUNC, ELOG_OUTPUT_LINE, __VA_ARGS__)
+                ELOG_OUTPUT_SITE(ELOG_LVL_WARN, tag, __VA_ARGS__)
     #else
         #define elog_warn(tag, ...)
     #endif /* ELOG_OUTPUT_LVL >= ELOG_LVL_WARN */
 
     #if ELOG_OUTPUT_LVL >= ELOG_LVL_INFO
         #define elog_info(tag, ...) \
-                elog_output(ELOG_LVL_INFO, tag, ELOG_OUTPUT_DIR, ELOG_OUTPUT_FUNC, ELOG_OUTPUT_LINE, __VA_ARGS__)
+                ELOG_OUTPUT_SITE(ELOG_LVL_INFO, tag, __VA_ARGS__)
     #else
         #define elog_info(tag, ...)
     #endif /* ELOG_OUTPUT_LVL >= ELOG_LVL_INFO */
 
     #if ELOG_OUTPUT_LVL >= ELOG_LVL_DEBUG
         #define elog_debug(tag, ...) \
-                elog_output(ELOG_LVL_DEBUG, tag, ELOG_OUTPUT_DIR, ELOG_OUTPUT_FUNC, ELOG_OUTPUT_LINE, __VA_ARGS__)
+                ELOG_OUTPUT_SITE(ELOG_LVL_DEBUG, tag, __VA_ARGS__)
     #else
         #define elog_debug(tag, ...)
     #endif /* ELOG_OUTPUT_LVL >= ELOG_LVL_DEBUG */
 
     #if ELOG_OUTPUT_LVL == ELOG_LVL_VERBOSE
         #define elog_verbose(tag, ...) \
-                elog_output(ELOG_LVL_VERBOSE, tag, ELOG_OUTPUT_DIR, ELOG_OUTPUT_FUNC, ELOG_OUTPUT_LINE, __VA_ARGS__)
+                ELOG_OUTPUT_SITE(ELOG_LVL_VERBOSE, tag, __VA_ARGS__)
     #else
         #define elog_verbose(tag, ...)
     #endif /* ELOG_OUTPUT_LVL == ELOG_LVL_VERBOSE */
+
+    /* the log is output by token bucket, a summary of the suppressed logs is output later */
+    #define elog_ratelimit(lvl, tag, ...) \
+            ELOG_OUTPUT_SITE_LIMIT(lvl, tag, elog_ratelimit_pass(&elog_site_limit, &elog_site, tag), \
+                    __VA_ARGS__)
+    /* only 1 in n logs is output */
+    #define elog_sample(lvl, n, tag, ...) \
+            ELOG_OUTPUT_SITE_LIMIT(lvl, tag, elog_sample_pass(&elog_site_limit, n), __VA_ARGS__)
+    /* the event name is kept by the site as it's format, the fields are built when it's enabled */
+    #define elog_kv(lvl, tag, event, ...)                                     \
+    do {                                                                      \
+        ELOG_SITE_DEFINE(lvl, ELOG_CONST_TAG(tag), event);                    \
+        if ((lvl) <= ELOG_OUTPUT_LVL && !elog_site_state.disabled) {          \
+            const ElogKvField elog_kv_fields[] = {__VA_ARGS__};               \
+            elog_kv_output(&elog_site, tag, elog_kv_fields,                   \
+                    sizeof(elog_kv_fields) / sizeof(elog_kv_fields[0]));      \
+        }                                                                     \
+    } while (0)
 #endif /* ELOG_OUTPUT_ENABLE */
 
 /* all formats index */
@@ -154,27 +257,238 @@ typedef enum {
     ELOG_FMT_DIR    = 1 << 5, /**< file directory and name */
     ELOG_FMT_FUNC   = 1 << 6, /**< function name */
     ELOG_FMT_LINE   = 1 << 7, /**< line number */
+    ELOG_FMT_SEQ    = 1 << 8, /**< sequence number */
 } ElogFmtIndex;
 
 /* macro definition for all formats */
 #define ELOG_FMT_ALL    (ELOG_FMT_LVL|ELOG_FMT_TAG|ELOG_FMT_TIME|ELOG_FMT_P_INFO|ELOG_FMT_T_INFO| \
-    ELOG_FMT_DIR|ELOG_FMT_FUNC|ELOG_FMT_LINE)
+    ELOG_FMT_DIR|ELOG_FMT_FUNC|ELOG_FMT_LINE|ELOG_FMT_SEQ)
+
+/* char number of the keyword matcher, only ASCII keyword is supported */
+#define ELOG_KW_CHAR_NUM                     128
 
-/* output log's tag filter */
+/* precompiled keyword matcher, all keywords are matched at once by shift-and */
 typedef struct {
-    uint8_t level;
-    char tag[ELOG_FILTER_TAG_MAX_LEN + 1];
-    bool tag_use_flag; /**< false : tag is no used   true: tag is used */
-} ElogTagLvlFilter, *ElogTagLvlFilter_t;
+    /* bit n is set when the char is the n-th char of the concatenated keywords */
+    uint32_t mask[ELOG_KW_CHAR_NUM];
+    /* the first and the last char bit of every keyword, no keyword when end is 0 */
+    uint32_t start;
+    volatile uint32_t end;
+    /* total length and number of the keywords */
+    uint8_t len;
+    uint8_t num;
+} ElogKwMatcher, *ElogKwMatcher_t;
 
 /* output log's filter */
 typedef struct {
     uint8_t level;
     char tag[ELOG_FILTER_TAG_MAX_LEN + 1];
-    char keyword[ELOG_FILTER_KW_MAX_LEN + 1];
-    ElogTagLvlFilter tag_lvl[ELOG_FILTER_TAG_LVL_MAX_NUM];
+    ElogKwMatcher kw;
 } ElogFilter, *ElogFilter_t;
 
+/* interned tag ID, every tag has it's own filter level */
+typedef uint8_t ElogTagId;
+#define ELOG_TAG_ID_NONE                     0
+
+/* tag ID cache of a log call site */
+typedef struct {
+    const char *volatile tag;
+    volatile ElogTagId id;
+} ElogTagCache, *ElogTagCache_t;
+
+/* max nested context number which can package log at the same time */
+#ifndef ELOG_CTX_MAX_NUM
+#define ELOG_CTX_MAX_NUM                     3
+#endif
+
+/* captured arguments default settings */
+#ifndef ELOG_ARGS_MAX_NUM
+#define ELOG_ARGS_MAX_NUM                    8
+#endif
+#ifndef ELOG_ARGS_STR_BUF_SIZE
+#define ELOG_ARGS_STR_BUF_SIZE               32
+#endif
+
+/* raw arguments which are captured from a log call, they can be formatted later */
+typedef struct {
+    uint32_t arg[ELOG_ARGS_MAX_NUM];
+    char str[ELOG_ARGS_STR_BUF_SIZE];
+    uint8_t arg_num;
+    uint8_t str_len;
+} ElogArgs, *ElogArgs_t;
+
+/* runtime state of a log call site, it is zero initialized */
+typedef struct {
+    ElogTagCache cache;
+    /* the site is disabled by elog_site_set_enabled() */
+    volatile uint8_t disabled;
+} ElogSiteState, *ElogSiteState_t;
+
+/* log call site, it is constant and placed in the site section */
+typedef struct {
+    /* NULL: the tag is variable */
+    const char *tag;
+    const char *file;
+    const char *func;
+    /* only used by binary output mode */
+    const char *format;
+    uint32_t line;
+    uint32_t level;
+    ElogSiteState *state;
+} ElogSite, *ElogSite_t;
+
+/* the log is not output by a call site, such as elog_output() and hex dump */
+#define ELOG_SITE_ID_NONE                    0xFFFF
+
+/* rate limit and sampling state of a log call site, it is zero initialized */
+typedef struct ElogRateLimit {
+    /* the last token refill time, it is the low 32-bit timestamp */
+    uint32_t tick;
+    /* the used token number for rate limit, or the log counter for sampling */
+    uint16_t count;
+    /* suppressed log number since the last output */
+    uint16_t suppressed;
+    /* the suppressing site and it's tag, NULL: the limit is not in the pending list */
+    const ElogSite *site;
+    struct ElogRateLimit *next;
+    ElogTagId tag_id;
+} ElogRateLimit, *ElogRateLimit_t;
+
+/* key-value log field type */
+typedef enum {
+    ELOG_KV_TYPE_INT,
+    ELOG_KV_TYPE_UINT,
+    ELOG_KV_TYPE_FIXED,
+    ELOG_KV_TYPE_STR,
+    ELOG_KV_TYPE_BYTES,
+} ElogKvType;
+
+/* key-value log field, it is built by the ELOG_KV_XXX macros */
+typedef struct {
+    const char *key;
+    uint8_t type;
+    /* decimal fraction digits of the fixed-point value, 0-9 */
+    uint8_t scale;
+    /* bytes size */
+    uint16_t size;
+    union {
+        int32_t i;
+        uint32_t u;
+        const char *s;
+        const void *b;
+    } value;
+} ElogKvField, *ElogKvField_t;
+
+/* key-value log fields, the fixed-point value is (value / 10^scale), such as ELOG_KV_FIXED("v", 1234, 2) is 12.34 */
+#define ELOG_KV_INT(key, v)            {key, ELOG_KV_TYPE_INT, 0, 0, {.i = (int32_t) (v)}}
+#define ELOG_KV_UINT(key, v)           {key, ELOG_KV_TYPE_UINT, 0, 0, {.u = (uint32_t) (v)}}
+#define ELOG_KV_FIXED(key, v, scale)   {key, ELOG_KV_TYPE_FIXED, scale, 0, {.i = (int32_t) (v)}}
+#define ELOG_KV_STR(key, v)            {key, ELOG_KV_TYPE_STR, 0, 0, {.s = (v)}}
+#define ELOG_KV_BYTES(key, v, n)       {key, ELOG_KV_TYPE_BYTES, 0, (uint16_t) (n), {.b = (v)}}
+
+/* output space which is reserved in port, it is split into two parts when wrapping */
+typedef struct {
+    char *buf[2];
+    size_t size[2];
+} ElogSpan, *ElogSpan_t;
+
+/* output stage which may drop or truncate the log */
+typedef enum {
+    ELOG_STAGE_CORE,     /**< line buffer and context */
+    ELOG_STAGE_DEFERRED, /**< deferred output ring */
+    ELOG_STAGE_ASYNC,    /**< asynchronous output ring */
+    ELOG_STAGE_BUF,      /**< buffered output mode flush */
+    ELOG_STAGE_PORT,     /**< output port, such as RTT channel */
+    ELOG_STAGE_FLASH,    /**< flash plugin */
+    ELOG_STAGE_SINK,     /**< asynchronous sink buffer */
+    ELOG_STAGE_TRIG,     /**< pre-trigger ring */
+    ELOG_STAGE_NUM,
+} ElogStage;
+
+/* the log level is unknown for the counters, such as a block of buffered logs */
+#define ELOG_STAT_LVL_NONE                   0xFF
+
+/* drop and truncation counters of an output stage */
+typedef struct {
+    uint32_t drop[ELOG_LVL_TOTAL_NUM];
+    uint32_t trunc[ELOG_LVL_TOTAL_NUM];
+    /* the total size of dropped logs and truncated parts */
+    uint32_t lost_size;
+} ElogStat, *ElogStat_t;
+
+/*
+ * Log record which is output to the sinks, so the sink can filter and index the log
+ * without parsing the packaged text. The payload is the log message in the packaged log,
+ * it is after the log head and before the CSI end sign and newline sign.
+ */
+typedef struct {
+    uint64_t timestamp;
+    uint32_t seq;
+    uint8_t level;
+    /* ELOG_TAG_ID_NONE: the tag is not interned */
+    ElogTagId tag_id;
+    /* ELOG_SITE_ID_NONE: the log is not output by a call site */
+    uint16_t site_id;
+    /* NULL: the log has no tag */
+    const char *tag;
+    const char *file;
+    const char *func;
+    long line;
+    /* NULL: the log has no format, such as the raw log and hex dump */
+    const char *format;
+    /* the arguments which are captured for the record sinks, NULL: they are not captured */
+    const ElogArgs *args;
+    /* packaged log, NULL: the log is not packaged because only the record sinks accept it */
+    const char *log;
+    size_t size;
+    /* payload offset and size in the packaged log */
+    uint16_t payload;
+    uint16_t payload_size;
+} ElogRecord, *ElogRecord_t;
+
+/* sink output policy */
+typedef enum {
+    ELOG_SINK_SYNC,   /**< output in the log call */
+    ELOG_SINK_ASYNC,  /**< queued and output in elog_idle(), the file, function, line and format are not kept */
+    ELOG_SINK_RECORD, /**< output in the log call, the log is not packaged when only the record sinks accept it */
+} ElogSinkPolicy;
+
+/* log output sink, it is owned by the user and registered to the output router */
+typedef struct {
+    const char *name;
+    /* output the log record, it returns the output size, 0: the log is dropped */
+    size_t (*output)(const ElogRecord *record);
+    /* the log which level is greater than it is not output */
+    uint8_t level;
+    /* @see ElogSinkPolicy */
+    uint8_t policy;
+    /* the log which tag doesn't contain it is not output, NULL: all logs */
+    const char *tag;
+    /* dropped log number */
+    uint32_t drop_num;
+} ElogSink, *ElogSink_t;
+
+/* the reason of the retained crash record */
+typedef enum {
+    ELOG_CRASH_NONE,      /**< no fault, the logs before reset are kept only */
+    ELOG_CRASH_HARDFAULT, /**< HardFault exception */
+    ELOG_CRASH_NMI,       /**< NMI exception */
+    ELOG_CRASH_ASSERT,    /**< ELOG_ASSERT failed */
+} ElogCrashType;
+
+/* fault context of the retained crash record */
+typedef struct {
+    uint32_t type;
+    /* stacked registers by exception: r0, r1, r2, r3, r12, lr, pc, xpsr, all 0 when it is unknown */
+    uint32_t frame[8];
+    /* SP before the exception */
+    uint32_t sp;
+    /* EXC_RETURN of the exception, or the line number of the assert */
+    uint32_t info;
+    /* CRC of the above fields */
+    uint32_t crc;
+} ElogCrashFault, *ElogCrashFault_t;
+
 /* easy logger */
 typedef struct {
     ElogFilter filter;
@@ -210,17 +524,31 @@ void elog_set_filter(uint8_t level, const char *tag, const char *keyword);
 void elog_set_filter_lvl(uint8_t level);
 void elog_set_filter_tag(const char *tag);
 void elog_set_filter_kw(const char *keyword);
+bool elog_add_filter_kw(const char *keyword);
 void elog_set_filter_tag_lvl(const char *tag, uint8_t level);
 uint8_t elog_get_filter_tag_lvl(const char *tag);
+ElogTagId elog_tag_intern(const char *tag);
+const char *elog_tag_get_name(ElogTagId id);
 void elog_raw_output(const char *format, ...);
 void elog_output(uint8_t level, const char *tag, const char *file, const char *func,
         const long line, const char *format, ...);
+void elog_output_with_cache(ElogTagCache *cache, uint8_t level, const char *tag, const char *file,
+        const char *func, const long line, const char *format, ...);
+void elog_output_site(const ElogSite *site, const char *tag, const char *format, ...);
+void elog_output_record(const ElogRecord *record, const char *format, ...);
+void elog_output_record_to(const ElogRecord *record, uint8_t mask, const char *format, ...);
+bool elog_output_filter(uint8_t level, const char *tag, ElogTagCache *cache);
 void elog_output_lock_enabled(bool enabled);
+int elog_ctx_claim(uint8_t level);
+void elog_ctx_release(void);
+size_t elog_get_ctx_drop_num(void);
 extern void (*elog_assert_hook)(const char* expr, const char* func, size_t line);
 void elog_assert_set_hook(void (*hook)(const char* expr, const char* func, size_t line));
 int8_t elog_find_lvl(const char *log);
 const char *elog_find_tag(const char *log, uint8_t lvl, size_t *tag_len);
 void elog_hexdump(const char *name, uint8_t width, const void *buf, uint16_t size);
+size_t elog_hexdump_raw(const char *name, const void *buf, size_t size);
+void elog_idle(void);
 
 #define elog_a(tag, ...)     elog_assert(tag, __VA_ARGS__)
 #define elog_e(tag, ...)     elog_error(tag, __VA_ARGS__)
@@ -269,6 +597,10 @@ void elog_hexdump(const char *name, uint8_t width, const void *buf, uint16_t siz
 #else
     #define log_v(...)       ((void)0);
 #endif
+/* rate limited and sampled log, the level which is greater than LOG_LVL is not output */
+#define log_ratelimit(lvl, ...)   do { if ((lvl) <= LOG_LVL) { elog_ratelimit(lvl, LOG_TAG, __VA_ARGS__); } } while (0)
+#define log_sample(lvl, n, ...)   do { if ((lvl) <= LOG_LVL) { elog_sample(lvl, n, LOG_TAG, __VA_ARGS__); } } while (0)
+#define log_kv(lvl, event, ...)   do { if ((lvl) <= LOG_LVL) { elog_kv(lvl, LOG_TAG, event, __VA_ARGS__); } } while (0)
 
 /* assert API short definition */
 #if !defined(assert)
@@ -278,16 +610,90 @@ void elog_hexdump(const char *name, uint8_t width, const void *buf, uint16_t siz
 /* elog_buf.c */
 void elog_buf_enabled(bool enabled);
 void elog_flush(void);
+void elog_buf_poll(void);
 
 /* elog_async.c */
 void elog_async_enabled(bool enabled);
 size_t elog_async_get_log(char *log, size_t size);
 size_t elog_async_get_line_log(char *log, size_t size);
+size_t elog_async_drain(size_t max_size);
+bool elog_async_flush(uint32_t timeout);
+void elog_async_wait_space(uint8_t level, size_t size);
+
+/* elog_deferred.c */
+void elog_deferred_enabled(bool enabled);
+size_t elog_deferred_drain(size_t max_num);
+size_t elog_deferred_get_drop_num(void);
+
+/* elog_bin.c */
+size_t elog_bin_output_record(const ElogRecord *record);
+void elog_bin_output_kv(const ElogSite *site, const ElogKvField *fields, size_t num);
+
+/* elog_site.c */
+ElogErrCode elog_site_init(void);
+size_t elog_site_set_enabled(const char *tag, const char *file, uint32_t line_min, uint32_t line_max,
+        uint8_t level, bool enabled);
+size_t elog_site_get_num(void);
+uint16_t elog_site_get_id(const ElogSite *site);
+const ElogSite *elog_site_get(uint16_t id);
+bool elog_site_filter(const ElogSite *site, const char *tag);
+bool elog_ratelimit_pass(ElogRateLimit *limit, const ElogSite *site, const char *tag);
+void elog_ratelimit_poll(void);
+bool elog_sample_pass(ElogRateLimit *limit, uint16_t n);
+
+/* elog_dedup.c */
+bool elog_dedup_check(ElogRecord *record, const char *format, const char *payload, size_t size);
+void elog_dedup_flush(void);
+void elog_dedup_poll(void);
+
+/* elog_kv.c */
+void elog_kv_output(const ElogSite *site, const char *tag, const ElogKvField *fields, size_t num);
+size_t elog_kv_encode(uint8_t *buf, size_t size, const ElogKvField *fields, size_t num);
+
+/* elog_sink.c */
+bool elog_sink_register(ElogSink *sink);
+void elog_sink_unregister(ElogSink *sink);
+ElogSink *elog_sink_find(const char *name);
+uint8_t elog_sink_get_mask(const ElogSink *sink);
+uint8_t elog_sink_match(uint8_t level, const char *tag, bool *text);
+void elog_sink_output(const ElogRecord *record, uint8_t mask);
+size_t elog_sink_drain(size_t max_size);
+
+/* elog_crash.c */
+ElogErrCode elog_crash_init(void);
+size_t elog_crash_write(const char *log, size_t size);
+void elog_crash_set_fault(uint8_t type, const uint32_t *frame, uint32_t sp, uint32_t info);
+
+/* elog_trig.c */
+ElogErrCode elog_trig_init(void);
+void elog_trig_fire(void);
+size_t elog_trig_drain(size_t max_num);
+
+/* elog_stat.c */
+uint32_t elog_seq_next(void);
+uint32_t elog_seq_take(void);
+uint32_t elog_get_seq(void);
+void elog_stat_drop(uint8_t stage, uint8_t level, size_t size);
+void elog_stat_trunc(uint8_t stage, uint8_t level, size_t size);
+void elog_stat_put(uint8_t stage, uint8_t level, size_t size, size_t put_size);
+void elog_get_stat(uint8_t stage, ElogStat *stat);
+void elog_stat_reset(void);
+void elog_stat_summary(void);
+void elog_stat_poll(void);
 
 /* elog_utils.c */
 size_t elog_strcpy(size_t cur_len, char *dst, const char *src);
 size_t elog_cpyln(char *line, const char *log, size_t len);
 void *elog_memcpy(void *dst, const void *src, size_t count);
+size_t elog_span_write(const ElogSpan *span, size_t offset, const void *data, size_t size);
+
+/* elog_fmt.c */
+int elog_vsnprintf(char *buf, size_t size, const char *format, va_list args);
+int elog_snprintf(char *buf, size_t size, const char *format, ...);
+size_t elog_u32toa(char *buf, uint32_t value);
+size_t elog_u64toa(char *buf, uint64_t value);
+bool elog_args_capture(ElogArgs *captured, const char *format, va_list *args);
+int elog_args_format(char *buf, size_t size, const char *format, const ElogArgs *captured);
 
 #ifdef __cplusplus
 }
@@ -43,10 +43,22 @@
 #define ELOG_FILTER_TAG_MAX_LEN                  30
 /* output filter's keyword max length */
 #define ELOG_FILTER_KW_MAX_LEN                   16
-/* output filter's tag level max num */
-#define ELOG_FILTER_TAG_LVL_MAX_NUM              5
+/* output filter's keyword max number, the total length of all keywords must be less than 33 */
+#define ELOG_FILTER_KW_MAX_NUM                   4
+/* max interned tag num, every tag can have it's own filter level */
+#define ELOG_TAG_MAX_NUM                         16
+/* name pool size for the interned tags */
+#define ELOG_TAG_POOL_SIZE                       128
+/* rate limited log's max burst number and the period(ms) to refill one token */
+#define ELOG_RATELIMIT_BURST                     10
+#define ELOG_RATELIMIT_PERIOD                    100
+/* timestamp number per millisecond, it depends on the unit of elog_port_get_timestamp() */
+#define ELOG_TIMESTAMP_PER_MS                    1000
 /* output newline sign */
 #define ELOG_NEWLINE_SIGN                        "\r\n"
+/* max nested context(main loop and ISRs) number which can package log at the same time,
+ * every context has it's own line buffer */
+#define ELOG_CTX_MAX_NUM                         3
 /*---------------------------------------------------------------------------*/
 /* enable log color */
 #define ELOG_COLOR_ENABLE
@@ -68,16 +80,144 @@
 // #define ELOG_ASYNC_OUTPUT_ENABLE
 /* the highest output level for async mode, other level will sync output */
 #define ELOG_ASYNC_OUTPUT_LVL                    ELOG_LVL_ASSERT
-/* buffer size for asynchronous output mode */
-#define ELOG_ASYNC_OUTPUT_BUF_SIZE               (ELOG_LINE_BUF_SIZE * 10)
-/* each asynchronous output's log which must end with newline sign */
-#define ELOG_ASYNC_LINE_OUTPUT
-/* asynchronous output mode using POSIX pthread implementation */
-#define ELOG_ASYNC_OUTPUT_USING_PTHREAD
+/* buffer size for asynchronous output mode, it must be power of 2, every log is queued as a whole record */
+#define ELOG_ASYNC_OUTPUT_BUF_SIZE               (ELOG_LINE_BUF_SIZE * 8)
+/* overflow policy when the buffer is full:
+ * ELOG_OVERFLOW_DROP_NEWEST: drop the new log
+ * ELOG_OVERFLOW_DROP_OLDEST: evict the oldest logs
+ * ELOG_OVERFLOW_BLOCK: bare-metal outputs the oldest logs in the log call, pthread waits the output thread
+ * ELOG_OVERFLOW_PRIORITY: evict the queued verbose and debug logs first, then the oldest less important logs */
+#define ELOG_ASYNC_OVERFLOW_POLICY               ELOG_OVERFLOW_DROP_NEWEST
+/* max queued records which are checked in once log call by the eviction, or marked in once urgent output,
+ * it bounds the interrupt disabled time */
+#define ELOG_ASYNC_SCAN_MAX_NUM                  8
+/* max wait time(ms) of the log call for ELOG_OVERFLOW_BLOCK policy with pthread */
+#define ELOG_ASYNC_BLOCK_TIMEOUT                 10
+/* the queued log which level is greater than or equal to it is evicted first by ELOG_OVERFLOW_PRIORITY policy */
+#define ELOG_ASYNC_EVICT_LVL                     ELOG_LVL_DEBUG
+/* the log which level is less than or equal to it is output first when there is a backlog */
+#define ELOG_ASYNC_URGENT_LVL                    ELOG_LVL_WARN
+/* backlog watermark, percent of the buffer size, 0: the log is always output in order */
+#define ELOG_ASYNC_BACKLOG_WATERMARK             50
+/* asynchronous output mode using POSIX pthread implementation, the bare-metal drain is used when it is disabled */
+// #define ELOG_ASYNC_OUTPUT_USING_PTHREAD
+/* max log size which is output in once bare-metal drain */
+#define ELOG_ASYNC_DRAIN_MAX_SIZE                512
+/* max time(us) of once bare-metal drain, at least one log is output, 0: it is only limited by the size */
+#define ELOG_ASYNC_DRAIN_MAX_TIME                0
+/* the bare-metal drain runs in the software interrupt which is pended by port when the log is put,
+ * otherwise it only runs in elog_idle() */
+// #define ELOG_ASYNC_DRAIN_USING_SWI
 /*---------------------------------------------------------------------------*/
 /* enable buffered output mode */
 // #define ELOG_BUF_OUTPUT_ENABLE
 /* buffer size for buffered output mode */
 #define ELOG_BUF_OUTPUT_BUF_SIZE                 (ELOG_LINE_BUF_SIZE * 10)
+/* the buffered logs are flushed in elog_idle() when the oldest one is older than it(ms), 0: disabled */
+#define ELOG_BUF_FLUSH_AGE                       100
+/* the buffered logs are flushed in elog_idle() when the used size reaches it(percent of buffer size), 0: disabled */
+#define ELOG_BUF_FLUSH_WATERMARK                 75
+/* the log which level is less than or equal to it flushes the buffered logs immediately */
+#define ELOG_BUF_FLUSH_LVL                       ELOG_LVL_ERROR
+/*---------------------------------------------------------------------------*/
+/* enable output router: the log is formatted once, then output to every registered sink which accepts it
+ * with it's record, the log is not formatted when only the record sinks accept it,
+ * the enabled output mode above is the default sink named "port" */
+// #define ELOG_SINK_ENABLE
+/* max registered sink number, it must be 1-8 */
+#define ELOG_SINK_MAX_NUM                        4
+/* record buffer size for the asynchronous sinks, it must be power of 2 */
+#define ELOG_SINK_ASYNC_BUF_SIZE                 1024
+/* max log size which is output to the asynchronous sinks in once elog_idle() */
+#define ELOG_SINK_DRAIN_MAX_SIZE                 512
+/* enable UART sink in port, the log is copied to the interrupt driven UART driver, it never waits for UART */
+// #define ELOG_UART_SINK_ENABLE
+/* the log which level is greater than it is not output to UART sink */
+#define ELOG_UART_SINK_LVL                       ELOG_LVL_INFO
+/* UART sink baud rate, the driver buffer is sized for it, @see BSP_UART_TX_BUF_SIZE */
+#define ELOG_UART_SINK_BAUD_RATE                 921600
+/*---------------------------------------------------------------------------*/
+/* enable crash recorder: the last logs and the fault context are kept in the retained RAM which is not
+ * initialized at reset, elog_crash_init() outputs them in the next boot. The logs are kept by the sink
+ * named "crash", so ELOG_SINK_ENABLE is needed for them */
+// #define ELOG_CRASH_ENABLE
+/* the section of the retained RAM, it must be placed in the UNINIT region by the scatter file */
+#define ELOG_CRASH_SECTION                       ".bss.noinit"
+/* retained log buffer size, it must be multiple of 4 and less than 32K */
+#define ELOG_CRASH_BUF_SIZE                      960
+/* the longer log is truncated when it is kept */
+#define ELOG_CRASH_LOG_MAX_SIZE                  128
+/* the log which level is greater than it is not kept */
+#define ELOG_CRASH_LVL                           ELOG_LVL_DEBUG
+/* reset MCU after the fault or assert is recorded, otherwise it waits for the watchdog or debugger */
+#define ELOG_CRASH_RESET_ENABLE
+/* max time(ms) to output the asynchronous logs when the assert failed, the assert is recorded and
+ * the buffered logs are output before stop, instead of spinning in ELOG_ASSERT */
+#define ELOG_CRASH_FLUSH_TIMEOUT                 100
+/*---------------------------------------------------------------------------*/
+/* enable pre-trigger logs: the low level logs are kept in RAM ring by the sink named "trig" and they
+ * are not output, the trigger log or elog_trig_fire() outputs them to all other sinks as the context.
+ * ELOG_SINK_ENABLE is needed, the level of other sinks such as "port" can be set to ELOG_TRIG_LVL,
+ * so only the trigger logs take the bandwidth normally */
+// #define ELOG_TRIG_ENABLE
+/* pre-trigger ring buffer size, it must be power of 2 */
+#define ELOG_TRIG_BUF_SIZE                       2048
+/* the log which level is greater than it is not kept */
+#define ELOG_TRIG_KEEP_LVL                       ELOG_LVL_VERBOSE
+/* the log which level is less than or equal to it fires the output of the kept logs */
+#define ELOG_TRIG_LVL                            ELOG_LVL_ERROR
+/* max kept message size of the log which arguments are not captured */
+#define ELOG_TRIG_TEXT_MAX_SIZE                  64
+/* max pre-trigger log number to output in once elog_idle() */
+#define ELOG_TRIG_DRAIN_MAX_NUM                  8
+/*---------------------------------------------------------------------------*/
+/* max 32-bit argument words which can be captured from one log call */
+#define ELOG_ARGS_MAX_NUM                        8
+/* buffer size for the captured string(%s) arguments of one log call, the longer log is formatted directly */
+#define ELOG_ARGS_STR_BUF_SIZE                   32
+/* buffer size for the rendered text of one key-value log call, binary output mode uses it's frame buffer */
+#define ELOG_KV_BUF_SIZE                         64
+/*---------------------------------------------------------------------------*/
+/* enable built-in formatter instead of C library vsnprintf, it has no division */
+#define ELOG_BUILTIN_FMT_ENABLE
+/* enable 64-bit integer(%lld) for built-in formatter */
+#define ELOG_BUILTIN_FMT_LLONG_ENABLE
+/* enable fixed-point float(%f) for built-in formatter, it will output as it is when disabled */
+// #define ELOG_BUILTIN_FMT_FLOAT_ENABLE
+/* max float precision for built-in formatter, it must be less than 10 */
+#define ELOG_BUILTIN_FMT_FLOAT_MAX_PREC          6
+/*---------------------------------------------------------------------------*/
+/* enable deferred output mode: capture the raw arguments, format them later */
+// #define ELOG_DEFERRED_OUTPUT_ENABLE
+/* the highest output level for deferred mode, other level will sync output */
+#define ELOG_DEFERRED_OUTPUT_LVL                 ELOG_LVL_ERROR
+/* record number of the deferred output ring, it must be power of 2 */
+#define ELOG_DEFERRED_RECORD_NUM                 16
+/* max record number which will be formatted in once elog_idle() */
+#define ELOG_DEFERRED_DRAIN_MAX_NUM              4
+/*---------------------------------------------------------------------------*/
+/* enable binary output mode, only the call site ID and raw arguments are output,
+ * use tools/elog_decode.py with the ELF file to rebuild the log text. The site logs are routed
+ * to the sinks with the captured arguments, so the record sinks such as the pre-trigger and
+ * crash recorder get them too. The duplicate filter only checks the packaged logs, and the
+ * key-value logs are output to the port directly */
+// #define ELOG_BIN_OUTPUT_ENABLE
+/* frame buffer size for binary output mode, the key-value frame and the text which is formatted
+ * from the captured arguments will be truncated by it */
+#define ELOG_BIN_FRAME_BUF_SIZE                  128
+/*---------------------------------------------------------------------------*/
+/* enable raw hex dump: elog_hexdump_raw() outputs the data unmodified to the port's raw channel,
+ * use tools/elog_rawdump.py to render it */
+// #define ELOG_HEXDUMP_RAW_ENABLE
+/* max data size of every raw hex dump chunk, it must be less than the raw channel buffer */
+#define ELOG_HEXDUMP_RAW_CHUNK_SIZE              256
+/*---------------------------------------------------------------------------*/
+/* enable duplicate suppression: the consecutive same logs are output as one repeated summary */
+// #define ELOG_DEDUP_ENABLE
+/* the timeout(ms) to output the repeated summary when the same log is still repeating */
+#define ELOG_DEDUP_TIMEOUT                       1000
+/*---------------------------------------------------------------------------*/
+/* the period(ms) to output the drop and truncation summary when it is changed, 0: disabled */
+#define ELOG_STAT_SUMMARY_PERIOD                 10000
 
 #endif /* _ELOG_CFG_H_ */
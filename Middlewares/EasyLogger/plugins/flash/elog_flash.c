@@ -202,7 +202,10 @@ void elog_flash_write(const char *log, size_t size) {
     /* write last word alignment data */
     if ((result == EF_NO_ERR) && (write_size_temp != size)) {
         elog_memcpy(write_overage_c, log + write_size_temp, size - write_size_temp);
-        ef_log_write((uint32_t *) write_overage_c, 4);
+        result = ef_log_write((uint32_t *) write_overage_c, 4);
+    }
+    if (result != EF_NO_ERR) {
+        elog_stat_drop(ELOG_STAGE_FLASH, ELOG_STAT_LVL_NONE, size);
     }
 #endif
 
@@ -228,7 +231,9 @@ void elog_flash_flush(void) {
     /* fill '\r' for word alignment */
     memset(log_buf + cur_buf_size, '\r', write_overage_size);
     /* write all buffered log to flash */
-    ef_log_write((uint32_t *) log_buf, cur_buf_size + write_overage_size);
+    if (ef_log_write((uint32_t *) log_buf, cur_buf_size + write_overage_size) != EF_NO_ERR) {
+        elog_stat_drop(ELOG_STAGE_FLASH, ELOG_STAT_LVL_NONE, cur_buf_size);
+    }
     /* reset position */
     cur_buf_size = 0;
     /* unlock flash log buffer */
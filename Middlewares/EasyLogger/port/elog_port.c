@@ -27,10 +27,57 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "elog.h"
 #include "SEGGER_RTT.h"
 #include "bsp_delay.h"
+#include "bsp_uart.h"
+#include "ti_msp_dl_config.h"
+
+/* output lock nested number */
+static volatile uint32_t lock_nest = 0;
+/* PRIMASK before the first output lock */
+static uint32_t lock_primask = 0;
+/* TIMER_Delay count when the first output lock, it counts down */
+static uint32_t lock_start_count = 0;
+/* max interrupt disabled time by output lock, unit: TIMER_Delay clock */
+static uint32_t lock_max_count = 0;
+/* RTT buffer reservation, there is only one reservation in output locked */
+static SEGGER_RTT_RESERVATION rtt_resv;
+
+#ifdef ELOG_HEXDUMP_RAW_ENABLE
+/* RTT up-buffer for raw hex dump, it must be bigger than ELOG_HEXDUMP_RAW_CHUNK_SIZE */
+#define RAW_RTT_CHANNEL     1
+#define RAW_RTT_BUF_SIZE    1024
+static char raw_rtt_buf[RAW_RTT_BUF_SIZE];
+#endif
+
+#if defined(ELOG_SINK_ENABLE) && defined(ELOG_UART_SINK_ENABLE)
+static size_t uart_sink_output(const ElogRecord *record);
+/* UART sink, the log is only copied in the log call, UART_0 ISR sends it */
+static ElogSink uart_sink = {"uart", uart_sink_output, ELOG_UART_SINK_LVL, ELOG_SINK_SYNC, NULL, 0};
+#endif
+
+#ifdef ELOG_CRASH_ENABLE
+/* SRAM range of the stacks, the stacked registers out of it are not read */
+#define CRASH_SRAM_BASE     0x20200000UL
+#define CRASH_SRAM_LIMIT    0x20208000UL
+static void crash_assert_hook(const char *expr, const char *func, size_t line);
+#ifdef ELOG_SINK_ENABLE
+static size_t crash_sink_output(const ElogRecord *record);
+/* crash sink, the last logs are kept in the retained RAM */
+static ElogSink crash_sink = {"crash", crash_sink_output, ELOG_CRASH_LVL, ELOG_SINK_SYNC, NULL, 0};
+#endif
+#endif /* ELOG_CRASH_ENABLE */
+
+#if defined(ELOG_ASYNC_OUTPUT_ENABLE) && defined(ELOG_ASYNC_DRAIN_USING_SWI)
+/* the unused SPI1 interrupt is pended as the software interrupt of asynchronous drain */
+#define ASYNC_SWI_IRQN          SPI1_INT_IRQn
+#define ASYNC_SWI_IRQHandler    SPI1_IRQHandler
+/* the lowest priority, the drain is preempted by all other interrupts */
+#define ASYNC_SWI_PRIORITY      3
+#endif
 
 
 /**
@@ -44,6 +91,28 @@ ElogErrCode elog_port_init(void)
 
     /* add your code here */
     SEGGER_RTT_Init();
+#ifdef ELOG_CRASH_ENABLE
+    /* the crash record of last boot is output before any log of this boot */
+    elog_crash_init();
+    elog_assert_set_hook(crash_assert_hook);
+#ifdef ELOG_SINK_ENABLE
+    elog_sink_register(&crash_sink);
+#endif
+#endif
+#ifdef ELOG_HEXDUMP_RAW_ENABLE
+    /* the raw chunk which has no space is skipped, the host finds it by the chunk offset */
+    SEGGER_RTT_ConfigUpBuffer(RAW_RTT_CHANNEL, "ElogRaw", raw_rtt_buf, sizeof(raw_rtt_buf),
+                              SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+#endif
+#if defined(ELOG_SINK_ENABLE) && defined(ELOG_UART_SINK_ENABLE)
+    bsp_uart_init(ELOG_UART_SINK_BAUD_RATE);
+    elog_sink_register(&uart_sink);
+#endif
+#if defined(ELOG_ASYNC_OUTPUT_ENABLE) && defined(ELOG_ASYNC_DRAIN_USING_SWI)
+    NVIC_SetPriority(ASYNC_SWI_IRQN, ASYNC_SWI_PRIORITY);
+    NVIC_ClearPendingIRQ(ASYNC_SWI_IRQN);
+    NVIC_EnableIRQ(ASYNC_SWI_IRQN);
+#endif
 
     return result;
 }
@@ -63,22 +132,262 @@ void elog_port_deinit(void)
  *
  * @param log output of log
  * @param size log size
+ *
+ * @return output size, the log is dropped when it is 0 and truncated when it is less than size
  */
-void elog_port_output(const char *log, size_t size)
+size_t elog_port_output(const char *log, size_t size)
 {
 
     /* add your code here */
-    SEGGER_RTT_Write(0, log, size);
+    return SEGGER_RTT_Write(0, log, size);
     // printf("%.*s", size, log);
 }
 
+#if defined(ELOG_SINK_ENABLE) && defined(ELOG_UART_SINK_ENABLE)
+/**
+ * output the log to UART sink, it only copies the log to the UART driver buffer
+ *
+ * @param record log record
+ *
+ * @return output size, 0: the UART driver buffer is full, the log is dropped
+ */
+static size_t uart_sink_output(const ElogRecord *record)
+{
+    return bsp_uart_write(record->log, record->size);
+}
+#endif
+
+#ifdef ELOG_CRASH_ENABLE
+#ifdef ELOG_SINK_ENABLE
+/**
+ * keep the log in the retained RAM of crash recorder
+ *
+ * @param record log record
+ *
+ * @return kept size
+ */
+static size_t crash_sink_output(const ElogRecord *record)
+{
+    return elog_crash_write(record->log, record->size);
+}
+#endif
+
+/**
+ * stop after the crash is recorded, the crash record is output in the next boot
+ */
+static void crash_stop(void)
+{
+#ifdef ELOG_CRASH_RESET_ENABLE
+    NVIC_SystemReset();
+#endif
+    while (1)
+    {
+    }
+}
+
+/**
+ * record the fault context by HardFault and NMI handler, it never returns
+ * @note it takes no lock and outputs nothing, the fault may be in the log output
+ *
+ * @param frame stacked registers, r0, r1, r2, r3, r12, lr, pc, xpsr
+ * @param exc_return EXC_RETURN of the exception
+ * @param type ELOG_CRASH_HARDFAULT or ELOG_CRASH_NMI
+ */
+__attribute__((used)) void elog_port_crash_fault(const uint32_t *frame, uint32_t exc_return, uint32_t type)
+{
+    uint32_t addr = (uint32_t)frame;
+    uint32_t sp   = addr + 8 * sizeof(uint32_t);
+
+    if (addr % sizeof(uint32_t) == 0 && addr >= CRASH_SRAM_BASE && sp <= CRASH_SRAM_LIMIT)
+    {
+        /* the stack is aligned to 8 bytes by exception when xPSR bit 9 is set */
+        if (frame[7] & (1UL << 9))
+        {
+            sp += sizeof(uint32_t);
+        }
+        elog_crash_set_fault((uint8_t)type, frame, sp, exc_return);
+    }
+    else
+    {
+        elog_crash_set_fault((uint8_t)type, NULL, addr, exc_return);
+    }
+    crash_stop();
+}
+
+/**
+ * HardFault handler, it passes the stack of the fault to elog_port_crash_fault
+ */
+__attribute__((naked)) void HardFault_Handler(void)
+{
+    __asm volatile(
+        "movs   r0, #4                  \n"
+        "mov    r1, lr                  \n"
+        "tst    r0, r1                  \n"
+        "bne    1f                      \n"
+        "mrs    r0, msp                 \n"
+        "b      2f                      \n"
+        "1:                             \n"
+        "mrs    r0, psp                 \n"
+        "2:                             \n"
+        "movs   r2, #1                  \n" /* ELOG_CRASH_HARDFAULT */
+        "bl     elog_port_crash_fault   \n");
+}
+
+/**
+ * NMI handler, it passes the stack of the interrupted code to elog_port_crash_fault
+ */
+__attribute__((naked)) void NMI_Handler(void)
+{
+    __asm volatile(
+        "movs   r0, #4                  \n"
+        "mov    r1, lr                  \n"
+        "tst    r0, r1                  \n"
+        "bne    1f                      \n"
+        "mrs    r0, msp                 \n"
+        "b      2f                      \n"
+        "1:                             \n"
+        "mrs    r0, psp                 \n"
+        "2:                             \n"
+        "movs   r2, #2                  \n" /* ELOG_CRASH_NMI */
+        "bl     elog_port_crash_fault   \n");
+}
+
+/**
+ * assert hook, the assert is logged and recorded, then the buffered logs are output before stop
+ *
+ * @param expr assert expression
+ * @param func function name
+ * @param line line number
+ */
+static void crash_assert_hook(const char *expr, const char *func, size_t line)
+{
+    static bool asserting = false;
+    uint32_t    frame[8]  = {0};
+
+    /* the pc of stacked registers is the caller of the assert */
+    frame[6] = (uint32_t)__builtin_return_address(0);
+    elog_crash_set_fault(ELOG_CRASH_ASSERT, frame, __get_MSP(), (uint32_t)line);
+    /* the assert in the log output stops directly */
+    if (asserting)
+    {
+        crash_stop();
+    }
+    asserting = true;
+    elog_a("elog", "(%s) has assert failed at %s:%ld.", expr, func, (long)line);
+#ifdef ELOG_TRIG_ENABLE
+    /* the assert log fires the pre-trigger logs, they are output before the flush */
+    elog_trig_drain(SIZE_MAX);
+#endif
+#if defined(ELOG_ASYNC_OUTPUT_ENABLE) && !defined(ELOG_ASYNC_OUTPUT_USING_PTHREAD)
+    elog_async_flush(ELOG_CRASH_FLUSH_TIMEOUT);
+#endif
+#ifdef ELOG_BUF_OUTPUT_ENABLE
+    elog_flush();
+#endif
+    crash_stop();
+}
+#endif /* ELOG_CRASH_ENABLE */
+
+#if defined(ELOG_ASYNC_OUTPUT_ENABLE) && defined(ELOG_ASYNC_DRAIN_USING_SWI)
+/**
+ * notice the asynchronous drain when the log is put, it only pends the software interrupt
+ */
+void elog_port_async_notice(void)
+{
+    NVIC_SetPendingIRQ(ASYNC_SWI_IRQN);
+}
+
+/**
+ * asynchronous drain software interrupt, the rest logs over the drain budget are output
+ * by the next notice or elog_idle()
+ */
+void ASYNC_SWI_IRQHandler(void)
+{
+    elog_async_drain(ELOG_ASYNC_DRAIN_MAX_SIZE);
+}
+#endif
+
+/**
+ * reserve output space in RTT buffer, the log can be packaged in it directly
+ * @note it is called in output locked, and it must be committed before unlock
+ *
+ * @param size reserve size
+ * @param span reserved space, it is split into two parts when wrapping
+ *
+ * @return true: reserved, false: there is no space, the log will be dropped
+ */
+bool elog_port_output_reserve(size_t size, ElogSpan *span)
+{
+    if (SEGGER_RTT_ReserveNoLock(0, size, &rtt_resv) == 0)
+    {
+        return false;
+    }
+    span->buf[0]  = rtt_resv.pData0;
+    span->size[0] = rtt_resv.NumBytes0;
+    span->buf[1]  = rtt_resv.pData1;
+    span->size[1] = rtt_resv.NumBytes1;
+
+    return true;
+}
+
+/**
+ * commit the output space which is reserved by elog_port_output_reserve
+ *
+ * @param size written size, the rest of reserved space is released
+ */
+void elog_port_output_commit(size_t size)
+{
+    SEGGER_RTT_CommitNoLock(&rtt_resv, size);
+}
+
+#ifdef ELOG_HEXDUMP_RAW_ENABLE
+/**
+ * output the raw hex dump chunk to the raw RTT channel, the head and data are output together
+ * @note it is called in output locked
+ *
+ * @param head chunk head
+ * @param head_size chunk head size
+ * @param data chunk data
+ * @param size chunk data size
+ *
+ * @return true: output, false: there is no space, the chunk is dropped
+ */
+bool elog_port_raw_output(const void *head, size_t head_size, const void *data, size_t size)
+{
+    SEGGER_RTT_RESERVATION resv;
+    ElogSpan               span;
+    size_t                 len;
+
+    if (SEGGER_RTT_ReserveNoLock(RAW_RTT_CHANNEL, head_size + size, &resv) == 0)
+    {
+        return false;
+    }
+    span.buf[0]  = resv.pData0;
+    span.size[0] = resv.NumBytes0;
+    span.buf[1]  = resv.pData1;
+    span.size[1] = resv.NumBytes1;
+    len          = elog_span_write(&span, 0, head, head_size);
+    len          = elog_span_write(&span, len, data, size);
+    SEGGER_RTT_CommitNoLock(&resv, len);
+
+    return true;
+}
+#endif /* ELOG_HEXDUMP_RAW_ENABLE */
+
 /**
- * output lock
+ * output lock, it is safe for ISR by disabling interrupt
+ * @note the lock only covers claiming buffer and copying log to RTT buffer
  */
 void elog_port_output_lock(void)
 {
+    uint32_t primask = __get_PRIMASK();
 
-    /* add your code here */
+    __disable_irq();
+    if (lock_nest++ == 0)
+    {
+        lock_primask     = primask;
+        lock_start_count = DL_Timer_getTimerCount(TIMER_Delay_INST);
+    }
 }
 
 /**
@@ -86,23 +395,92 @@ void elog_port_output_lock(void)
  */
 void elog_port_output_unlock(void)
 {
+    uint32_t count, elapsed;
 
-    /* add your code here */
+    if (--lock_nest == 0)
+    {
+        count = DL_Timer_getTimerCount(TIMER_Delay_INST);
+        /* the timer is reloaded when the count is bigger than start count */
+        if (count <= lock_start_count)
+        {
+            elapsed = lock_start_count - count;
+        }
+        else
+        {
+            elapsed = lock_start_count + TIMER_Delay_INST_LOAD_VALUE + 1 - count;
+        }
+        if (elapsed > lock_max_count)
+        {
+            lock_max_count = elapsed;
+        }
+        __set_PRIMASK(lock_primask);
+    }
 }
 
 /**
- * get current time interface
+ * get max interrupt disabled time by output lock
  *
- * @return current time
+ * @return max time, unit: TIMER_Delay clock (25ns at 40MHz)
  */
-const char *elog_port_get_time(void)
+uint32_t elog_port_get_lock_max_time(void)
 {
-    static char cur_system_time[16] = {0};
-    uint32_t tick = BSP_GetTick();
-    
-    snprintf(cur_system_time, sizeof(cur_system_time), "%u", tick);
-    
-    return cur_system_time;
+    return lock_max_count;
+}
+
+/* rendered timestamp: right aligned seconds, then 6 digits microseconds */
+#define TIME_SEC_MIN_LEN    5
+#define TIME_FRAC_LEN       6
+
+/**
+ * get current timestamp interface, it is captured when logging and rendered when output
+ *
+ * @return current timestamp, unit: microsecond
+ */
+uint64_t elog_port_get_timestamp(void)
+{
+    return BSP_GetTimeUs64();
+}
+
+/**
+ * render the timestamp to time string interface, it is reentrant
+ *
+ * @param buf output buffer, it's size is ELOG_TIME_STR_MAX_LEN at least
+ * @param timestamp timestamp from elog_port_get_timestamp
+ *
+ * @return string length, such as "    1.234567"
+ */
+size_t elog_port_timestamp_render(char *buf, uint64_t timestamp)
+{
+    char   digits[ELOG_U64_STR_MAX_LEN + 1];
+    size_t digits_len, sec_len, frac_len, len = 0;
+
+    digits_len = elog_u64toa(digits, timestamp);
+    sec_len    = (digits_len > TIME_FRAC_LEN) ? digits_len - TIME_FRAC_LEN : 0;
+    /* right align the seconds, the zero second is output as "0" */
+    while (len + (sec_len ? sec_len : 1) < TIME_SEC_MIN_LEN)
+    {
+        buf[len++] = ' ';
+    }
+    if (sec_len)
+    {
+        memcpy(buf + len, digits, sec_len);
+        len += sec_len;
+    }
+    else
+    {
+        buf[len++] = '0';
+    }
+    buf[len++] = '.';
+    /* the leading zeros of microseconds */
+    for (frac_len = digits_len - sec_len; frac_len < TIME_FRAC_LEN; frac_len++)
+    {
+        buf[len++] = '0';
+    }
+    memcpy(buf + len, digits + sec_len, digits_len - sec_len);
+    len += digits_len - sec_len;
+    buf[len] = '\0';
+
+    return len;
 }
 
 /**
@@ -53,13 +53,48 @@
     #error "Please configure output filter's keyword max length (in elog_cfg.h)"
 #endif
 
+/* output filter's keyword max number */
+#ifndef ELOG_FILTER_KW_MAX_NUM
+#define ELOG_FILTER_KW_MAX_NUM               1
+#endif
+
+#if ELOG_FILTER_KW_MAX_LEN > 32
+    #error "Output filter's keyword max length must be less than 33 (in elog_cfg.h)"
+#endif
+
 #if !defined(ELOG_NEWLINE_SIGN)
     #error "Please configure output newline sign (in elog_cfg.h)"
 #endif
 
-/* output filter's tag level max num */
-#ifndef ELOG_FILTER_TAG_LVL_MAX_NUM
-#define ELOG_FILTER_TAG_LVL_MAX_NUM          4
+/* interned tag max num and tag name pool size */
+#ifndef ELOG_TAG_MAX_NUM
+#define ELOG_TAG_MAX_NUM                     16
+#endif
+#ifndef ELOG_TAG_POOL_SIZE
+#define ELOG_TAG_POOL_SIZE                   128
+#endif
+
+/* raw hex dump frame type and chunk size */
+#define RAW_FRAME                            0xE9
+#ifdef ELOG_HEXDUMP_RAW_CHUNK_SIZE
+#define RAW_CHUNK_SIZE                       ELOG_HEXDUMP_RAW_CHUNK_SIZE
+#else
+#define RAW_CHUNK_SIZE                       256
+#endif
+
+#if RAW_CHUNK_SIZE > UINT16_MAX || RAW_CHUNK_SIZE < 1
+    #error "Raw hex dump chunk size is out of range (in elog_cfg.h)"
+#endif
+
+#if ELOG_TAG_MAX_NUM > 255
+    #error "Interned tag max num must be less than 256 (in elog_cfg.h)"
+#endif
+
+/* the site log in binary output mode is framed by it's captured arguments, it is not formatted */
+#ifdef ELOG_BIN_OUTPUT_ENABLE
+#define SITE_IS_FRAMED(site)                 ((site) != NULL)
+#else
+#define SITE_IS_FRAMED(site)                 false
 #endif
 
 #ifdef ELOG_COLOR_ENABLE
@@ -115,10 +150,80 @@
 #endif
 #endif /* ELOG_COLOR_ENABLE */
 
+/* output layout max step number and constant text length of every level */
+#define LAYOUT_STEP_MAX_NUM            24
+#define LAYOUT_TEXT_MAX_LEN            32
+
+/* output layout step, the constant text step is followed by it's text length */
+typedef enum {
+    LAYOUT_STEP_END,
+    LAYOUT_STEP_TEXT,
+    LAYOUT_STEP_TAG,
+    LAYOUT_STEP_SEQ,
+    LAYOUT_STEP_TIME,
+    LAYOUT_STEP_P_INFO,
+    LAYOUT_STEP_T_INFO,
+    LAYOUT_STEP_LOCATION,
+} LayoutStep;
+
+/* keyword matching result of the log format */
+typedef enum {
+    KW_MISMATCHED,
+    KW_MATCHED,
+    KW_UNKNOWN,
+} KwResult;
+
+/* the log head layout which is compiled from the format set and color setting */
+typedef struct {
+    uint8_t step[LAYOUT_STEP_MAX_NUM];
+    /* all constant texts of text steps in order */
+    char text[LAYOUT_TEXT_MAX_LEN];
+} OutputLayout;
+
+/* output layout compiler */
+typedef struct {
+    OutputLayout *layout;
+    size_t step_num;
+    size_t text_len;
+    /* the length of the last step when it is a text step, otherwise it is NULL */
+    uint8_t *text_step;
+} LayoutCompiler;
+
+/* interned tag */
+typedef struct {
+    /* the tag name offset in tag name pool */
+    uint16_t name;
+    /* the tag's own filter level */
+    uint8_t level;
+    /* the log which level is less than it will be output, the level and tag filter are merged */
+    uint8_t output_lvl;
+} TagEntry;
+
 /* EasyLogger object */
 static EasyLogger elog;
-/* every line log's buffer */
-static char log_buf[ELOG_LINE_BUF_SIZE] = { 0 };
+/* every line log's buffer, every nested context (ISR) has it's own buffer */
+static char log_buf[ELOG_CTX_MAX_NUM][ELOG_LINE_BUF_SIZE] = { 0 };
+/* every line log's record, it is claimed with the line buffer */
+static ElogRecord record_buf[ELOG_CTX_MAX_NUM];
+#if defined(ELOG_SINK_ENABLE) || defined(ELOG_BIN_OUTPUT_ENABLE)
+/* the arguments which are captured for the record sinks and binary output mode */
+static ElogArgs args_buf[ELOG_CTX_MAX_NUM];
+#endif
+/* the nested context number which is outputting log */
+static volatile uint8_t ctx_depth = 0;
+/* dropped log number when all context buffers are used */
+static size_t ctx_drop_num = 0;
+/* interned tags, the tag ID is the index + 1 */
+static TagEntry tag_table[ELOG_TAG_MAX_NUM] = { 0 };
+/* interned tag number, the entry is filled before it is increased */
+static volatile size_t tag_num = 0;
+/* interned tag name pool */
+static char tag_pool[ELOG_TAG_POOL_SIZE] = { 0 };
+static size_t tag_pool_len = 0;
+/* every level's compiled output layout */
+static OutputLayout output_layout[ELOG_LVL_TOTAL_NUM] = { 0 };
+/* hex digits for hex dump */
+static const char hex_digits[] = "0123456789ABCDEF";
 /* level output info */
 static const char *level_output_info[] = {
         [ELOG_LVL_ASSERT]  = "A/",
@@ -141,17 +246,44 @@ static const char *color_output_info[] = {
 };
 #endif /* ELOG_COLOR_ENABLE */
 
-static bool get_fmt_enabled(uint8_t level, size_t set);
-static bool get_fmt_used_and_enabled_u32(uint8_t level, size_t set, uint32_t arg);
-static bool get_fmt_used_and_enabled_ptr(uint8_t level, size_t set, const char* arg);
 static void elog_set_filter_tag_lvl_default(void);
+static ElogTagId tag_find(const char *tag);
+static void tag_update(TagEntry *entry);
+static void tag_update_all(void);
+static uint8_t kw_match_format(const char *format);
+static bool kw_match_text(const char *log, size_t size);
+static void output_args(const ElogSite *site, ElogTagId tag_id, uint8_t level, const char *tag,
+        const char *file, const char *func, const long line, const char *format, va_list args);
+static void compile_layout(uint8_t level);
+static size_t layout_text_copy(size_t cur_len, char *dst, const char *text, size_t len);
+static size_t output_tag(size_t cur_len, char *dst, const char *tag);
+static size_t output_location(size_t cur_len, char *dst, size_t set, const char *file,
+        const char *func, const long line);
+static void output_record(const ElogRecord *record, uint8_t mask, const char *format, va_list args);
+static void output_log(int ctx, uint8_t mask, uint8_t kw_result, const char *format, va_list args);
+static size_t mode_output(const ElogRecord *record);
+static void do_output_wait(const ElogRecord *record);
+static void do_output(ElogRecord *record);
+static void record_take_seq(ElogRecord *record);
+static size_t output_seq(char *buf, size_t pos, size_t *log_len, size_t max_len, uint32_t seq);
+
+#ifdef ELOG_SINK_ENABLE
+/* the default sink, it outputs the log by the enabled output mode */
+#ifdef ELOG_BIN_OUTPUT_ENABLE
+/* the site log is framed by it's captured arguments, so the port sink doesn't need the packaged log */
+static ElogSink port_sink = { "port", mode_output, ELOG_LVL_VERBOSE, ELOG_SINK_RECORD, NULL, 0 };
+#else
+static ElogSink port_sink = { "port", mode_output, ELOG_LVL_VERBOSE, ELOG_SINK_SYNC, NULL, 0 };
+#endif
+#endif
 
 /* EasyLogger assert hook */
 void (*elog_assert_hook)(const char* expr, const char* func, size_t line);
 
-extern void elog_port_output(const char *log, size_t size);
+extern size_t elog_port_output(const char *log, size_t size);
 extern void elog_port_output_lock(void);
 extern void elog_port_output_unlock(void);
+extern uint64_t elog_port_get_timestamp(void);
 
 /**
  * EasyLogger initialize.
@@ -174,6 +306,11 @@ ElogErrCode elog_init(void) {
         return result;
     }
 
+    result = elog_site_init();
+    if (result != ELOG_NO_ERR) {
+        return result;
+    }
+
 #ifdef ELOG_ASYNC_OUTPUT_ENABLE
     result = elog_async_init();
     if (result != ELOG_NO_ERR) {
@@ -181,6 +318,18 @@ ElogErrCode elog_init(void) {
     }
 #endif
 
+#ifdef ELOG_SINK_ENABLE
+    /* the enabled output mode is the default sink */
+    elog_sink_register(&port_sink);
+#endif
+
+#ifdef ELOG_TRIG_ENABLE
+    result = elog_trig_init();
+    if (result != ELOG_NO_ERR) {
+        return result;
+    }
+#endif
+
     /* enable the output lock */
     elog_output_lock_enabled(true);
     /* output locked status initialize */
@@ -243,6 +392,10 @@ void elog_start(void) {
     elog_buf_enabled(true);
 #endif
 
+#ifdef ELOG_DEFERRED_OUTPUT_ENABLE
+    elog_deferred_enabled(true);
+#endif
+
     /* show version */
     log_i("EasyLogger V%s is initialize success.", ELOG_SW_VERSION);
 }
@@ -264,6 +417,10 @@ void elog_stop(void) {
     elog_buf_enabled(false);
 #endif
 
+#ifdef ELOG_DEFERRED_OUTPUT_ENABLE
+    elog_deferred_enabled(false);
+#endif
+
     /* show version */
     log_i("EasyLogger V%s is deinitialize success.", ELOG_SW_VERSION);
 }
@@ -287,9 +444,15 @@ void elog_set_output_enabled(bool enabled) {
  * @param enabled TRUE: enable FALSE:disable
  */
 void elog_set_text_color_enabled(bool enabled) {
+    uint8_t level;
+
     ELOG_ASSERT((enabled == false) || (enabled == true));
 
     elog.text_color_enabled = enabled;
+    /* the color is compiled into every level's layout */
+    for (level = 0; level < ELOG_LVL_TOTAL_NUM; level++) {
+        compile_layout(level);
+    }
 }
 
 /**
@@ -321,6 +484,7 @@ void elog_set_fmt(uint8_t level, size_t set) {
     ELOG_ASSERT(level <= ELOG_LVL_VERBOSE);
 
     elog.enabled_fmt_set[level] = set;
+    compile_layout(level);
 }
 
 /**
@@ -347,6 +511,7 @@ void elog_set_filter_lvl(uint8_t level) {
     ELOG_ASSERT(level <= ELOG_LVL_VERBOSE);
 
     elog.filter.level = level;
+    tag_update_all();
 }
 
 /**
@@ -356,15 +521,142 @@ void elog_set_filter_lvl(uint8_t level) {
  */
 void elog_set_filter_tag(const char *tag) {
     strncpy(elog.filter.tag, tag, ELOG_FILTER_TAG_MAX_LEN);
+    tag_update_all();
 }
 
 /**
- * set log filter's keyword
+ * set log filter's keyword, the other keywords are removed
  *
- * @param keyword keyword
+ * @param keyword keyword, all keywords are removed when it is empty
  */
 void elog_set_filter_kw(const char *keyword) {
-    strncpy(elog.filter.keyword, keyword, ELOG_FILTER_KW_MAX_LEN);
+    ElogKwMatcher *kw = &elog.filter.kw;
+
+    /* the filter is disabled before the masks are cleared */
+    kw->end = 0;
+    memset(kw->mask, 0, sizeof(kw->mask));
+    kw->start = 0;
+    kw->len = 0;
+    kw->num = 0;
+    if (keyword[0] != '\0') {
+        elog_add_filter_kw(keyword);
+    }
+}
+
+/**
+ * Add a keyword to log filter, the log which has any keyword will be output.
+ * The keywords are compiled into a shift-and matcher, so all of them are matched
+ * in one pass. The keyword is only matched in the log message, not in the log head.
+ *
+ * @param keyword ASCII keyword
+ *
+ * @return false: the keyword is empty, too long, not ASCII or the matcher is full
+ */
+bool elog_add_filter_kw(const char *keyword) {
+    ElogKwMatcher *kw = &elog.filter.kw;
+    size_t len = strlen(keyword), i;
+    uint8_t c;
+
+    if (len == 0 || len > ELOG_FILTER_KW_MAX_LEN || kw->num >= ELOG_FILTER_KW_MAX_NUM
+            || kw->len + len > 32) {
+        return false;
+    }
+    for (i = 0; i < len; i++) {
+        if ((uint8_t) keyword[i] >= ELOG_KW_CHAR_NUM) {
+            return false;
+        }
+    }
+    for (i = 0; i < len; i++) {
+        c = (uint8_t) keyword[i];
+        kw->mask[c] |= 1UL << (kw->len + i);
+    }
+    kw->start |= 1UL << kw->len;
+    kw->len += len;
+    kw->num++;
+    /* the new keyword is enabled at last */
+    kw->end |= 1UL << (kw->len - 1);
+
+    return true;
+}
+
+/**
+ * match the keywords by one char
+ *
+ * @param kw keyword matcher
+ * @param state matching state, bit n is set when the n-th char of keywords is matched
+ * @param c char
+ *
+ * @return new matching state
+ */
+static uint32_t kw_match_char(const ElogKwMatcher *kw, uint32_t state, char c) {
+    uint8_t index = (uint8_t) c;
+
+    if (index >= ELOG_KW_CHAR_NUM) {
+        return 0;
+    }
+
+    return ((state << 1) | kw->start) & kw->mask[index];
+}
+
+/**
+ * Match the keywords in the format before formatting. The arguments are unknown,
+ * so the keyword only can be matched in the constant text of the format.
+ *
+ * @param format log format
+ *
+ * @return KW_MATCHED: the keyword is found, KW_MISMATCHED: the keyword is not in the log,
+ *         KW_UNKNOWN: the formatted log should be matched again
+ */
+static uint8_t kw_match_format(const char *format) {
+    const ElogKwMatcher *kw = &elog.filter.kw;
+    uint32_t state = 0, end = kw->end;
+    bool has_args = false;
+
+    for (; *format != '\0'; format++) {
+        if (*format == '%') {
+            format++;
+            if (*format != '%') {
+                /* skip the conversion specification, the argument breaks the matching */
+                while (*format != '\0' && strchr("-+ #0123456789.*hlLqjzt", *format)) {
+                    format++;
+                }
+                if (*format == '\0') {
+                    break;
+                }
+                has_args = true;
+                state = 0;
+                continue;
+            }
+        }
+        state = kw_match_char(kw, state, *format);
+        if (state & end) {
+            return KW_MATCHED;
+        }
+    }
+
+    return has_args ? KW_UNKNOWN : KW_MISMATCHED;
+}
+
+/**
+ * match the keywords in the formatted log message
+ *
+ * @param log log message
+ * @param size log message size
+ *
+ * @return true: the keyword is found
+ */
+static bool kw_match_text(const char *log, size_t size) {
+    const ElogKwMatcher *kw = &elog.filter.kw;
+    uint32_t state = 0, end = kw->end;
+
+    while (size--) {
+        state = kw_match_char(kw, state, *log++);
+        if (state & end) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 /**
@@ -391,18 +683,176 @@ void elog_output_unlock(void) {
     }
 }
 
+/**
+ * Claim the line buffer of current context. The log is packaged in this buffer
+ * without output locked, so the log in ISR will not corrupt the preempted log.
+ * @note the nested contexts must release the buffer in reverse order, it is
+ *       always true for the ISR preempting on bare metal
+ *
+ * @param level the log level, the log is counted as dropped by core when no buffer
+ *
+ * @return context index, it is -1 when all buffers are used by the nested contexts
+ */
+int elog_ctx_claim(uint8_t level) {
+    int ctx = -1;
+
+    elog_output_lock();
+    if (ctx_depth < ELOG_CTX_MAX_NUM) {
+        ctx = ctx_depth++;
+    } else {
+        ctx_drop_num++;
+        elog_stat_drop(ELOG_STAGE_CORE, level, 0);
+    }
+    elog_output_unlock();
+
+    return ctx;
+}
+
+/**
+ * release the line buffer which is claimed by elog_ctx_claim
+ */
+void elog_ctx_release(void) {
+    elog_output_lock();
+    ctx_depth--;
+    elog_output_unlock();
+}
+
+/**
+ * get the dropped log number when all context buffers are used
+ *
+ * @return dropped log number
+ */
+size_t elog_get_ctx_drop_num(void) {
+    return ctx_drop_num;
+}
+
 /**
  * set log filter's tag level val to default
  */
 static void elog_set_filter_tag_lvl_default(void)
 {
-    uint8_t i = 0;
+    size_t i;
+
+    elog_output_lock();
+    for (i = 0; i < tag_num; i++) {
+        tag_table[i].level = ELOG_FILTER_LVL_ALL;
+        tag_update(&tag_table[i]);
+    }
+    elog_output_unlock();
+}
+
+/**
+ * find the interned tag
+ *
+ * @param tag tag
+ *
+ * @return tag ID, ELOG_TAG_ID_NONE: the tag is not interned
+ */
+static ElogTagId tag_find(const char *tag)
+{
+    size_t i, num = tag_num;
+
+    for (i = 0; i < num; i++) {
+        if (!strncmp(tag, tag_pool + tag_table[i].name, ELOG_FILTER_TAG_MAX_LEN)) {
+            return (ElogTagId) (i + 1);
+        }
+    }
+
+    return ELOG_TAG_ID_NONE;
+}
+
+/**
+ * merge the level filter, tag's level filter and tag filter to the tag's output level
+ * @note it is called in output locked
+ *
+ * @param entry interned tag
+ */
+static void tag_update(TagEntry *entry)
+{
+    uint8_t level = elog.filter.level;
+
+    if (entry->level < level) {
+        level = entry->level;
+    }
+    if (strstr(tag_pool + entry->name, elog.filter.tag)) {
+        entry->output_lvl = level + 1;
+    } else {
+        entry->output_lvl = 0;
+    }
+}
+
+/**
+ * update all interned tags' output level after the filter is changed
+ */
+static void tag_update_all(void)
+{
+    size_t i;
+
+    elog_output_lock();
+    for (i = 0; i < tag_num; i++) {
+        tag_update(&tag_table[i]);
+    }
+    elog_output_unlock();
+}
+
+/**
+ * Intern the tag to a small ID. The tag is added to the tag table when it is
+ * first used, then the level and tag filter is only a table lookup by the ID.
+ *
+ * @param tag tag
+ *
+ * @return tag ID, ELOG_TAG_ID_NONE: the tag table or name pool is full
+ */
+ElogTagId elog_tag_intern(const char *tag)
+{
+    ElogTagId id;
+    TagEntry *entry;
+    size_t name_len;
+
+    ELOG_ASSERT(tag != ((void *)0));
+
+    if ((id = tag_find(tag)) != ELOG_TAG_ID_NONE) {
+        return id;
+    }
+
+    elog_output_lock();
+    /* find again, the tag may be interned by the preempted context */
+    if ((id = tag_find(tag)) == ELOG_TAG_ID_NONE) {
+        name_len = strlen(tag);
+        if (name_len > ELOG_FILTER_TAG_MAX_LEN) {
+            name_len = ELOG_FILTER_TAG_MAX_LEN;
+        }
+        if (tag_num < ELOG_TAG_MAX_NUM && tag_pool_len + name_len + 1 <= ELOG_TAG_POOL_SIZE) {
+            entry = &tag_table[tag_num];
+            entry->name = (uint16_t) tag_pool_len;
+            entry->level = ELOG_FILTER_LVL_ALL;
+            memcpy(tag_pool + tag_pool_len, tag, name_len);
+            tag_pool[tag_pool_len + name_len] = '\0';
+            tag_pool_len += name_len + 1;
+            tag_update(entry);
+            /* the entry is ready, publish it */
+            id = (ElogTagId) (++tag_num);
+        }
+    }
+    elog_output_unlock();
 
-    for (i =0; i< ELOG_FILTER_TAG_LVL_MAX_NUM; i++){
-        memset(elog.filter.tag_lvl[i].tag, '\0', ELOG_FILTER_TAG_MAX_LEN + 1);
-        elog.filter.tag_lvl[i].level = ELOG_FILTER_LVL_SILENT;
-        elog.filter.tag_lvl[i].tag_use_flag = false;
+    return id;
+}
+
+/**
+ * get the interned tag name
+ *
+ * @param id tag ID
+ *
+ * @return tag name, NULL: the tag is not interned
+ */
+const char *elog_tag_get_name(ElogTagId id)
+{
+    if (id == ELOG_TAG_ID_NONE || id > tag_num) {
+        return NULL;
     }
+
+    return tag_pool + tag_table[id - 1].name;
 }
 
 /**
@@ -427,44 +877,19 @@ void elog_set_filter_tag_lvl(const char *tag, uint8_t level)
 {
     ELOG_ASSERT(level <= ELOG_LVL_VERBOSE);
     ELOG_ASSERT(tag != ((void *)0));
-    uint8_t i = 0;
+    ElogTagId id;
 
     if (!elog.init_ok) {
         return;
     }
 
-    elog_output_lock();
-    /* find the tag in arr */
-    for (i =0; i< ELOG_FILTER_TAG_LVL_MAX_NUM; i++){
-        if (elog.filter.tag_lvl[i].tag_use_flag == true &&
-            !strncmp(tag, elog.filter.tag_lvl[i].tag,ELOG_FILTER_TAG_MAX_LEN)){
-            break;
-        }
-    }
-
-    if (i < ELOG_FILTER_TAG_LVL_MAX_NUM){
-        /* find OK */
-        if (level == ELOG_FILTER_LVL_ALL){
-            /* remove current tag's level filter when input level is the lowest level */
-             elog.filter.tag_lvl[i].tag_use_flag = false;
-             memset(elog.filter.tag_lvl[i].tag, '\0', ELOG_FILTER_TAG_MAX_LEN + 1);
-             elog.filter.tag_lvl[i].level = ELOG_FILTER_LVL_SILENT;
-        } else{
-            elog.filter.tag_lvl[i].level = level;
-        }
-    } else{
-        /* only add the new tag's level filer when level is not ELOG_FILTER_LVL_ALL */
-        if (level != ELOG_FILTER_LVL_ALL){
-            for (i =0; i< ELOG_FILTER_TAG_LVL_MAX_NUM; i++){
-                if (elog.filter.tag_lvl[i].tag_use_flag == false){
-                    strncpy(elog.filter.tag_lvl[i].tag, tag, ELOG_FILTER_TAG_MAX_LEN);
-                    elog.filter.tag_lvl[i].level = level;
-                    elog.filter.tag_lvl[i].tag_use_flag = true;
-                    break;
-                }
-            }
-        }
+    /* the tag is interned, so it's level can be set before it is used */
+    if ((id = elog_tag_intern(tag)) == ELOG_TAG_ID_NONE) {
+        return;
     }
+    elog_output_lock();
+    tag_table[id - 1].level = level;
+    tag_update(&tag_table[id - 1]);
     elog_output_unlock();
 }
 
@@ -479,25 +904,49 @@ void elog_set_filter_tag_lvl(const char *tag, uint8_t level)
 uint8_t elog_get_filter_tag_lvl(const char *tag)
 {
     ELOG_ASSERT(tag != ((void *)0));
-    uint8_t i = 0;
-    uint8_t level = ELOG_FILTER_LVL_ALL;
+    ElogTagId id;
 
-    if (!elog.init_ok) {
-        return level;
+    if (!elog.init_ok || (id = tag_find(tag)) == ELOG_TAG_ID_NONE) {
+        return ELOG_FILTER_LVL_ALL;
     }
 
-    elog_output_lock();
-    /* find the tag in arr */
-    for (i =0; i< ELOG_FILTER_TAG_LVL_MAX_NUM; i++){
-        if (elog.filter.tag_lvl[i].tag_use_flag == true &&
-            !strncmp(tag, elog.filter.tag_lvl[i].tag,ELOG_FILTER_TAG_MAX_LEN)){
-            level = elog.filter.tag_lvl[i].level;
-            break;
-        }
-    }
-    elog_output_unlock();
+    return tag_table[id - 1].level;
+}
+
+/**
+ * initialize the record of the log which is not output by a call site, such as the raw log and hex dump
+ *
+ * @param ctx context which claims the record
+ * @param level level
+ * @param tag tag, NULL: the log has no tag
+ *
+ * @return record
+ */
+static ElogRecord *record_init(int ctx, uint8_t level, const char *tag) {
+    ElogRecord *record = &record_buf[ctx];
+
+    memset(record, 0, sizeof(ElogRecord));
+    record->timestamp = elog_port_get_timestamp();
+    record->seq = ELOG_SEQ_NONE;
+    record->level = level;
+    record->site_id = ELOG_SITE_ID_NONE;
+    record->tag = tag;
+
+    return record;
+}
 
-    return level;
+/**
+ * set the packaged log of the record, all of it is the payload
+ *
+ * @param record record
+ * @param log packaged log
+ * @param size log size
+ */
+static void record_set_log(ElogRecord *record, const char *log, size_t size) {
+    record->log = log;
+    record->size = size;
+    record->payload = 0;
+    record->payload_size = (uint16_t) (size > UINT16_MAX ? UINT16_MAX : size);
 }
 
 /**
@@ -509,42 +958,45 @@ uint8_t elog_get_filter_tag_lvl(const char *tag)
 void elog_raw_output(const char *format, ...) {
     va_list args;
     size_t log_len = 0;
-    int fmt_result;
+    int fmt_result, ctx;
+    ElogRecord *record;
+    char *buf;
 
     /* check output enabled */
     if (!elog.output_enabled) {
         return;
     }
+    /* claim the buffer of current context */
+    if ((ctx = elog_ctx_claim(ELOG_LVL_ASSERT)) < 0) {
+        return;
+    }
+    buf = log_buf[ctx];
+    /* raw log will using assert level */
+    record = record_init(ctx, ELOG_LVL_ASSERT, NULL);
 
     /* args point to the first variable parameter */
     va_start(args, format);
 
-    /* lock output */
-    elog_output_lock();
-
     /* package log data to buffer */
-    fmt_result = vsnprintf(log_buf, ELOG_LINE_BUF_SIZE, format, args);
+    fmt_result = elog_vsnprintf(buf, ELOG_LINE_BUF_SIZE, format, args);
 
     /* output converted log */
     if ((fmt_result > -1) && (fmt_result <= ELOG_LINE_BUF_SIZE)) {
         log_len = fmt_result;
     } else {
         log_len = ELOG_LINE_BUF_SIZE;
+        elog_stat_trunc(ELOG_STAGE_CORE, ELOG_LVL_ASSERT, fmt_result > -1 ? fmt_result - log_len : 0);
     }
+    record_set_log(record, buf, log_len);
+    do_output_wait(record);
+    /* lock output */
+    elog_output_lock();
     /* output log */
-#if defined(ELOG_ASYNC_OUTPUT_ENABLE)
-    extern void elog_async_output(uint8_t level, const char *log, size_t size);
-    /* raw log will using assert level */
-    elog_async_output(ELOG_LVL_ASSERT, log_buf, log_len);
-#elif defined(ELOG_BUF_OUTPUT_ENABLE)
-    extern void elog_buf_output(const char *log, size_t size);
-    elog_buf_output(log_buf, log_len);
-#else
-    elog_port_output(log_buf, log_len);
-#endif
+    do_output(record);
     /* unlock output */
     elog_output_unlock();
 
+    elog_ctx_release();
     va_end(args);
 }
 
@@ -562,112 +1014,400 @@ void elog_raw_output(const char *format, ...) {
  */
 void elog_output(uint8_t level, const char *tag, const char *file, const char *func,
         const long line, const char *format, ...) {
-    extern const char *elog_port_get_time(void);
-    extern const char *elog_port_get_p_info(void);
-    extern const char *elog_port_get_t_info(void);
-
-    size_t tag_len = strlen(tag), log_len = 0, newline_len = strlen(ELOG_NEWLINE_SIGN);
-    char line_num[ELOG_LINE_NUM_MAX_LEN + 1] = { 0 };
-    char tag_sapce[ELOG_FILTER_TAG_MAX_LEN / 2 + 1] = { 0 };
+    ElogTagCache cache = { NULL, ELOG_TAG_ID_NONE };
     va_list args;
-    int fmt_result;
 
     ELOG_ASSERT(level <= ELOG_LVL_VERBOSE);
 
-    /* check output enabled */
-    if (!elog.output_enabled) {
+    /* check output enabled, level and tag filter, the local cache keeps the tag ID for the record */
+    if (!elog_output_filter(level, tag, &cache)) {
         return;
     }
-    /* level filter */
-    if (level > elog.filter.level || level > elog_get_filter_tag_lvl(tag)) {
-        return;
-    } else if (!strstr(tag, elog.filter.tag)) { /* tag filter */
+    /* args point to the first variable parameter */
+    va_start(args, format);
+
+    output_args(NULL, cache.id, level, tag, file, func, line, format, args);
+
+    va_end(args);
+}
+
+/**
+ * output the log, the tag ID is cached by the log call site
+ *
+ * @param cache tag ID cache of the log call site
+ * @param level level
+ * @param tag tag
+ * @param file file name
+ * @param func function name
+ * @param line line number
+ * @param format output format
+ * @param ... args
+ */
+void elog_output_with_cache(ElogTagCache *cache, uint8_t level, const char *tag, const char *file,
+        const char *func, const long line, const char *format, ...) {
+    ElogTagCache local = { NULL, ELOG_TAG_ID_NONE };
+    va_list args;
+
+    ELOG_ASSERT(level <= ELOG_LVL_VERBOSE);
+
+    if (cache == NULL) {
+        cache = &local;
+    }
+    /* check output enabled, level and tag filter */
+    if (!elog_output_filter(level, tag, cache)) {
         return;
     }
     /* args point to the first variable parameter */
     va_start(args, format);
-    /* lock output */
-    elog_output_lock();
 
-#ifdef ELOG_COLOR_ENABLE
-    /* add CSI start sign and color info */
-    if (elog.text_color_enabled) {
-        log_len += elog_strcpy(log_len, log_buf + log_len, CSI_START);
-        log_len += elog_strcpy(log_len, log_buf + log_len, color_output_info[level]);
-    }
-#endif
+    output_args(NULL, cache->id, level, tag, file, func, line, format, args);
 
-    /* package level info */
-    if (get_fmt_enabled(level, ELOG_FMT_LVL)) {
-        log_len += elog_strcpy(log_len, log_buf + log_len, level_output_info[level]);
-    }
-    /* package tag info */
-    if (get_fmt_enabled(level, ELOG_FMT_TAG)) {
-        log_len += elog_strcpy(log_len, log_buf + log_len, tag);
-        /* if the tag length is less than 50% ELOG_FILTER_TAG_MAX_LEN, then fill space */
-        if (tag_len <= ELOG_FILTER_TAG_MAX_LEN / 2) {
-            memset(tag_sapce, ' ', ELOG_FILTER_TAG_MAX_LEN / 2 - tag_len);
-            log_len += elog_strcpy(log_len, log_buf + log_len, tag_sapce);
-        }
-        log_len += elog_strcpy(log_len, log_buf + log_len, " ");
-    }
-    /* package time, process and thread info */
-    if (get_fmt_enabled(level, ELOG_FMT_TIME | ELOG_FMT_P_INFO | ELOG_FMT_T_INFO)) {
-        log_len += elog_strcpy(log_len, log_buf + log_len, "[");
-        /* package time info */
-        if (get_fmt_enabled(level, ELOG_FMT_TIME)) {
-            log_len += elog_strcpy(log_len, log_buf + log_len, elog_port_get_time());
-            if (get_fmt_enabled(level, ELOG_FMT_P_INFO | ELOG_FMT_T_INFO)) {
-                log_len += elog_strcpy(log_len, log_buf + log_len, " ");
-            }
-        }
-        /* package process info */
-        if (get_fmt_enabled(level, ELOG_FMT_P_INFO)) {
-            log_len += elog_strcpy(log_len, log_buf + log_len, elog_port_get_p_info());
-            if (get_fmt_enabled(level, ELOG_FMT_T_INFO)) {
-                log_len += elog_strcpy(log_len, log_buf + log_len, " ");
-            }
+    va_end(args);
+}
+
+/**
+ * output the log of the call site, the constant tag's ID is cached by the site
+ *
+ * @param site log call site
+ * @param tag tag, it may be variable
+ * @param format output format
+ * @param ... args
+ */
+void elog_output_site(const ElogSite *site, const char *tag, const char *format, ...) {
+    ElogTagCache local = { NULL, ELOG_TAG_ID_NONE };
+    ElogTagCache *cache = site->tag ? &site->state->cache : &local;
+    uint8_t level = (uint8_t) site->level;
+    va_list args;
+
+    ELOG_ASSERT(level <= ELOG_LVL_VERBOSE);
+
+    /* check output enabled, level and tag filter */
+    if (!elog_output_filter(level, tag, cache)) {
+        return;
+    }
+    /* args point to the first variable parameter */
+    va_start(args, format);
+
+    output_args(site, cache->id, level, tag, site->file, site->func, site->line, format, args);
+
+    va_end(args);
+}
+
+/**
+ * fill the log record of current context and output it, the log may be deferred
+ *
+ * @param site log call site, NULL: the log is not output by a call site
+ * @param tag_id interned tag ID
+ * @param level level
+ * @param tag tag
+ * @param file file name
+ * @param func function name
+ * @param line line number
+ * @param format output format
+ * @param args args
+ */
+static void output_args(const ElogSite *site, ElogTagId tag_id, uint8_t level, const char *tag,
+        const char *file, const char *func, const long line, const char *format, va_list args) {
+#ifdef ELOG_DEFERRED_OUTPUT_ENABLE
+    extern bool elog_deferred_output(const ElogRecord *record, const char *format, va_list *args);
+    va_list args_copy;
+    bool deferred;
+#endif
+    ElogRecord *record;
+    uint8_t kw_result = KW_MATCHED;
+    int ctx;
+
+    /* the result of keyword filter before formatting is passed to the packaging, so the format is scanned once */
+    if (elog.filter.kw.end && (kw_result = kw_match_format(format)) == KW_MISMATCHED) {
+        return;
+    }
+    /* claim the buffer of current context, it is not locked when packaging */
+    if ((ctx = elog_ctx_claim(level)) < 0) {
+        return;
+    }
+    record = &record_buf[ctx];
+    record->timestamp = elog_port_get_timestamp();
+    /* the sequence number is taken when a sink accepts the log, so the rejected log leaves no gap */
+    record->seq = ELOG_SEQ_NONE;
+    record->level = level;
+    record->tag_id = tag_id;
+    record->site_id = site ? elog_site_get_id(site) : ELOG_SITE_ID_NONE;
+    /* the tag may be variable, the kept record must not use it after this call, @see tag_id */
+    record->tag = tag;
+    record->file = file;
+    record->func = func;
+    record->line = line;
+    record->format = format;
+    record->args = NULL;
+
+#ifdef ELOG_DEFERRED_OUTPUT_ENABLE
+    /* only capture the raw arguments now, the log will be formatted in elog_idle(),
+     * the site log in binary output mode is framed by it's arguments without formatting */
+    if (!SITE_IS_FRAMED(site)) {
+        va_copy(args_copy, args);
+        deferred = elog_deferred_output(record, format, &args_copy);
+        va_end(args_copy);
+        if (deferred) {
+            elog_ctx_release();
+            return;
         }
-        /* package thread info */
-        if (get_fmt_enabled(level, ELOG_FMT_T_INFO)) {
-            log_len += elog_strcpy(log_len, log_buf + log_len, elog_port_get_t_info());
+    }
+#endif
+
+    output_log(ctx, 0, kw_result, format, args);
+
+    elog_ctx_release();
+#ifdef ELOG_DEDUP_ENABLE
+    /* the repeated summary claims a context buffer again, it is output after release */
+    elog_dedup_flush();
+#endif
+}
+
+/**
+ * check the log is passed output enabled, level and tag filter
+ *
+ * @param level level
+ * @param tag tag
+ * @param cache tag ID cache of the log call site, the tag will be found in tag table when it is NULL
+ *
+ * @return true: the log should be output
+ */
+bool elog_output_filter(uint8_t level, const char *tag, ElogTagCache *cache) {
+    ElogTagId id;
+
+    /* check output enabled */
+    if (!elog.output_enabled) {
+        return false;
+    }
+    if (cache) {
+        /* the ID is read before the tag, so the cache which is changed by preemption is never mismatched */
+        id = cache->id;
+        if (id == ELOG_TAG_ID_NONE || cache->tag != tag) {
+            id = elog_tag_intern(tag);
+            cache->id = ELOG_TAG_ID_NONE;
+            cache->tag = tag;
+            cache->id = id;
         }
-        log_len += elog_strcpy(log_len, log_buf + log_len, "] ");
-    }
-    /* package file directory and name, function name and line number info */
-    if (get_fmt_used_and_enabled_ptr(level, ELOG_FMT_DIR, file) ||
-            get_fmt_used_and_enabled_ptr(level, ELOG_FMT_FUNC, func) ||
-            get_fmt_used_and_enabled_u32(level, ELOG_FMT_LINE, line)) {
-        log_len += elog_strcpy(log_len, log_buf + log_len, "(");
-        /* package file info */
-        if (get_fmt_used_and_enabled_ptr(level, ELOG_FMT_DIR, file)) {
-            log_len += elog_strcpy(log_len, log_buf + log_len, file);
-            if (get_fmt_used_and_enabled_ptr(level, ELOG_FMT_FUNC, func)) {
-                log_len += elog_strcpy(log_len, log_buf + log_len, ":");
-            } else if (get_fmt_used_and_enabled_u32(level, ELOG_FMT_LINE, line)) {
-                log_len += elog_strcpy(log_len, log_buf + log_len, " ");
-            }
+    } else {
+        id = elog_tag_intern(tag);
+    }
+    /* level, tag's level and tag filter are merged in the tag's output level */
+    if (id != ELOG_TAG_ID_NONE) {
+        return level < tag_table[id - 1].output_lvl;
+    }
+
+    /* the tag table is full, only level and tag filter */
+    if (level > elog.filter.level) {
+        return false;
+    } else if (!strstr(tag, elog.filter.tag)) { /* tag filter */
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Output the log by the record which is captured before, it is used by deferred
+ * output mode and the repeated summary. The timestamp, sequence number and call
+ * site of the record are kept, the packaged log in it is ignored.
+ * @note the level and tag filter has been done before
+ *
+ * @param record captured record
+ * @param format output format
+ * @param ... args
+ */
+void elog_output_record(const ElogRecord *record, const char *format, ...) {
+    va_list args;
+
+    /* args point to the first variable parameter */
+    va_start(args, format);
+
+    output_record(record, 0, format, args);
+
+    va_end(args);
+}
+
+#ifdef ELOG_SINK_ENABLE
+/**
+ * Output the log by the record which is captured before to the given sinks, the
+ * level and tag filter of the sinks are skipped. It is used by the pre-trigger logs,
+ * they are kept by the low level and output to the sinks which don't accept it.
+ *
+ * @param record captured record
+ * @param mask the sinks to output, @see elog_sink_get_mask
+ * @param format output format
+ * @param ... args
+ */
+void elog_output_record_to(const ElogRecord *record, uint8_t mask, const char *format, ...) {
+    va_list args;
+
+    if (mask == 0) {
+        return;
+    }
+    /* args point to the first variable parameter */
+    va_start(args, format);
+
+    output_record(record, mask, format, args);
+
+    va_end(args);
+}
+#endif /* ELOG_SINK_ENABLE */
+
+/**
+ * output the log by the record which is captured before
+ *
+ * @param record captured record
+ * @param mask the sinks to output, 0: the sinks which accept the record
+ * @param format output format
+ * @param args args
+ */
+static void output_record(const ElogRecord *record, uint8_t mask, const char *format, va_list args) {
+    uint8_t kw_result = KW_MATCHED;
+    int ctx;
+
+    ELOG_ASSERT(record->level <= ELOG_LVL_VERBOSE);
+
+    /* check output enabled */
+    if (!elog.output_enabled) {
+        return;
+    }
+    /* keyword filter before formatting, the filter may be changed after the record is captured */
+    if (elog.filter.kw.end && (kw_result = kw_match_format(format)) == KW_MISMATCHED) {
+        return;
+    }
+    /* claim the buffer of current context */
+    if ((ctx = elog_ctx_claim(record->level)) < 0) {
+        return;
+    }
+    record_buf[ctx] = *record;
+    record_buf[ctx].log = NULL;
+    record_buf[ctx].size = 0;
+
+    output_log(ctx, mask, kw_result, format, args);
+
+    elog_ctx_release();
+#ifdef ELOG_DEDUP_ENABLE
+    elog_dedup_flush();
+#endif
+}
+
+/**
+ * package and output the log record of current context which has passed level and tag filter
+ *
+ * @param ctx context which claims the record and line buffer
+ * @param mask the sinks to output, 0: the sinks which accept the record, it is only used by the router
+ * @param kw_result keyword filter result before formatting, KW_UNKNOWN: the formatted log is matched
+ * @param format output format
+ * @param args args
+ */
+static void output_log(int ctx, uint8_t mask, uint8_t kw_result, const char *format, va_list args) {
+    extern size_t elog_port_timestamp_render(char *buf, uint64_t timestamp);
+    extern const char *elog_port_get_p_info(void);
+    extern const char *elog_port_get_t_info(void);
+
+    ElogRecord *record = &record_buf[ctx];
+    uint8_t level = record->level;
+    const OutputLayout *layout = &output_layout[level];
+    const uint8_t *step = layout->step;
+    const char *text = layout->text;
+    size_t log_len = 0, head_len, full_len, newline_len = sizeof(ELOG_NEWLINE_SIGN) - 1;
+    size_t seq_pos = 0, seq_len, log_max_len = ELOG_LINE_BUF_SIZE - newline_len;
+    bool seq_step = false;
+    char *buf = log_buf[ctx];
+    int fmt_result;
+#if defined(ELOG_SINK_ENABLE) || defined(ELOG_BIN_OUTPUT_ENABLE)
+    va_list args_copy;
+    bool text_sink = false;
+#endif
+#ifndef ELOG_SINK_ENABLE
+    (void) mask;
+#endif
+
+#ifdef ELOG_SINK_ENABLE
+    /* the log which no sink accepts is not packaged, the log to the given sinks is always packaged */
+    if (mask) {
+        text_sink = true;
+    } else if ((mask = elog_sink_match(level, record->tag, &text_sink)) == 0) {
+        return;
+    }
+#endif
+#ifdef ELOG_BIN_OUTPUT_ENABLE
+    /* only the site log is framed by it's arguments, the decoder finds the format by the site */
+    if (record->site_id == ELOG_SITE_ID_NONE) {
+        text_sink = true;
+    }
+#endif
+#if defined(ELOG_SINK_ENABLE) || defined(ELOG_BIN_OUTPUT_ENABLE)
+    /* the record sinks use the captured arguments, the log is not packaged when no other sink accepts it */
+    if (!text_sink && record->args == NULL) {
+        va_copy(args_copy, args);
+        if (elog_args_capture(&args_buf[ctx], format, &args_copy)) {
+            record->format = format;
+            record->args = &args_buf[ctx];
         }
-        /* package line info */
-        if (get_fmt_used_and_enabled_u32(level, ELOG_FMT_LINE, line)) {
-            snprintf(line_num, ELOG_LINE_NUM_MAX_LEN, "%ld", line);
-            log_len += elog_strcpy(log_len, log_buf + log_len, line_num);
-            if (get_fmt_used_and_enabled_ptr(level, ELOG_FMT_FUNC, func)) {
-                log_len += elog_strcpy(log_len, log_buf + log_len, " ");
+        va_end(args_copy);
+    }
+    /* the keyword which is unknown before formatting still needs the packaged log */
+    if (!text_sink && record->args && kw_result != KW_UNKNOWN) {
+        record->log = NULL;
+        record->size = 0;
+        record->payload = 0;
+        record->payload_size = 0;
+        elog_output_lock();
+        record_take_seq(record);
+#ifdef ELOG_SINK_ENABLE
+        elog_sink_output(record, mask);
+#else
+        mode_output(record);
+#endif
+        elog_output_unlock();
+        return;
+    }
+#endif
+
+    /* package the log head by the compiled layout */
+    for (; *step != LAYOUT_STEP_END; step++) {
+        switch (*step) {
+        case LAYOUT_STEP_TEXT:
+            /* the constant text length is in the next step */
+            step++;
+            log_len += layout_text_copy(log_len, buf + log_len, text, *step);
+            text += *step;
+            break;
+        case LAYOUT_STEP_TAG:
+            log_len += output_tag(log_len, buf + log_len, record->tag);
+            break;
+        case LAYOUT_STEP_SEQ:
+            /* the sequence number is inserted after the log is accepted, @see output_seq */
+            seq_step = true;
+            seq_pos = log_len;
+            break;
+        case LAYOUT_STEP_TIME:
+            /* the timestamp is rendered only when it is in the layout */
+            if (log_len + ELOG_TIME_STR_MAX_LEN < ELOG_LINE_BUF_SIZE) {
+                log_len += elog_port_timestamp_render(buf + log_len, record->timestamp);
             }
+            break;
+        case LAYOUT_STEP_P_INFO:
+            log_len += elog_strcpy(log_len, buf + log_len, elog_port_get_p_info());
+            break;
+        case LAYOUT_STEP_T_INFO:
+            log_len += elog_strcpy(log_len, buf + log_len, elog_port_get_t_info());
+            break;
+        case LAYOUT_STEP_LOCATION:
+            log_len += output_location(log_len, buf + log_len, elog.enabled_fmt_set[level], record->file,
+                    record->func, record->line);
+            break;
+        default:
+            break;
         }
-        /* package func info */
-        if (get_fmt_used_and_enabled_ptr(level, ELOG_FMT_FUNC, func)) {
-            log_len += elog_strcpy(log_len, log_buf + log_len, func);
-            
-        }
-        log_len += elog_strcpy(log_len, log_buf + log_len, ")");
     }
+    head_len = log_len;
     /* package other log data to buffer. '\0' must be added in the end by vsnprintf. */
-    fmt_result = vsnprintf(log_buf + log_len, ELOG_LINE_BUF_SIZE - log_len, format, args);
+    fmt_result = elog_vsnprintf(buf + log_len, ELOG_LINE_BUF_SIZE - log_len, format, args);
 
-    va_end(args);
-    /* calculate log length */
+    /* calculate log length, the full length is kept to count the truncated size */
+    full_len = log_len + (fmt_result > -1 ? fmt_result : 0);
     if ((log_len + fmt_result <= ELOG_LINE_BUF_SIZE) && (fmt_result > -1)) {
         log_len += fmt_result;
     } else {
@@ -689,64 +1429,375 @@ void elog_output(uint8_t level, const char *tag, const char *file, const char *f
         /* reserve some space for newline sign */
         log_len -= newline_len;
     }
-    /* keyword filter */
-    if (elog.filter.keyword[0] != '\0') {
-        /* add string end sign */
-        log_buf[log_len] = '\0';
-        /* find the keyword */
-        if (!strstr(log_buf, elog.filter.keyword)) {
-            /* unlock output */
-            elog_output_unlock();
-            return;
-        }
+#ifdef ELOG_COLOR_ENABLE
+    log_max_len -= (sizeof(CSI_END) - 1);
+#endif
+    /* keyword filter after formatting, only the log message is matched */
+    if (kw_result == KW_UNKNOWN && !kw_match_text(buf + head_len, log_len - head_len)) {
+        return;
     }
 
+#ifdef ELOG_DEDUP_ENABLE
+    /* the same log as the last one is only counted */
+    if (head_len < log_len && elog_dedup_check(record, format, buf + head_len, log_len - head_len)) {
+        return;
+    }
+#endif
+
+    /* the log is accepted, it takes the sequence number now */
+    if (record->seq == ELOG_SEQ_NONE) {
+        record->seq = elog_seq_next();
+    }
+    if (seq_step) {
+        seq_len = output_seq(buf, seq_pos, &log_len, log_max_len, record->seq);
+        full_len += seq_len;
+        /* the payload may be truncated by the inserted sequence number */
+        head_len = head_len + seq_len < log_len ? head_len + seq_len : log_len;
+    }
+
+    if (full_len > log_len) {
+        elog_stat_trunc(ELOG_STAGE_CORE, level, full_len - log_len);
+    }
+    record->payload = (uint16_t) head_len;
+    record->payload_size = (uint16_t) (log_len - head_len);
+
 #ifdef ELOG_COLOR_ENABLE
     /* add CSI end sign */
     if (elog.text_color_enabled) {
-        log_len += elog_strcpy(log_len, log_buf + log_len, CSI_END);
+        log_len += elog_strcpy(log_len, buf + log_len, CSI_END);
     }
 #endif
 
     /* package newline sign */
-    log_len += elog_strcpy(log_len, log_buf + log_len, ELOG_NEWLINE_SIGN);
+    log_len += elog_strcpy(log_len, buf + log_len, ELOG_NEWLINE_SIGN);
+    record->log = buf;
+    record->size = log_len;
+    do_output_wait(record);
+    /* lock output */
+    elog_output_lock();
     /* output log */
+#ifdef ELOG_SINK_ENABLE
+    elog_sink_output(record, mask);
+#else
+    do_output(record);
+#endif
+    /* unlock output */
+    elog_output_unlock();
+}
+
+/**
+ * output the packaged log by the enabled output mode
+ *
+ * @param record log record, it's log must be packaged, except the site log in binary output mode
+ *
+ * @return output size, 0: the log is dropped
+ */
+static size_t mode_output(const ElogRecord *record) {
+#if defined(ELOG_BIN_OUTPUT_ENABLE)
+    /* the site log is framed by it's arguments, the text log is framed, so they can be mixed */
+    size_t size = elog_bin_output_record(record);
+
+    if (size == 0) {
+        elog_stat_drop(ELOG_STAGE_PORT, record->level, record->size);
+    }
+    return size;
+#else
+    uint8_t level = record->level;
+    const char *log = record->log;
+    size_t size = record->size;
+
 #if defined(ELOG_ASYNC_OUTPUT_ENABLE)
     extern void elog_async_output(uint8_t level, const char *log, size_t size);
-    elog_async_output(level, log_buf, log_len);
+    elog_async_output(level, log, size);
+    return size;
 #elif defined(ELOG_BUF_OUTPUT_ENABLE)
-    extern void elog_buf_output(const char *log, size_t size);
-    elog_buf_output(log_buf, log_len);
+    extern void elog_buf_output(uint8_t level, const char *log, size_t size);
+    elog_buf_output(level, log, size);
+    return size;
+#else
+    size_t out_size = elog_port_output(log, size);
+
+    elog_stat_put(ELOG_STAGE_PORT, level, size, out_size);
+    return out_size;
+#endif
+#endif /* ELOG_BIN_OUTPUT_ENABLE */
+}
+
+/**
+ * Wait the enabled output mode can accept the packaged log before output locked, such as
+ * the asynchronous block policy, the logs are output by drain while waiting.
+ *
+ * @param record log record, it's log must be packaged
+ */
+static void do_output_wait(const ElogRecord *record) {
+#if defined(ELOG_ASYNC_OUTPUT_ENABLE) && !defined(ELOG_BIN_OUTPUT_ENABLE)
+    elog_async_wait_space(record->level, record->size);
 #else
-    elog_port_output(log_buf, log_len);
+    (void) record;
 #endif
-    /* unlock output */
-    elog_output_unlock();
 }
 
 /**
- * get format enabled
+ * output the packaged log to all sinks which accept it, or only by the enabled output mode
+ * when the router is disabled
+ * @note it is called in output locked
  *
- * @param level level
- * @param set format set
+ * @param record log record, it's log must be packaged
+ */
+static void do_output(ElogRecord *record) {
+#ifdef ELOG_SINK_ENABLE
+    uint8_t mask = elog_sink_match(record->level, record->tag, NULL);
+
+    if (mask) {
+        record_take_seq(record);
+    }
+    elog_sink_output(record, mask);
+#else
+    record_take_seq(record);
+    mode_output(record);
+#endif
+}
+
+/**
+ * take the sequence number for the record which is accepted, the record keeps the taken one
+ * @note it is called in output locked
  *
- * @return enable or disable
+ * @param record log record
+ */
+static void record_take_seq(ElogRecord *record) {
+    if (record->seq == ELOG_SEQ_NONE) {
+        record->seq = elog_seq_take();
+    }
+}
+
+/**
+ * Insert the sequence number to the log head, it is inserted after the log is accepted
+ * by the sinks, the keyword and duplicate filter. The log tail is truncated when the
+ * line buffer is full.
+ *
+ * @param buf line buffer
+ * @param pos the position of the sequence number in the log head
+ * @param log_len packaged log length, it is updated by the inserted length
+ * @param max_len max log length, the space of CSI end sign and newline sign is not included
+ * @param seq sequence number
+ *
+ * @return inserted length
+ */
+static size_t output_seq(char *buf, size_t pos, size_t *log_len, size_t max_len, uint32_t seq) {
+    char seq_buf[ELOG_U32_STR_MAX_LEN + 3];
+    size_t seq_len = 0;
+
+    seq_buf[seq_len++] = '#';
+    seq_len += elog_u32toa(seq_buf + seq_len, seq);
+    seq_buf[seq_len++] = ' ';
+    if (pos + seq_len > max_len) {
+        return 0;
+    }
+    if (*log_len + seq_len > max_len) {
+        *log_len = max_len - seq_len;
+    }
+    memmove(buf + pos + seq_len, buf + pos, *log_len - pos);
+    memcpy(buf + pos, seq_buf, seq_len);
+    *log_len += seq_len;
+
+    return seq_len;
+}
+
+/**
+ * add the constant text to the layout, it is merged with the previous text step
+ *
+ * @param compiler layout compiler
+ * @param str constant text, it will be truncated when the layout is full
  */
-static bool get_fmt_enabled(uint8_t level, size_t set) {
+static void layout_add_text(LayoutCompiler *compiler, const char *str) {
+    OutputLayout *layout = compiler->layout;
+
+    /* the previous text step is extended, otherwise add a new text step */
+    if (compiler->text_step == NULL) {
+        /* the last step is always reserved for end step */
+        if (compiler->step_num + 2 >= LAYOUT_STEP_MAX_NUM) {
+            return;
+        }
+        layout->step[compiler->step_num++] = LAYOUT_STEP_TEXT;
+        compiler->text_step = &layout->step[compiler->step_num++];
+        *compiler->text_step = 0;
+    }
+    while (*str != '\0' && compiler->text_len < LAYOUT_TEXT_MAX_LEN) {
+        layout->text[compiler->text_len++] = *str++;
+        (*compiler->text_step)++;
+    }
+}
+
+/**
+ * add the runtime step to the layout
+ *
+ * @param compiler layout compiler
+ * @param step layout step
+ */
+static void layout_add_step(LayoutCompiler *compiler, LayoutStep step) {
+    /* the last step is always reserved for end step */
+    if (compiler->step_num + 1 < LAYOUT_STEP_MAX_NUM) {
+        compiler->layout->step[compiler->step_num++] = (uint8_t) step;
+        compiler->text_step = NULL;
+    }
+}
+
+/**
+ * Compile the level's output layout by it's format set and color setting. The
+ * constant texts, such as color sign, level info and brackets, are merged, so the
+ * log head packaging doesn't check the format set again.
+ *
+ * @param level level
+ */
+static void compile_layout(uint8_t level) {
+    LayoutCompiler compiler = { &output_layout[level], 0, 0, NULL };
+    size_t set = elog.enabled_fmt_set[level];
+
     ELOG_ASSERT(level <= ELOG_LVL_VERBOSE);
 
-    if (elog.enabled_fmt_set[level] & set) {
-        return true;
-    } else {
-        return false;
+    memset(compiler.layout, 0, sizeof(OutputLayout));
+#ifdef ELOG_COLOR_ENABLE
+    /* add CSI start sign and color info */
+    if (elog.text_color_enabled) {
+        layout_add_text(&compiler, CSI_START);
+        layout_add_text(&compiler, color_output_info[level]);
+    }
+#endif
+    /* level info */
+    if (set & ELOG_FMT_LVL) {
+        layout_add_text(&compiler, level_output_info[level]);
+    }
+    /* tag info */
+    if (set & ELOG_FMT_TAG) {
+        layout_add_step(&compiler, LAYOUT_STEP_TAG);
+        layout_add_text(&compiler, " ");
+    }
+    /* sequence number, the trailing space is packaged with it */
+    if (set & ELOG_FMT_SEQ) {
+        layout_add_step(&compiler, LAYOUT_STEP_SEQ);
+    }
+    /* time, process and thread info */
+    if (set & (ELOG_FMT_TIME | ELOG_FMT_P_INFO | ELOG_FMT_T_INFO)) {
+        layout_add_text(&compiler, "[");
+        if (set & ELOG_FMT_TIME) {
+            layout_add_step(&compiler, LAYOUT_STEP_TIME);
+            if (set & (ELOG_FMT_P_INFO | ELOG_FMT_T_INFO)) {
+                layout_add_text(&compiler, " ");
+            }
+        }
+        if (set & ELOG_FMT_P_INFO) {
+            layout_add_step(&compiler, LAYOUT_STEP_P_INFO);
+            if (set & ELOG_FMT_T_INFO) {
+                layout_add_text(&compiler, " ");
+            }
+        }
+        if (set & ELOG_FMT_T_INFO) {
+            layout_add_step(&compiler, LAYOUT_STEP_T_INFO);
+        }
+        layout_add_text(&compiler, "] ");
+    }
+    /* file directory and name, function name and line number info, they depend on the log call */
+    if (set & (ELOG_FMT_DIR | ELOG_FMT_FUNC | ELOG_FMT_LINE)) {
+        layout_add_step(&compiler, LAYOUT_STEP_LOCATION);
     }
 }
 
-static bool get_fmt_used_and_enabled_u32(uint8_t level, size_t set, uint32_t arg) {
-    return arg && get_fmt_enabled(level, set);
+/**
+ * copy the layout's constant text to log buffer
+ *
+ * @param cur_len current log length
+ * @param dst destination
+ * @param text constant text
+ * @param len text length
+ *
+ * @return copied length
+ */
+static size_t layout_text_copy(size_t cur_len, char *dst, const char *text, size_t len) {
+    if (cur_len + len > ELOG_LINE_BUF_SIZE) {
+        len = ELOG_LINE_BUF_SIZE - cur_len;
+    }
+    memcpy(dst, text, len);
+
+    return len;
+}
+
+/**
+ * package the tag info, the tag is filled with space when it is short
+ *
+ * @param cur_len current log length
+ * @param dst destination
+ * @param tag tag, NULL: the tag is unknown, such as the rebuilt record which tag is not interned
+ *
+ * @return packaged length
+ */
+static size_t output_tag(size_t cur_len, char *dst, const char *tag) {
+    size_t len;
+
+    if (tag == NULL) {
+        tag = "";
+    }
+    len = elog_strcpy(cur_len, dst, tag);
+
+    /* if the tag length is less than 50% ELOG_FILTER_TAG_MAX_LEN, then fill space */
+    if (tag[len] == '\0') {
+        while (len < ELOG_FILTER_TAG_MAX_LEN / 2 && cur_len + len < ELOG_LINE_BUF_SIZE) {
+            dst[len++] = ' ';
+        }
+    }
+
+    return len;
 }
-static bool get_fmt_used_and_enabled_ptr(uint8_t level, size_t set, const char* arg) {
-    return arg && get_fmt_enabled(level, set);
+
+/**
+ * package the file directory and name, function name and line number info
+ *
+ * @param cur_len current log length
+ * @param dst destination
+ * @param set format set
+ * @param file file name
+ * @param func function name
+ * @param line line number
+ *
+ * @return packaged length
+ */
+static size_t output_location(size_t cur_len, char *dst, size_t set, const char *file,
+        const char *func, const long line) {
+    bool file_used = file && (set & ELOG_FMT_DIR);
+    bool func_used = func && (set & ELOG_FMT_FUNC);
+    bool line_used = line && (set & ELOG_FMT_LINE);
+    char line_num[ELOG_U32_STR_MAX_LEN + 1];
+    size_t len = 0;
+
+    if (!file_used && !func_used && !line_used) {
+        return 0;
+    }
+    len += elog_strcpy(cur_len + len, dst + len, "(");
+    /* package file info */
+    if (file_used) {
+        len += elog_strcpy(cur_len + len, dst + len, file);
+        if (func_used) {
+            len += elog_strcpy(cur_len + len, dst + len, ":");
+        } else if (line_used) {
+            len += elog_strcpy(cur_len + len, dst + len, " ");
+        }
+    }
+    /* package line info */
+    if (line_used) {
+        if (elog_u32toa(line_num, (uint32_t) line) > ELOG_LINE_NUM_MAX_LEN) {
+            line_num[ELOG_LINE_NUM_MAX_LEN] = '\0';
+        }
+        len += elog_strcpy(cur_len + len, dst + len, line_num);
+        if (func_used) {
+            len += elog_strcpy(cur_len + len, dst + len, " ");
+        }
+    }
+    /* package func info */
+    if (func_used) {
+        len += elog_strcpy(cur_len + len, dst + len, func);
+    }
+    len += elog_strcpy(cur_len + len, dst + len, ")");
+
+    return len;
 }
 
 /**
@@ -780,7 +1831,7 @@ void elog_assert_set_hook(void (*hook)(const char* expr, const char* func, size_
 
 /**
  * find the log level
- * @note make sure the log level is output on each format
+ * @note make sure the log level is output on each format, the sink can get it from the log record directly
  *
  * @param log log buffer
  *
@@ -854,6 +1905,44 @@ const char *elog_find_tag(const char *log, uint8_t lvl, size_t *tag_len) {
     return tag;
 }
 
+/**
+ * check the hex dump is passed output enabled, level and tag filter
+ *
+ * @param name name for hex object
+ *
+ * @return true: the hex dump should be output
+ */
+static bool hexdump_filter(const char *name) {
+    if (!elog.output_enabled) {
+        return false;
+    }
+    /* level filter */
+    if (ELOG_LVL_DEBUG > elog.filter.level) {
+        return false;
+    } else if (!strstr(name, elog.filter.tag)) { /* tag filter */
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * put the 16-bit number as 4 hex digits
+ *
+ * @param dst destination
+ * @param value number
+ *
+ * @return put length
+ */
+static size_t hex_put_u16(char *dst, uint16_t value) {
+    dst[0] = hex_digits[(value >> 12) & 0x0F];
+    dst[1] = hex_digits[(value >> 8) & 0x0F];
+    dst[2] = hex_digits[(value >> 4) & 0x0F];
+    dst[3] = hex_digits[value & 0x0F];
+
+    return 4;
+}
+
 /**
  * dump the hex format data to log
  *
@@ -867,71 +1956,189 @@ void elog_hexdump(const char *name, uint8_t width, const void *buf, uint16_t siz
 #define __is_print(ch)       ((unsigned int)((ch) - ' ') < 127u - ' ')
 
     uint16_t i, j;
-    uint16_t log_len = 0;
+    size_t log_len, head_len, name_len = strlen(name), newline_len = sizeof(ELOG_NEWLINE_SIGN) - 1;
     const uint8_t *buf_p = buf;
-    char dump_string[8] = {0};
-    int fmt_result;
+    uint8_t byte;
+    int ctx;
+    ElogRecord *record;
+    char *line_buf, *hex_p, *char_p;
 
-    if (!elog.output_enabled) {
+    if (!hexdump_filter(name)) {
         return;
     }
-
-    /* level filter */
-    if (ELOG_LVL_DEBUG > elog.filter.level) {
-        return;
-    } else if (!strstr(name, elog.filter.tag)) { /* tag filter */
+    /* the line is packaged without bound check, so the width is limited by the line buffer */
+    while (width && sizeof("D/HEX : 0000-0000: ") - 1 + name_len + width * 4 + width / 8 + 2
+            + newline_len > ELOG_LINE_BUF_SIZE) {
+        width--;
+    }
+    if (width == 0) {
         return;
     }
 
-    /* lock output */
-    elog_output_lock();
-
+    /* claim the buffer of current context */
+    if ((ctx = elog_ctx_claim(ELOG_LVL_DEBUG)) < 0) {
+        return;
+    }
+    line_buf = log_buf[ctx];
+    /* all lines of the dump are in one record */
+    record = record_init(ctx, ELOG_LVL_DEBUG, "HEX");
+
+    /* the constant header is packaged once */
+    memcpy(line_buf, "D/HEX ", 6);
+    memcpy(line_buf + 6, name, name_len);
+    head_len = 6 + name_len;
+    line_buf[head_len++] = ':';
+    line_buf[head_len++] = ' ';
     for (i = 0; i < size; i += width) {
-        /* package header */
-        fmt_result = snprintf(log_buf, ELOG_LINE_BUF_SIZE, "D/HEX %s: %04X-%04X: ", name, i, i + width - 1);
-        /* calculate log length */
-        if ((fmt_result > -1) && (fmt_result <= ELOG_LINE_BUF_SIZE)) {
-            log_len = fmt_result;
-        } else {
-            log_len = ELOG_LINE_BUF_SIZE;
-        }
-        /* dump hex */
+        /* package address range */
+        log_len = head_len;
+        log_len += hex_put_u16(line_buf + log_len, i);
+        line_buf[log_len++] = '-';
+        log_len += hex_put_u16(line_buf + log_len, i + width - 1);
+        line_buf[log_len++] = ':';
+        line_buf[log_len++] = ' ';
+        /* dump hex and char at the same time, the char column is after the hex column */
+        hex_p = line_buf + log_len;
+        char_p = hex_p + width * 3 + width / 8 + 2;
         for (j = 0; j < width; j++) {
             if (i + j < size) {
-                snprintf(dump_string, sizeof(dump_string), "%02X ", buf_p[i + j]);
+                byte = buf_p[i + j];
+                hex_p[0] = hex_digits[byte >> 4];
+                hex_p[1] = hex_digits[byte & 0x0F];
+                *char_p++ = __is_print(byte) ? (char) byte : '.';
             } else {
-                strncpy(dump_string, "   ", sizeof(dump_string));
-            }
-            log_len += elog_strcpy(log_len, log_buf + log_len, dump_string);
-            if ((j + 1) % 8 == 0) {
-                log_len += elog_strcpy(log_len, log_buf + log_len, " ");
+                hex_p[0] = ' ';
+                hex_p[1] = ' ';
             }
-        }
-        log_len += elog_strcpy(log_len, log_buf + log_len, "  ");
-        /* dump char for hex */
-        for (j = 0; j < width; j++) {
-            if (i + j < size) {
-                snprintf(dump_string, sizeof(dump_string), "%c", __is_print(buf_p[i + j]) ? buf_p[i + j] : '.');
-                log_len += elog_strcpy(log_len, log_buf + log_len, dump_string);
+            hex_p[2] = ' ';
+            hex_p += 3;
+            if ((j & 7) == 7) {
+                *hex_p++ = ' ';
             }
         }
-        /* overflow check and reserve some space for newline sign */
-        if (log_len + strlen(ELOG_NEWLINE_SIGN) > ELOG_LINE_BUF_SIZE) {
-            log_len = ELOG_LINE_BUF_SIZE - strlen(ELOG_NEWLINE_SIGN);
-        }
+        hex_p[0] = ' ';
+        hex_p[1] = ' ';
+        log_len = char_p - line_buf;
         /* package newline sign */
-        log_len += elog_strcpy(log_len, log_buf + log_len, ELOG_NEWLINE_SIGN);
+        memcpy(line_buf + log_len, ELOG_NEWLINE_SIGN, newline_len);
+        log_len += newline_len;
+        /* the payload is after the level and tag */
+        record_set_log(record, line_buf, log_len);
+        record->payload = 6;
+        record->payload_size = (uint16_t) (log_len - newline_len - 6);
+        do_output_wait(record);
+        /* lock output */
+        elog_output_lock();
         /* do log output */
-#if defined(ELOG_ASYNC_OUTPUT_ENABLE)
-        extern void elog_async_output(uint8_t level, const char *log, size_t size);
-        elog_async_output(ELOG_LVL_DEBUG, log_buf, log_len);
-#elif defined(ELOG_BUF_OUTPUT_ENABLE)
-        extern void elog_buf_output(const char *log, size_t size);
-        elog_buf_output(log_buf, log_len);
-#else
-        elog_port_output(log_buf, log_len);
-#endif
+        do_output(record);
+        /* unlock output */
+        elog_output_unlock();
     }
-    /* unlock output */
-    elog_output_unlock();
+
+    elog_ctx_release();
+}
+
+#ifdef ELOG_HEXDUMP_RAW_ENABLE
+/**
+ * Dump the raw data to the raw output channel without formatting, the host tool
+ * tools/elog_rawdump.py renders it. The data is split into chunks, every chunk is
+ * framed, all numbers are little endian:
+ * | 0xE9 | timestamp(4) | name size(1) | name | total size(4) | offset(4) | chunk size(2) | data |
+ * @note the chunk which has no space in the raw output channel is dropped with all
+ *       the chunks after it, the host finds it by the offset
+ *
+ * @param name name for raw object
+ * @param buf raw buffer
+ * @param size buffer size
+ *
+ * @return dumped size
+ */
+size_t elog_hexdump_raw(const char *name, const void *buf, size_t size)
+{
+    extern bool elog_port_raw_output(const void *head, size_t head_size, const void *data, size_t size);
+    size_t name_len = strlen(name), head_len, offset = 0, chunk;
+    uint64_t timestamp = elog_port_get_timestamp();
+    const uint8_t *buf_p = buf;
+    uint8_t *head;
+    int ctx;
+
+    if (!hexdump_filter(name)) {
+        return 0;
+    }
+    if (name_len > UINT8_MAX) {
+        name_len = UINT8_MAX;
+    }
+    /* claim the buffer of current context, the chunk head is packaged in it */
+    if ((ctx = elog_ctx_claim(ELOG_LVL_DEBUG)) < 0) {
+        return 0;
+    }
+    head = (uint8_t *) log_buf[ctx];
+    head[0] = RAW_FRAME;
+    head[1] = (uint8_t) timestamp;
+    head[2] = (uint8_t) (timestamp >> 8);
+    head[3] = (uint8_t) (timestamp >> 16);
+    head[4] = (uint8_t) (timestamp >> 24);
+    head[5] = (uint8_t) name_len;
+    memcpy(head + 6, name, name_len);
+    head_len = 6 + name_len;
+    head[head_len++] = (uint8_t) size;
+    head[head_len++] = (uint8_t) (size >> 8);
+    head[head_len++] = (uint8_t) (size >> 16);
+    head[head_len++] = (uint8_t) (size >> 24);
+
+    do {
+        chunk = size - offset;
+        if (chunk > RAW_CHUNK_SIZE) {
+            chunk = RAW_CHUNK_SIZE;
+        }
+        head[head_len + 0] = (uint8_t) offset;
+        head[head_len + 1] = (uint8_t) (offset >> 8);
+        head[head_len + 2] = (uint8_t) (offset >> 16);
+        head[head_len + 3] = (uint8_t) (offset >> 24);
+        head[head_len + 4] = (uint8_t) chunk;
+        head[head_len + 5] = (uint8_t) (chunk >> 8);
+        /* lock output */
+        elog_output_lock();
+        if (!elog_port_raw_output(head, head_len + 6, buf_p + offset, chunk)) {
+            elog_stat_drop(ELOG_STAGE_PORT, ELOG_LVL_DEBUG, size - offset);
+            elog_output_unlock();
+            break;
+        }
+        /* unlock output */
+        elog_output_unlock();
+        offset += chunk;
+    } while (offset < size);
+
+    elog_ctx_release();
+
+    return offset;
+}
+#endif /* ELOG_HEXDUMP_RAW_ENABLE */
+
+/**
+ * EasyLogger idle hook. It should be called in main loop or the lowest priority task.
+ * The deferred work of the enabled output mode will be done in it.
+ */
+void elog_idle(void) {
+#ifdef ELOG_DEFERRED_OUTPUT_ENABLE
+    elog_deferred_drain(ELOG_DEFERRED_DRAIN_MAX_NUM);
+#endif
+#if defined(ELOG_ASYNC_OUTPUT_ENABLE) && !defined(ELOG_ASYNC_OUTPUT_USING_PTHREAD)
+    /* the rest logs of the software interrupt drain are output here too */
+    elog_async_drain(ELOG_ASYNC_DRAIN_MAX_SIZE);
+#endif
+#ifdef ELOG_BUF_OUTPUT_ENABLE
+    elog_buf_poll();
+#endif
+#ifdef ELOG_DEDUP_ENABLE
+    elog_dedup_poll();
+#endif
+#ifdef ELOG_TRIG_ENABLE
+    elog_trig_drain(ELOG_TRIG_DRAIN_MAX_NUM);
+#endif
+#ifdef ELOG_SINK_ENABLE
+    elog_sink_drain(ELOG_SINK_DRAIN_MAX_SIZE);
+#endif
+    elog_ratelimit_poll();
+    elog_stat_poll();
 }
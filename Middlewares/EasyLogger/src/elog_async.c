@@ -47,14 +47,8 @@
 #define ELOG_ASYNC_OUTPUT_PTHREAD_PRIORITY       (sched_get_priority_max(SCHED_RR) - 1)
 #endif
 /* output thread poll get log buffer size  */
-#ifndef ELOG_ASYNC_LINE_OUTPUT
 #ifndef ELOG_ASYNC_POLL_GET_LOG_BUF_SIZE
-#define ELOG_ASYNC_POLL_GET_LOG_BUF_SIZE         (ELOG_ASYNC_OUTPUT_BUF_SIZE - 4)
-#endif
-#else
-#ifndef ELOG_ASYNC_POLL_GET_LOG_BUF_SIZE
-#define ELOG_ASYNC_POLL_GET_LOG_BUF_SIZE         (ELOG_LINE_BUF_SIZE - 4)
-#endif
+#define ELOG_ASYNC_POLL_GET_LOG_BUF_SIZE         ELOG_LINE_BUF_SIZE
 #endif
 #endif /* ELOG_ASYNC_OUTPUT_PTHREAD_STACK_SIZE */
 
@@ -62,6 +56,19 @@
 static sem_t output_notice;
 /* asynchronous output pthread thread */
 static pthread_t async_output_thread;
+#else
+/* max log size which is output in once bare-metal drain */
+#ifdef ELOG_ASYNC_DRAIN_MAX_SIZE
+#define DRAIN_MAX_SIZE                           ELOG_ASYNC_DRAIN_MAX_SIZE
+#else
+#define DRAIN_MAX_SIZE                           512
+#endif /* ELOG_ASYNC_DRAIN_MAX_SIZE */
+/* max time(us) of once bare-metal drain, 0: it is only limited by the size */
+#ifdef ELOG_ASYNC_DRAIN_MAX_TIME
+#define DRAIN_MAX_TIME                           ELOG_ASYNC_DRAIN_MAX_TIME
+#else
+#define DRAIN_MAX_TIME                           0
+#endif /* ELOG_ASYNC_DRAIN_MAX_TIME */
 #endif /* ELOG_ASYNC_OUTPUT_USING_PTHREAD */
 
 /* the highest output level for async mode, other level will sync output */
@@ -75,9 +82,107 @@ static pthread_t async_output_thread;
 #ifdef ELOG_ASYNC_OUTPUT_BUF_SIZE
 #define OUTPUT_BUF_SIZE                          ELOG_ASYNC_OUTPUT_BUF_SIZE
 #else
-#define OUTPUT_BUF_SIZE                          (ELOG_LINE_BUF_SIZE * 10)
+#define OUTPUT_BUF_SIZE                          (ELOG_LINE_BUF_SIZE * 8)
 #endif /* ELOG_ASYNC_OUTPUT_BUF_SIZE */
 
+#if (OUTPUT_BUF_SIZE & (OUTPUT_BUF_SIZE - 1)) != 0 || OUTPUT_BUF_SIZE < 64
+    #error "Asynchronous output buffer size must be power of 2 and not less than 64 (in elog_cfg.h)"
+#endif
+
+/* overflow policy when the buffer is full */
+#ifdef ELOG_ASYNC_OVERFLOW_POLICY
+#define OVERFLOW_POLICY                          ELOG_ASYNC_OVERFLOW_POLICY
+#else
+#define OVERFLOW_POLICY                          ELOG_OVERFLOW_DROP_NEWEST
+#endif /* ELOG_ASYNC_OVERFLOW_POLICY */
+
+/* max wait time(ms) of the output thread for block policy */
+#ifdef ELOG_ASYNC_BLOCK_TIMEOUT
+#define BLOCK_TIMEOUT                            ELOG_ASYNC_BLOCK_TIMEOUT
+#else
+#define BLOCK_TIMEOUT                            10
+#endif /* ELOG_ASYNC_BLOCK_TIMEOUT */
+
+/* the queued log which level is greater than or equal to it is evicted first by priority policy */
+#ifdef ELOG_ASYNC_EVICT_LVL
+#define EVICT_LVL                                ELOG_ASYNC_EVICT_LVL
+#else
+#define EVICT_LVL                                ELOG_LVL_DEBUG
+#endif /* ELOG_ASYNC_EVICT_LVL */
+
+/* the log which level is less than or equal to it is output first when there is a backlog */
+#ifdef ELOG_ASYNC_URGENT_LVL
+#define URGENT_LVL                               ELOG_ASYNC_URGENT_LVL
+#else
+#define URGENT_LVL                               ELOG_LVL_WARN
+#endif /* ELOG_ASYNC_URGENT_LVL */
+
+/* backlog watermark, percent of the buffer size, 0: the log is always output in order */
+#ifdef ELOG_ASYNC_BACKLOG_WATERMARK
+#define BACKLOG_SIZE                             (OUTPUT_BUF_SIZE / 100 * ELOG_ASYNC_BACKLOG_WATERMARK)
+#else
+#define BACKLOG_SIZE                             0
+#endif /* ELOG_ASYNC_BACKLOG_WATERMARK */
+
+#if OVERFLOW_POLICY < ELOG_OVERFLOW_DROP_NEWEST || OVERFLOW_POLICY > ELOG_OVERFLOW_PRIORITY
+    #error "Asynchronous output overflow policy is unknown (in elog_cfg.h)"
+#endif
+
+/* max queued records which are checked or marked in once output locked */
+#ifdef ELOG_ASYNC_SCAN_MAX_NUM
+#define SCAN_MAX_NUM                             ELOG_ASYNC_SCAN_MAX_NUM
+#else
+#define SCAN_MAX_NUM                             8
+#endif /* ELOG_ASYNC_SCAN_MAX_NUM */
+
+#if SCAN_MAX_NUM < 1
+    #error "Asynchronous output scan max number must be greater than 0 (in elog_cfg.h)"
+#endif
+
+/* the producer evicts the queued records, so the consumer must check them before releasing */
+#if OVERFLOW_POLICY == ELOG_OVERFLOW_DROP_OLDEST || OVERFLOW_POLICY == ELOG_OVERFLOW_PRIORITY
+#define RING_EVICT_ENABLE
+#endif
+
+/* the record is aligned by the head size, so the head is never split by the buffer end */
+#define RECORD_ALIGN_SIZE                        sizeof(RecordHead)
+#define RECORD_ALIGN(size)                       (((size) + RECORD_ALIGN_SIZE - 1) & ~(RECORD_ALIGN_SIZE - 1))
+/* the level of the skipped record: the pad of buffer end, the evicted or urgently output record */
+#define RECORD_SKIP_LVL                          0xFF
+
+/*
+ * Barriers of the lock-free ring. The side which moves it's index releases the record
+ * access before, the other side acquires the record access after reading the index.
+ * The single core Cortex-M only needs the compiler barrier, the host port such as
+ * pthread may run the producer and consumer on different cores, it needs the fence.
+ */
+#if defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M') && (defined(__GNUC__) || defined(__clang__))
+#define RING_RELEASE()                           __asm volatile ("" ::: "memory")
+#define RING_ACQUIRE()                           __asm volatile ("" ::: "memory")
+#elif defined(__CC_ARM)
+#define RING_RELEASE()                           __schedule_barrier()
+#define RING_ACQUIRE()                           __schedule_barrier()
+#elif defined(__GNUC__) || defined(__clang__)
+#define RING_RELEASE()                           __atomic_thread_fence(__ATOMIC_RELEASE)
+#define RING_ACQUIRE()                           __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define RING_RELEASE()                           atomic_thread_fence(memory_order_release)
+#define RING_ACQUIRE()                           atomic_thread_fence(memory_order_acquire)
+#else
+#error "The ring barrier is not supported by this compiler"
+#endif
+
+/*
+ * head of the record in the ring buffer, the log follows it. The record is never split
+ * by the buffer end, the end space is skipped by a pad record.
+ */
+typedef struct {
+    uint16_t size;
+    uint8_t level;
+    uint8_t reserved;
+} RecordHead;
+
 /* Initialize OK flag */
 static bool init_ok = false;
 #ifdef ELOG_ASYNC_OUTPUT_USING_PTHREAD
@@ -86,201 +191,451 @@ static bool thread_running = false;
 #endif
 /* asynchronous output mode enabled flag */
 static bool is_enabled = false;
-/* asynchronous output mode's ring buffer */
-static char log_buf[OUTPUT_BUF_SIZE] = { 0 };
-/* log ring buffer write index */
-static size_t write_index = 0;
-/* log ring buffer read index */
-static size_t read_index = 0;
-/* log ring buffer full flag */
-static bool buf_is_full = false;
-/* log ring buffer empty flag */
-static bool buf_is_empty = true;
-
-extern void elog_port_output(const char *log, size_t size);
+/*
+ * asynchronous output mode's record ring buffer. It is lock-free for one producer
+ * and one consumer, the producers are serialized by output lock, and the consumer
+ * (thread or drain) only moves the read index. The consumer only takes the lock to
+ * mark the urgently output records, or to release the records when the producer
+ * can evict them.
+ */
+static uint32_t log_buf[OUTPUT_BUF_SIZE / sizeof(uint32_t)];
+/* log ring buffer write and read index, they are free running */
+static volatile size_t write_index = 0;
+static volatile size_t read_index = 0;
+/* it is increased when the producer evicts the queued records */
+static volatile uint32_t evict_gen = 0;
+#if OVERFLOW_POLICY == ELOG_OVERFLOW_PRIORITY
+/* the next record to check by priority eviction, it is only changed in output locked */
+static size_t evict_index = 0;
+#endif
+#ifndef ELOG_ASYNC_OUTPUT_USING_PTHREAD
+/* the logs which are got by bare-metal drain */
+static char drain_buf[ELOG_LINE_BUF_SIZE];
+/* bare-metal drain is running, it is not reentrant */
+static bool is_draining = false;
+#endif
+
+extern size_t elog_port_output(const char *log, size_t size);
 extern void elog_output_lock(void);
 extern void elog_output_unlock(void);
 
 /**
- * asynchronous output ring buffer used size
+ * get the record head in ring buffer
+ *
+ * @param index free running index
  *
- * @return used size
+ * @return record head
  */
-static size_t elog_async_get_buf_used(void) {
-    if (write_index > read_index) {
-        return write_index - read_index;
-    } else {
-        if (!buf_is_full && !buf_is_empty) {
-            return OUTPUT_BUF_SIZE - (read_index - write_index);
-        } else if (buf_is_full) {
-            return OUTPUT_BUF_SIZE;
-        } else {
-            return 0;
-        }
-    }
+static RecordHead *async_get_head(size_t index) {
+    return (RecordHead *) ((uint8_t *) log_buf + (index & (OUTPUT_BUF_SIZE - 1)));
 }
 
 /**
- * asynchronous output ring buffer remain space
+ * get the buffer size which is needed to put the log, including the pad of buffer end
+ *
+ * @param size log size
  *
- * @return remain space
+ * @return needed buffer size
  */
-static size_t async_get_buf_space(void) {
-    return OUTPUT_BUF_SIZE - elog_async_get_buf_used();
+static size_t async_get_put_size(size_t size) {
+    size_t offset = write_index & (OUTPUT_BUF_SIZE - 1), record_size = RECORD_ALIGN(sizeof(RecordHead) + size);
+
+    /* the record which will be split by the buffer end is put at the buffer start */
+    if (offset + record_size > OUTPUT_BUF_SIZE) {
+        return OUTPUT_BUF_SIZE - offset + record_size;
+    }
+    return record_size;
 }
 
 /**
- * put log to asynchronous output ring buffer
+ * check the ring buffer has space for the log
  *
- * @param log put log buffer
  * @param size log size
  *
- * @return put log size, the log which beyond ring buffer space will be dropped
+ * @return true: has space
  */
-static size_t async_put_log(const char *log, size_t size) {
-    size_t space = 0;
-
-    space = async_get_buf_space();
-    /* no space */
-    if (!space) {
-        size = 0;
-        goto __exit;
+static bool async_has_space(size_t size) {
+    return write_index - read_index + async_get_put_size(size) <= OUTPUT_BUF_SIZE;
+}
+
+#if OVERFLOW_POLICY == ELOG_OVERFLOW_DROP_OLDEST
+/**
+ * evict the oldest record, the skipped record is released only
+ * @note it is called in output locked
+ *
+ * @return true: evicted, false: the ring buffer is empty
+ */
+static bool async_evict_oldest(void) {
+    RecordHead *head;
+
+    if (read_index == write_index) {
+        return false;
     }
-    /* drop some log */
-    if (space <= size) {
-        size = space;
-        buf_is_full = true;
+    head = async_get_head(read_index);
+    if (head->level != RECORD_SKIP_LVL) {
+        elog_stat_drop(ELOG_STAGE_ASYNC, head->level, head->size);
     }
+    read_index += RECORD_ALIGN(sizeof(RecordHead) + head->size);
+    evict_gen++;
 
-    if (write_index + size < OUTPUT_BUF_SIZE) {
-        memcpy(log_buf + write_index, log, size);
-        write_index += size;
-    } else {
-        memcpy(log_buf + write_index, log, OUTPUT_BUF_SIZE - write_index);
-        memcpy(log_buf, log + OUTPUT_BUF_SIZE - write_index,
-                size - (OUTPUT_BUF_SIZE - write_index));
-        write_index += size - OUTPUT_BUF_SIZE;
+    return true;
+}
+#elif OVERFLOW_POLICY == ELOG_OVERFLOW_PRIORITY
+/**
+ * Evict the queued records to get space for the log. The records are only marked as
+ * skipped, the space is released when they are at the oldest side, or they are passed
+ * by the consumer without output. The verbose and debug (ELOG_ASYNC_EVICT_LVL) records
+ * are evicted first, then the other records which are less important than the log. At
+ * most ELOG_ASYNC_SCAN_MAX_NUM records are checked in once call, the next call goes on
+ * from the last checked record, so the interrupt disabled time is bounded.
+ * @note it is called in output locked
+ *
+ * @param level log level
+ * @param size log size
+ *
+ * @return true: the ring buffer has space for the log
+ */
+static bool async_evict_priority(uint8_t level, size_t size) {
+    uint8_t min_level = EVICT_LVL > level ? EVICT_LVL : level + 1;
+    size_t num;
+    RecordHead *head;
+
+    for (num = 0; num < SCAN_MAX_NUM && !async_has_space(size); num++) {
+        /* release the skipped record at the oldest side */
+        head = async_get_head(read_index);
+        if (read_index != write_index && head->level == RECORD_SKIP_LVL) {
+            read_index += RECORD_ALIGN(sizeof(RecordHead) + head->size);
+            evict_gen++;
+            continue;
+        }
+        /* the checked records may be output by the consumer */
+        if (evict_index - read_index > write_index - read_index) {
+            evict_index = read_index;
+        }
+        /* all records are checked, then the records which are less important than the log are evicted too */
+        if (evict_index == write_index) {
+            if (min_level == level + 1) {
+                break;
+            }
+            min_level = level + 1;
+            evict_index = read_index;
+            continue;
+        }
+        head = async_get_head(evict_index);
+        if (head->level != RECORD_SKIP_LVL && head->level >= min_level) {
+            elog_stat_drop(ELOG_STAGE_ASYNC, head->level, head->size);
+            head->level = RECORD_SKIP_LVL;
+            evict_gen++;
+        }
+        evict_index += RECORD_ALIGN(sizeof(RecordHead) + head->size);
     }
 
-    buf_is_empty = false;
+    return async_has_space(size);
+}
+#endif /* OVERFLOW_POLICY == ELOG_OVERFLOW_DROP_OLDEST */
 
-__exit:
+/**
+ * Wait the ring buffer has space for the log by block policy. The bare-metal producer
+ * outputs the oldest logs by itself, the output thread is waited until timeout. It does
+ * nothing for other policies.
+ * @note it is called without output locked, so the drain can output the logs. The space
+ *       may be taken by the preempting log before locked, then the log is dropped.
+ *
+ * @param level log level
+ * @param size log size
+ */
+void elog_async_wait_space(uint8_t level, size_t size) {
+#if OVERFLOW_POLICY == ELOG_OVERFLOW_BLOCK
+#ifdef ELOG_ASYNC_OUTPUT_USING_PTHREAD
+    extern uint64_t elog_port_get_timestamp(void);
+    extern void elog_async_output_notice(void);
+    uint64_t start;
+#endif
 
-    return size;
+    if (!is_enabled || level < OUTPUT_LVL || async_has_space(size)) {
+        return;
+    }
+#ifdef ELOG_ASYNC_OUTPUT_USING_PTHREAD
+    start = elog_port_get_timestamp();
+    while (!async_has_space(size)) {
+        if (elog_port_get_timestamp() - start >= (uint64_t) BLOCK_TIMEOUT * ELOG_TIMESTAMP_PER_MS) {
+            break;
+        }
+        elog_async_output_notice();
+        sched_yield();
+    }
+#else
+    /* the drain which is preempted by the producer can't go on, the log may be dropped */
+    while (!async_has_space(size)) {
+        if (elog_async_drain(size) == 0) {
+            break;
+        }
+    }
+#endif
+#else
+    (void) level;
+    (void) size;
+#endif /* OVERFLOW_POLICY == ELOG_OVERFLOW_BLOCK */
 }
 
-#ifdef ELOG_ASYNC_LINE_OUTPUT
 /**
- * Get line log from asynchronous output ring buffer.
- * It will copy all log when the newline sign isn't find.
+ * put log to asynchronous output ring buffer as a record, the overflow policy is applied
+ * when there is no space
+ * @note it is called in output locked
  *
- * @param log get line log buffer
- * @param size line log size
+ * @param level log level
+ * @param log put log buffer
+ * @param size log size
  *
- * @return get line log size, the log size is less than ring buffer used size
+ * @return put log size, 0: there is no space, the whole log is dropped
  */
-size_t elog_async_get_line_log(char *log, size_t size) {
-    size_t used = 0, cpy_log_size = 0;
-    /* lock output */
-    elog_output_lock();
-    used = elog_async_get_buf_used();
+static size_t async_put_log(uint8_t level, const char *log, size_t size) {
+    size_t index, offset, record_size = RECORD_ALIGN(sizeof(RecordHead) + size);
+#if OVERFLOW_POLICY == ELOG_OVERFLOW_DROP_OLDEST
+    size_t num;
+#endif
+    RecordHead *head;
 
-    /* no log */
-    if (!used || !size) {
-        goto __exit;
-    }
-    /* less log */
-    if (used <= size) {
-        size = used;
+    if (size > UINT16_MAX || record_size > OUTPUT_BUF_SIZE) {
+        return 0;
     }
-
-    if (read_index + size < OUTPUT_BUF_SIZE) {
-        cpy_log_size = elog_cpyln(log, log_buf + read_index, size);
-        read_index += cpy_log_size;
-    } else {
-        cpy_log_size = elog_cpyln(log, log_buf + read_index, OUTPUT_BUF_SIZE - read_index);
-        if (cpy_log_size == OUTPUT_BUF_SIZE - read_index) {
-            cpy_log_size += elog_cpyln(log + cpy_log_size, log_buf, size - cpy_log_size);
-            read_index += cpy_log_size - OUTPUT_BUF_SIZE;
-        } else {
-            read_index += cpy_log_size;
+    if (!async_has_space(size)) {
+        /* the eviction is bounded, the block policy has waited before locked */
+#if OVERFLOW_POLICY == ELOG_OVERFLOW_DROP_OLDEST
+        for (num = 0; num < SCAN_MAX_NUM && !async_has_space(size) && async_evict_oldest(); num++);
+#elif OVERFLOW_POLICY == ELOG_OVERFLOW_PRIORITY
+        async_evict_priority(level, size);
+#endif
+        if (!async_has_space(size)) {
+            return 0;
         }
     }
-
-    if (used == cpy_log_size) {
-        buf_is_empty = true;
+    /* the released space is written after the consumer has read it */
+    RING_ACQUIRE();
+
+    index = write_index;
+    offset = index & (OUTPUT_BUF_SIZE - 1);
+    if (offset + record_size > OUTPUT_BUF_SIZE) {
+        head = async_get_head(index);
+        head->size = (uint16_t) (OUTPUT_BUF_SIZE - offset - sizeof(RecordHead));
+        head->level = RECORD_SKIP_LVL;
+        index += OUTPUT_BUF_SIZE - offset;
     }
+    head = async_get_head(index);
+    head->size = (uint16_t) size;
+    head->level = level;
+    memcpy(head + 1, log, size);
+    /* publish the record to the consumer */
+    RING_RELEASE();
+    write_index = index + record_size;
 
-    if (cpy_log_size) {
-        buf_is_full = false;
+    return size;
+}
+
+/**
+ * Get the record size in ring buffer by it's head. The consumer walks the records without
+ * output locked, the head may be changed by the evicting producer, the size which steps
+ * over the got end or the buffer end is rejected before it is used.
+ *
+ * @param index free running index of the record
+ * @param end the write index before getting the records
+ * @param log_size log size in the record head
+ *
+ * @return record size with the head and align, 0: the head is changed by eviction
+ */
+static size_t async_get_record_size(size_t index, size_t end, size_t log_size) {
+    size_t record_size = RECORD_ALIGN(sizeof(RecordHead) + log_size);
+
+    if (record_size > end - index || (index & (OUTPUT_BUF_SIZE - 1)) + record_size > OUTPUT_BUF_SIZE) {
+        return 0;
     }
+    return record_size;
+}
+
+/**
+ * release the got records to the producers
+ *
+ * @param index the read index after the got records
+ * @param gen the evict generation before getting the records
+ *
+ * @return true: released, false: the records are evicted when they are got, they must be got again
+ */
+static bool async_release(size_t index, uint32_t gen) {
+#ifdef RING_EVICT_ENABLE
+    bool released;
 
-__exit:
-    /* lock output */
+    elog_output_lock();
+    released = gen == evict_gen;
+    if (released) {
+        read_index = index;
+    }
     elog_output_unlock();
-    return cpy_log_size;
-}
+
+    return released;
 #else
+    /* the record is read before it's space is released to the producer */
+    RING_RELEASE();
+    read_index = index;
+
+    return true;
+#endif /* RING_EVICT_ENABLE */
+}
+
+#if BACKLOG_SIZE > 0
 /**
- * get log from asynchronous output ring buffer
+ * Get the urgent (ELOG_ASYNC_URGENT_LVL) records from all queued records, they are marked
+ * as skipped, so they are output before the older less important records. At most
+ * ELOG_ASYNC_SCAN_MAX_NUM records are got, so the marking time in output locked is bounded.
  *
  * @param log get log buffer
- * @param size log size
+ * @param size log buffer size
+ * @param max_size max log size to get, no more record is got after it is reached
  *
- * @return get log size, the log size is less than ring buffer used size
+ * @return get log size, 0: there is no urgent record
  */
-size_t elog_async_get_log(char *log, size_t size) {
-    size_t used = 0;
-    /* lock output */
-    elog_output_lock();
-    used = elog_async_get_buf_used();
-    /* no log */
-    if (!used || !size) {
-        size = 0;
-        goto __exit;
-    }
-    /* less log */
-    if (used <= size) {
-        size = used;
-        buf_is_empty = true;
-    }
+static size_t async_get_urgent(char *log, size_t size, size_t max_size) {
+    size_t urgent[SCAN_MAX_NUM], start, index, end, get_size, log_size, record_size, num, i;
+    uint32_t gen;
+    bool marked;
+    RecordHead *head;
+
+    do {
+        gen = evict_gen;
+        start = index = read_index;
+        end = write_index;
+        get_size = 0;
+        num = 0;
+        RING_ACQUIRE();
+        /* the walk is bounded by the got end, the evicted records are got again */
+        for (; index - start < end - start && get_size < max_size && num < SCAN_MAX_NUM; index += record_size) {
+            head = async_get_head(index);
+            log_size = head->size;
+            if ((record_size = async_get_record_size(index, end, log_size)) == 0) {
+                break;
+            }
+            if (head->level <= URGENT_LVL) {
+                if (get_size + log_size > size) {
+                    break;
+                }
+                memcpy(log + get_size, head + 1, log_size);
+                get_size += log_size;
+                urgent[num++] = index;
+            }
+        }
+        if (!num) {
+            return 0;
+        }
+        /* mark the got records when they are not evicted, the producer only evicts in output locked */
+        elog_output_lock();
+        marked = gen == evict_gen;
+        for (i = 0; marked && i < num; i++) {
+            async_get_head(urgent[i])->level = RECORD_SKIP_LVL;
+        }
+        elog_output_unlock();
+    } while (!marked);
 
-    if (read_index + size < OUTPUT_BUF_SIZE) {
-        memcpy(log, log_buf + read_index, size);
-        read_index += size;
-    } else {
-        memcpy(log, log_buf + read_index, OUTPUT_BUF_SIZE - read_index);
-        memcpy(log + OUTPUT_BUF_SIZE - read_index, log_buf,
-                size - (OUTPUT_BUF_SIZE - read_index));
-        read_index += size - OUTPUT_BUF_SIZE;
+    return get_size;
+}
+#endif /* BACKLOG_SIZE > 0 */
+
+/**
+ * Get the records from asynchronous output ring buffer, the contiguous records are
+ * copied together, so they can be output in one call. The urgent records are got
+ * first when there is a backlog.
+ * @note it must be called by the only consumer, such as the output thread or drain
+ *
+ * @param log get log buffer
+ * @param size log buffer size, it should not be less than ELOG_LINE_BUF_SIZE
+ * @param max_size max log size to get, no more record is got after it is reached
+ *
+ * @return get log size, the records are whole except the first one which is
+ *         bigger than buffer size, it is truncated
+ */
+static size_t async_get_records(char *log, size_t size, size_t max_size) {
+    size_t start, index, end, get_size, log_size, record_size, cpy_size;
+    uint32_t gen;
+    const RecordHead *head;
+
+#if BACKLOG_SIZE > 0
+    if (write_index - read_index >= BACKLOG_SIZE && (get_size = async_get_urgent(log, size, max_size)) > 0) {
+        return get_size;
     }
+#endif
 
-    buf_is_full = false;
+    do {
+        gen = evict_gen;
+        start = index = read_index;
+        end = write_index;
+        get_size = 0;
+        RING_ACQUIRE();
+        /* the walk is bounded by the got end, the evicted records are got again after release fails */
+        while (index - start < end - start && get_size < max_size) {
+            head = async_get_head(index);
+            log_size = head->size;
+            if ((record_size = async_get_record_size(index, end, log_size)) == 0) {
+                break;
+            }
+            if (head->level != RECORD_SKIP_LVL) {
+                cpy_size = log_size;
+                if (get_size + cpy_size > size) {
+                    if (get_size) {
+                        break;
+                    }
+                    cpy_size = size;
+                }
+                memcpy(log + get_size, head + 1, cpy_size);
+                get_size += cpy_size;
+            }
+            index += record_size;
+        }
+    } while (!async_release(index, gen));
 
-__exit:
-    /* lock output */
-    elog_output_unlock();
-    return size;
+    return get_size;
+}
+
+/**
+ * Get one line log from asynchronous output ring buffer.
+ * @note it must be called by the only consumer, such as the output thread
+ *
+ * @param log get line log buffer
+ * @param size line log buffer size
+ *
+ * @return get line log size, 0: there is no log
+ */
+size_t elog_async_get_line_log(char *log, size_t size) {
+    return async_get_records(log, size, 1);
+}
+
+/**
+ * Get logs from asynchronous output ring buffer, only the whole lines are got.
+ * @note it must be called by the only consumer, such as the output thread
+ *
+ * @param log get log buffer
+ * @param size log buffer size
+ *
+ * @return get log size, 0: there is no log
+ */
+size_t elog_async_get_log(char *log, size_t size) {
+    return async_get_records(log, size, SIZE_MAX);
 }
-#endif /* ELOG_ASYNC_LINE_OUTPUT */
 
 void elog_async_output(uint8_t level, const char *log, size_t size) {
-    /* this function must be implement by user when ELOG_ASYNC_OUTPUT_USING_PTHREAD is not defined */
     extern void elog_async_output_notice(void);
     size_t put_size;
 
     if (is_enabled) {
         if (level >= OUTPUT_LVL) {
-            put_size = async_put_log(log, size);
+            put_size = async_put_log(level, log, size);
+            elog_stat_put(ELOG_STAGE_ASYNC, level, size, put_size);
             /* notify output log thread */
             if (put_size > 0) {
                 elog_async_output_notice();
             }
         } else {
-            elog_port_output(log, size);
+            elog_stat_put(ELOG_STAGE_PORT, level, size, elog_port_output(log, size));
         }
     } else {
-        elog_port_output(log, size);
+        elog_stat_put(ELOG_STAGE_PORT, level, size, elog_port_output(log, size));
     }
 }
 
@@ -299,14 +654,12 @@ static void *async_output(void *arg) {
         /* polling gets and outputs the log */
         while(true) {
 
-#ifdef ELOG_ASYNC_LINE_OUTPUT
-            get_log_size = elog_async_get_line_log(poll_get_buf, ELOG_ASYNC_POLL_GET_LOG_BUF_SIZE);
-#else
             get_log_size = elog_async_get_log(poll_get_buf, ELOG_ASYNC_POLL_GET_LOG_BUF_SIZE);
-#endif
 
             if (get_log_size) {
-                elog_port_output(poll_get_buf, get_log_size);
+                /* the logs in the ring have no level */
+                elog_stat_put(ELOG_STAGE_ASYNC, ELOG_STAT_LVL_NONE, get_log_size,
+                        elog_port_output(poll_get_buf, get_log_size));
             } else {
                 break;
             }
@@ -314,7 +667,95 @@ static void *async_output(void *arg) {
     }
     return NULL;
 }
+#else
+void elog_async_output_notice(void) {
+#ifdef ELOG_ASYNC_DRAIN_USING_SWI
+    /* this function must be implement by port, it pends the software interrupt which calls elog_async_drain() */
+    extern void elog_port_async_notice(void);
+    elog_port_async_notice();
+#endif
+}
+
+/**
+ * Output the logs in asynchronous ring buffer without thread. It runs in elog_idle(),
+ * or in the low priority software interrupt when ELOG_ASYNC_DRAIN_USING_SWI is defined.
+ * The work of once drain is limited by size and ELOG_ASYNC_DRAIN_MAX_TIME, the rest
+ * logs are output by the next drain.
+ * @note it is not reentrant, the drain which preempts another drain returns directly
+ *
+ * @param max_size max log size to output, at least one log is output
+ *
+ * @return output log size
+ */
+size_t elog_async_drain(size_t max_size) {
+    extern uint64_t elog_port_get_timestamp(void);
+    size_t get_log_size, out_size = 0;
+#if DRAIN_MAX_TIME > 0
+    uint64_t start = elog_port_get_timestamp();
+#endif
+
+    elog_output_lock();
+    if (is_draining) {
+        elog_output_unlock();
+        return 0;
+    }
+    is_draining = true;
+    elog_output_unlock();
+
+    while (out_size < max_size) {
+#if DRAIN_MAX_TIME > 0
+        if (out_size && elog_port_get_timestamp() - start >= (uint64_t) DRAIN_MAX_TIME * ELOG_TIMESTAMP_PER_MS / 1000) {
+            break;
+        }
+#endif
+
+        /* the contiguous records are output in one call */
+        get_log_size = async_get_records(drain_buf, sizeof(drain_buf), max_size - out_size);
+        if (!get_log_size) {
+            break;
+        }
+        /* the logs in the ring have no level */
+        elog_stat_put(ELOG_STAGE_ASYNC, ELOG_STAT_LVL_NONE, get_log_size,
+                elog_port_output(drain_buf, get_log_size));
+        out_size += get_log_size;
+    }
+
+    is_draining = false;
+
+    return out_size;
+}
+#endif /* ELOG_ASYNC_OUTPUT_USING_PTHREAD */
+
+/**
+ * Wait all logs in asynchronous ring buffer are output, it is used for orderly
+ * shutdown, such as before reset or entering low power mode. The bare-metal
+ * drain is called directly.
+ * @note it must not be called in the drain software interrupt or a higher priority ISR
+ *
+ * @param timeout max wait time(ms)
+ *
+ * @return true: all logs are output, false: timeout
+ */
+bool elog_async_flush(uint32_t timeout) {
+    extern uint64_t elog_port_get_timestamp(void);
+    uint64_t start = elog_port_get_timestamp();
+    bool is_empty;
+
+    while (true) {
+        is_empty = write_index == read_index;
+        if (is_empty || elog_port_get_timestamp() - start >= (uint64_t) timeout * ELOG_TIMESTAMP_PER_MS) {
+            break;
+        }
+#ifdef ELOG_ASYNC_OUTPUT_USING_PTHREAD
+        elog_async_output_notice();
+        sched_yield();
+#else
+        elog_async_drain(DRAIN_MAX_SIZE);
 #endif
+    }
+
+    return is_empty;
+}
 
 /**
  * enable or disable asynchronous output mode
@@ -0,0 +1,221 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Logs binary output. The constant call site is output by it's ID,
+ *           the log text is rebuilt by tools/elog_decode.py with the ELF file.
+ * Created on: 2026-10-17
+ */
+
+#include <elog.h>
+#include <string.h>
+
+#ifdef ELOG_BIN_OUTPUT_ENABLE
+
+/* frame buffer size */
+#ifdef ELOG_BIN_FRAME_BUF_SIZE
+#define FRAME_BUF_SIZE                           ELOG_BIN_FRAME_BUF_SIZE
+#else
+#define FRAME_BUF_SIZE                           128
+#endif /* ELOG_BIN_FRAME_BUF_SIZE */
+
+/*
+ * frame format, all numbers are little endian:
+ * site frame:      | 0xE5 | site ID(2) | seq(2) | timestamp(4) | word num(1) | string size(1) | words | strings |
+ * text frame:      | 0xE6 | text size(2) | text |
+ * site text frame: | 0xE7 | site ID(2) | seq(2) | timestamp(4) | text size(2) | text |
+ * key-value frame: | 0xE8 | site ID(2) | seq(2) | timestamp(4) | fields size(2) | fields encoded by elog_kv_encode() |
+ * the site ID is the word offset of the site in the site section, the seq and timestamp are
+ * the low 16-bit sequence number and the low 32-bit of elog_port_get_timestamp(), the decoder
+ * unwraps them
+ */
+#define FRAME_SITE                               0xE5
+#define FRAME_TEXT                               0xE6
+#define FRAME_SITE_TEXT                          0xE7
+#define FRAME_KV                                 0xE8
+#define FRAME_SITE_HEAD_SIZE                     9
+#define FRAME_TEXT_HEAD_SIZE                     3
+
+/* key-value frame buffer of every nested context */
+static uint8_t frame_buf[ELOG_CTX_MAX_NUM][FRAME_BUF_SIZE];
+/* the site text which is formatted from the captured arguments, it is used in output locked */
+static char text_buf[FRAME_BUF_SIZE];
+
+extern size_t elog_port_output(const char *log, size_t size);
+extern bool elog_port_output_reserve(size_t size, ElogSpan *span);
+extern void elog_port_output_commit(size_t size);
+extern void elog_output_lock(void);
+extern void elog_output_unlock(void);
+
+/**
+ * put the site frame head to frame buffer
+ *
+ * @param frame frame buffer
+ * @param type frame type
+ * @param site_id log call site ID
+ * @param seq sequence number of the log
+ * @param timestamp timestamp of the log
+ *
+ * @return head size
+ */
+static size_t put_site_head(uint8_t *frame, uint8_t type, uint16_t site_id, uint32_t seq, uint64_t timestamp) {
+    frame[0] = type;
+    frame[1] = (uint8_t) site_id;
+    frame[2] = (uint8_t) (site_id >> 8);
+    frame[3] = (uint8_t) seq;
+    frame[4] = (uint8_t) (seq >> 8);
+    frame[5] = (uint8_t) timestamp;
+    frame[6] = (uint8_t) (timestamp >> 8);
+    frame[7] = (uint8_t) (timestamp >> 16);
+    frame[8] = (uint8_t) (timestamp >> 24);
+
+    return FRAME_SITE_HEAD_SIZE;
+}
+
+/**
+ * output the frame head and data to port, they are published together
+ *
+ * @param head frame head
+ * @param head_len frame head size
+ * @param data first frame data
+ * @param size first frame data size
+ * @param data2 second frame data
+ * @param size2 second frame data size
+ *
+ * @return frame size, 0: there is no space, it is dropped
+ */
+static size_t output_frame(const uint8_t *head, size_t head_len, const void *data, size_t size,
+        const void *data2, size_t size2) {
+    ElogSpan span;
+    size_t frame_len;
+
+    if (!elog_port_output_reserve(head_len + size + size2, &span)) {
+        return 0;
+    }
+    frame_len = elog_span_write(&span, 0, head, head_len);
+    frame_len = elog_span_write(&span, frame_len, data, size);
+    frame_len = elog_span_write(&span, frame_len, data2, size2);
+    elog_port_output_commit(frame_len);
+
+    return frame_len;
+}
+
+/**
+ * Output the log record in binary, it is the port sink output in binary output mode.
+ * The site log which arguments are captured by the site format is output in a site
+ * frame, the format and other constant info are not output. The site log which is
+ * packaged, or it's format is changed such as the deferred log, is output in a site
+ * text frame. Other logs are output in a text frame.
+ * @note it is called in output locked
+ * @note the arguments words are copied in CPU byte order, it is little endian for Cortex-M
+ *
+ * @param record log record
+ *
+ * @return output frame size, 0: there is no space, it is dropped
+ */
+size_t elog_bin_output_record(const ElogRecord *record) {
+    uint8_t head[FRAME_SITE_HEAD_SIZE + 2];
+    const ElogArgs *args = record->args;
+    const char *text = text_buf;
+    size_t head_len, text_len;
+    int fmt_result;
+
+    if (record->site_id == ELOG_SITE_ID_NONE) {
+        /* the log which is not output by a call site is always packaged */
+        if (record->log == NULL) {
+            return 0;
+        }
+        text_len = record->size < UINT16_MAX ? record->size : UINT16_MAX;
+        head[0] = FRAME_TEXT;
+        head[1] = (uint8_t) text_len;
+        head[2] = (uint8_t) (text_len >> 8);
+        return output_frame(head, FRAME_TEXT_HEAD_SIZE, record->log, text_len, record->log, 0);
+    }
+
+    if (record->log == NULL && args && record->format == elog_site_get(record->site_id)->format) {
+        head_len = put_site_head(head, FRAME_SITE, record->site_id, record->seq, record->timestamp);
+        head[head_len++] = args->arg_num;
+        head[head_len++] = args->str_len;
+        return output_frame(head, head_len, args->arg, args->arg_num * sizeof(uint32_t), args->str, args->str_len);
+    }
+
+    /* the site text frame only has the payload, the decoder rebuilds the log head by the site */
+    if (record->log) {
+        text = record->log + record->payload;
+        text_len = record->payload_size;
+    } else if (args) {
+        fmt_result = elog_args_format(text_buf, sizeof(text_buf), record->format, args);
+        if ((fmt_result > -1) && (fmt_result < (int) sizeof(text_buf))) {
+            text_len = fmt_result;
+        } else {
+            /* the text is truncated, the end sign is not output */
+            text_len = sizeof(text_buf) - 1;
+            elog_stat_trunc(ELOG_STAGE_CORE, record->level, fmt_result > -1 ? fmt_result - text_len : 0);
+        }
+    } else {
+        return 0;
+    }
+    head_len = put_site_head(head, FRAME_SITE_TEXT, record->site_id, record->seq, record->timestamp);
+    head[head_len++] = (uint8_t) text_len;
+    head[head_len++] = (uint8_t) (text_len >> 8);
+
+    return output_frame(head, head_len, text, text_len, text, 0);
+}
+
+/**
+ * output the key-value log in binary, the event name is the site format
+ * @note the output filter has been checked
+ *
+ * @param site log call site, it must be placed in the site section
+ * @param fields fields
+ * @param num field number
+ */
+void elog_bin_output_kv(const ElogSite *site, const ElogKvField *fields, size_t num) {
+    extern uint64_t elog_port_get_timestamp(void);
+    size_t frame_len, fields_len;
+    uint8_t *frame;
+    int ctx;
+
+    /* claim the buffer of current context, it is not locked when encoding */
+    if ((ctx = elog_ctx_claim((uint8_t) site->level)) < 0) {
+        return;
+    }
+    frame = frame_buf[ctx];
+    /* the key-value frame is output to port directly, it is not routed to the sinks */
+    frame_len = put_site_head(frame, FRAME_KV, elog_site_get_id(site), elog_seq_next(),
+            elog_port_get_timestamp()) + 2;
+    fields_len = elog_kv_encode(frame + frame_len, FRAME_BUF_SIZE - frame_len, fields, num);
+    frame[frame_len - 2] = (uint8_t) fields_len;
+    frame[frame_len - 1] = (uint8_t) (fields_len >> 8);
+    frame_len += fields_len;
+    /* lock output */
+    elog_output_lock();
+    elog_stat_put(ELOG_STAGE_PORT, (uint8_t) site->level, frame_len,
+            elog_port_output((const char *) frame, frame_len));
+    /* unlock output */
+    elog_output_unlock();
+
+    elog_ctx_release();
+}
+
+#endif /* ELOG_BIN_OUTPUT_ENABLE */
@@ -34,39 +34,80 @@
     #error "Please configure buffer size for buffered output mode (in elog_cfg.h)"
 #endif
 
+/* the buffered logs are flushed when the oldest one is older than it(ms), 0: disabled */
+#ifdef ELOG_BUF_FLUSH_AGE
+#define FLUSH_AGE                                ELOG_BUF_FLUSH_AGE
+#else
+#define FLUSH_AGE                                0
+#endif /* ELOG_BUF_FLUSH_AGE */
+
+/* the buffered logs are flushed when the used size reaches it, 0: disabled */
+#ifdef ELOG_BUF_FLUSH_WATERMARK
+#define FLUSH_WATERMARK_SIZE                     (ELOG_BUF_OUTPUT_BUF_SIZE / 100 * ELOG_BUF_FLUSH_WATERMARK)
+#else
+#define FLUSH_WATERMARK_SIZE                     0
+#endif /* ELOG_BUF_FLUSH_WATERMARK */
+
+/* the log which level is less than or equal to it flushes the buffered logs immediately */
+#ifdef ELOG_BUF_FLUSH_LVL
+#define FLUSH_LVL                                ELOG_BUF_FLUSH_LVL
+#else
+#define FLUSH_LVL                                ELOG_LVL_ASSERT
+#endif /* ELOG_BUF_FLUSH_LVL */
+
 /* buffered output mode's buffer */
 static char log_buf[ELOG_BUF_OUTPUT_BUF_SIZE] = { 0 };
 /* log buffer current write size */
 static size_t buf_write_size = 0;
+/* the time when the oldest buffered log is put */
+static uint64_t buf_first_time = 0;
 /* buffered output mode enabled flag */
 static bool is_enabled = false;
 
-extern void elog_port_output(const char *log, size_t size);
+extern size_t elog_port_output(const char *log, size_t size);
 extern void elog_output_lock(void);
 extern void elog_output_unlock(void);
 
 /**
- * output buffered logs when buffer is full
+ * output all buffered logs
+ * @note it is called in output locked
+ */
+static void buf_flush(void) {
+    /* output log, the buffered logs have no level */
+    elog_stat_put(ELOG_STAGE_BUF, ELOG_STAT_LVL_NONE, buf_write_size, elog_port_output(log_buf, buf_write_size));
+    /* reset write index */
+    buf_write_size = 0;
+}
+
+/**
+ * output buffered logs when buffer is full, or the log level reaches ELOG_BUF_FLUSH_LVL
  *
+ * @param level level
  * @param log will be buffered line's log
  * @param size log size
  */
-void elog_buf_output(const char *log, size_t size) {
+void elog_buf_output(uint8_t level, const char *log, size_t size) {
+    extern uint64_t elog_port_get_timestamp(void);
     size_t write_size = 0, write_index = 0;
 
     if (!is_enabled) {
-        elog_port_output(log, size);
+        elog_stat_put(ELOG_STAGE_PORT, level, size, elog_port_output(log, size));
         return;
     }
 
     while (true) {
+        /* the age of buffered logs starts from the oldest one */
+        if (buf_write_size == 0 && size) {
+            buf_first_time = elog_port_get_timestamp();
+        }
         if (buf_write_size + size > ELOG_BUF_OUTPUT_BUF_SIZE) {
             write_size = ELOG_BUF_OUTPUT_BUF_SIZE - buf_write_size;
             memcpy(log_buf + buf_write_size, log + write_index, write_size);
             write_index += write_size;
             size -= write_size;
-            /* output log */
-            elog_port_output(log_buf, ELOG_BUF_OUTPUT_BUF_SIZE);
+            /* output log, the buffered logs have no level */
+            elog_stat_put(ELOG_STAGE_BUF, ELOG_STAT_LVL_NONE, ELOG_BUF_OUTPUT_BUF_SIZE,
+                    elog_port_output(log_buf, ELOG_BUF_OUTPUT_BUF_SIZE));
             /* reset write index */
             buf_write_size = 0;
         } else {
@@ -75,6 +116,11 @@ void elog_buf_output(const char *log, size_t size) {
             break;
         }
     }
+
+    /* the important log is not delayed */
+    if (level <= FLUSH_LVL && buf_write_size) {
+        buf_flush();
+    }
 }
 
 /**
@@ -85,10 +131,34 @@ void elog_flush(void) {
         return;
     /* lock output */
     elog_output_lock();
-    /* output log */
-    elog_port_output(log_buf, buf_write_size);
-    /* reset write index */
-    buf_write_size = 0;
+    if (buf_write_size) {
+        buf_flush();
+    }
+    /* unlock output */
+    elog_output_unlock();
+}
+
+/**
+ * Flush the buffered logs when the oldest one is older than ELOG_BUF_FLUSH_AGE, or the
+ * used size reaches ELOG_BUF_FLUSH_WATERMARK. It should be called in idle time, such as
+ * elog_idle(), so the logs are still output in batch, but they are never delayed too long.
+ */
+void elog_buf_poll(void) {
+    extern uint64_t elog_port_get_timestamp(void);
+    bool is_flush = false;
+
+    /* lock output */
+    elog_output_lock();
+#if FLUSH_WATERMARK_SIZE > 0
+    is_flush = buf_write_size >= FLUSH_WATERMARK_SIZE;
+#endif
+#if FLUSH_AGE > 0
+    is_flush = is_flush || (buf_write_size && elog_port_get_timestamp() - buf_first_time >=
+            (uint64_t) FLUSH_AGE * ELOG_TIMESTAMP_PER_MS);
+#endif
+    if (is_flush) {
+        buf_flush();
+    }
     /* unlock output */
     elog_output_unlock();
 }
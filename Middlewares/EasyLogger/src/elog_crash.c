@@ -0,0 +1,364 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Crash recorder. The last logs and the fault context are kept in the
+ *           retained RAM, so they are output in the next boot after the crash.
+ * Created on: 2026-10-17
+ */
+
+#include <elog.h>
+#include <string.h>
+
+#ifdef ELOG_CRASH_ENABLE
+
+/* the section of the retained RAM which is not initialized at reset */
+#ifdef ELOG_CRASH_SECTION
+#define CRASH_SECTION                            ELOG_CRASH_SECTION
+#else
+#define CRASH_SECTION                            ".bss.noinit"
+#endif /* ELOG_CRASH_SECTION */
+
+/* retained log buffer size */
+#ifdef ELOG_CRASH_BUF_SIZE
+#define CRASH_BUF_SIZE                           ELOG_CRASH_BUF_SIZE
+#else
+#define CRASH_BUF_SIZE                           960
+#endif /* ELOG_CRASH_BUF_SIZE */
+
+/* max kept size of every log */
+#ifdef ELOG_CRASH_LOG_MAX_SIZE
+#define LOG_MAX_SIZE                             ELOG_CRASH_LOG_MAX_SIZE
+#else
+#define LOG_MAX_SIZE                             128
+#endif /* ELOG_CRASH_LOG_MAX_SIZE */
+
+#if CRASH_BUF_SIZE % 4 != 0 || CRASH_BUF_SIZE >= 0x8000
+    #error "Crash recorder buffer size must be multiple of 4 and less than 32K (in elog_cfg.h)"
+#endif
+
+#if (LOG_MAX_SIZE + 4) * 2 > CRASH_BUF_SIZE
+    #error "Crash recorder log max size must be less than half of the buffer size (in elog_cfg.h)"
+#endif
+
+/* it is changed when the layout of the retained RAM is changed */
+#define CRASH_MAGIC                              0x454C4331
+/* the record size is the pad of buffer end */
+#define RECORD_PAD_FLAG                          0x8000
+#define RECORD_ALIGN(size)                       (((size) + 3) & ~3)
+/* the oldest record offset and the used size are packed in one word */
+#define SPAN_PACK(read, used)                    (((uint32_t) (read) << 16) | (uint32_t) (used))
+#define SPAN_READ(span)                          ((span) >> 16)
+#define SPAN_USED(span)                          ((span) & 0xFFFF)
+
+/* head of the record in the retained buffer, the log follows it */
+typedef struct {
+    /* log size, RECORD_PAD_FLAG is set when it is the pad of buffer end */
+    uint16_t size;
+    /* CRC of the size and log */
+    uint16_t crc;
+} RecordHead;
+
+/*
+ * The retained RAM. The records never split by the buffer end, the oldest records are
+ * overwritten by the new one. The span is updated by one store before and after writing
+ * the record, so it is always valid when the writer is broken by the fault.
+ */
+typedef struct {
+    uint32_t magic;
+    volatile uint32_t span;
+    ElogCrashFault fault;
+    uint32_t buf[CRASH_BUF_SIZE / sizeof(uint32_t)];
+} CrashRam;
+
+static CrashRam crash_ram __attribute__((section(CRASH_SECTION)));
+/* the retained RAM is checked and ready to write */
+static bool init_ok = false;
+
+extern size_t elog_port_output(const char *log, size_t size);
+
+/**
+ * CRC-16/CCITT by half byte table, it is small and has no division
+ *
+ * @param crc initial value
+ * @param data data
+ * @param size data size
+ *
+ * @return CRC value
+ */
+static uint16_t crash_crc16(uint16_t crc, const void *data, size_t size) {
+    static const uint16_t table[16] = {
+            0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+            0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    };
+    const uint8_t *p = data;
+
+    while (size--) {
+        crc = (uint16_t) ((crc << 4) ^ table[(crc >> 12) ^ (*p >> 4)]);
+        crc = (uint16_t) ((crc << 4) ^ table[(crc >> 12) ^ (*p & 0x0F)]);
+        p++;
+    }
+
+    return crc;
+}
+
+/**
+ * get the record head in retained buffer
+ *
+ * @param offset record offset
+ *
+ * @return record head
+ */
+static RecordHead *crash_get_head(size_t offset) {
+    return (RecordHead *) ((uint8_t *) crash_ram.buf + offset);
+}
+
+/**
+ * get the buffer size of the record
+ *
+ * @param head record head
+ *
+ * @return record size, including the head
+ */
+static size_t crash_get_record_size(const RecordHead *head) {
+    return RECORD_ALIGN(sizeof(RecordHead) + (head->size & ~RECORD_PAD_FLAG));
+}
+
+/**
+ * calculate the CRC of the record
+ *
+ * @param head record head, the log follows it
+ *
+ * @return CRC value
+ */
+static uint16_t crash_record_crc(const RecordHead *head) {
+    uint16_t crc = crash_crc16(0xFFFF, &head->size, sizeof(head->size));
+
+    if (head->size & RECORD_PAD_FLAG) {
+        return crc;
+    }
+    return crash_crc16(crc, head + 1, head->size);
+}
+
+/**
+ * calculate the CRC of the fault context
+ *
+ * @param fault fault context
+ *
+ * @return CRC value
+ */
+static uint32_t crash_fault_crc(const ElogCrashFault *fault) {
+    return crash_crc16(0xFFFF, fault, offsetof(ElogCrashFault, crc));
+}
+
+/**
+ * output the fault context of the retained crash record
+ *
+ * @param fault fault context
+ */
+static void crash_output_fault(const ElogCrashFault *fault) {
+    static const char * const type_name[] = {
+            [ELOG_CRASH_NONE]      = "reset",
+            [ELOG_CRASH_HARDFAULT] = "HardFault",
+            [ELOG_CRASH_NMI]       = "NMI",
+            [ELOG_CRASH_ASSERT]    = "assert",
+    };
+    char buf[160];
+    int len;
+
+    len = elog_snprintf(buf, sizeof(buf), "crash: %s r0=%08lx r1=%08lx r2=%08lx r3=%08lx r12=%08lx" ELOG_NEWLINE_SIGN,
+            fault->type <= ELOG_CRASH_ASSERT ? type_name[fault->type] : "unknown",
+            (unsigned long) fault->frame[0], (unsigned long) fault->frame[1],
+            (unsigned long) fault->frame[2], (unsigned long) fault->frame[3],
+            (unsigned long) fault->frame[4]);
+    elog_port_output(buf, len < (int) sizeof(buf) ? (size_t) len : sizeof(buf) - 1);
+    len = elog_snprintf(buf, sizeof(buf), "crash: lr=%08lx pc=%08lx xpsr=%08lx sp=%08lx %s=%lx" ELOG_NEWLINE_SIGN,
+            (unsigned long) fault->frame[5], (unsigned long) fault->frame[6],
+            (unsigned long) fault->frame[7], (unsigned long) fault->sp,
+            fault->type == ELOG_CRASH_ASSERT ? "line" : "exc_return", (unsigned long) fault->info);
+    elog_port_output(buf, len < (int) sizeof(buf) ? (size_t) len : sizeof(buf) - 1);
+}
+
+/**
+ * output the valid records of the retained crash record, from the oldest one
+ *
+ * @param span the oldest record offset and the used size
+ *
+ * @return output record number, the records after the broken one are dropped
+ */
+static size_t crash_output_records(uint32_t span) {
+    size_t offset = SPAN_READ(span), used = SPAN_USED(span), record_size, num = 0;
+    const RecordHead *head;
+
+    while (used) {
+        head = crash_get_head(offset);
+        record_size = crash_get_record_size(head);
+        if (record_size > used || offset + record_size > CRASH_BUF_SIZE || head->crc != crash_record_crc(head)) {
+            break;
+        }
+        if (!(head->size & RECORD_PAD_FLAG)) {
+            elog_port_output((const char *) (head + 1), head->size);
+            num++;
+        }
+        used -= record_size;
+        offset += record_size;
+        if (offset >= CRASH_BUF_SIZE) {
+            offset -= CRASH_BUF_SIZE;
+        }
+    }
+
+    return num;
+}
+
+/**
+ * Crash recorder initialize. The retained crash record of the last boot is checked,
+ * and it is output by port directly when it is valid, then the recorder is cleared
+ * for this boot. It should be called in port initialize before any log is output.
+ *
+ * @return result
+ */
+ElogErrCode elog_crash_init(void) {
+    uint32_t span = crash_ram.span;
+    bool has_fault, has_log;
+
+    if (init_ok) {
+        return ELOG_NO_ERR;
+    }
+
+    has_fault = crash_ram.magic == CRASH_MAGIC && crash_ram.fault.type != ELOG_CRASH_NONE
+            && crash_ram.fault.crc == crash_fault_crc(&crash_ram.fault);
+    has_log = crash_ram.magic == CRASH_MAGIC && SPAN_READ(span) < CRASH_BUF_SIZE && SPAN_USED(span) <= CRASH_BUF_SIZE
+            && SPAN_READ(span) % 4 == 0 && SPAN_USED(span) % 4 == 0 && SPAN_USED(span);
+    if (has_fault || has_log) {
+        elog_port_output("crash: ---- the record of last boot ----" ELOG_NEWLINE_SIGN,
+                sizeof("crash: ---- the record of last boot ----" ELOG_NEWLINE_SIGN) - 1);
+        if (has_log) {
+            crash_output_records(span);
+        }
+        if (has_fault) {
+            crash_output_fault(&crash_ram.fault);
+        }
+        elog_port_output("crash: ---- end ----" ELOG_NEWLINE_SIGN, sizeof("crash: ---- end ----" ELOG_NEWLINE_SIGN) - 1);
+    }
+
+    memset(&crash_ram.fault, 0, sizeof(crash_ram.fault));
+    crash_ram.span = SPAN_PACK(0, 0);
+    crash_ram.magic = CRASH_MAGIC;
+    init_ok = true;
+
+    return ELOG_NO_ERR;
+}
+
+/**
+ * Keep the log in the retained buffer, the oldest logs are overwritten when there
+ * is no space. The longer log is truncated by ELOG_CRASH_LOG_MAX_SIZE, it's newline
+ * sign is kept.
+ * @note it is called in output locked, such as by the crash sink
+ *
+ * @param log packaged log
+ * @param size log size
+ *
+ * @return kept size, 0: the recorder is not initialized
+ */
+size_t elog_crash_write(const char *log, size_t size) {
+    static const size_t newline_len = sizeof(ELOG_NEWLINE_SIGN) - 1;
+    uint32_t span = crash_ram.span;
+    size_t read = SPAN_READ(span), used = SPAN_USED(span), write, record_size, pad_size = 0;
+    RecordHead *head;
+
+    if (!init_ok || !log || !size) {
+        return 0;
+    }
+
+    if (size > LOG_MAX_SIZE) {
+        size = LOG_MAX_SIZE;
+    }
+    record_size = RECORD_ALIGN(sizeof(RecordHead) + size);
+    write = read + used;
+    if (write >= CRASH_BUF_SIZE) {
+        write -= CRASH_BUF_SIZE;
+    }
+    /* the record which will be split by the buffer end is written at the buffer start */
+    if (write + record_size > CRASH_BUF_SIZE) {
+        pad_size = CRASH_BUF_SIZE - write;
+    }
+    /* release the oldest records which will be overwritten */
+    if (used + pad_size + record_size > CRASH_BUF_SIZE) {
+        while (used + pad_size + record_size > CRASH_BUF_SIZE) {
+            head = crash_get_head(read);
+            used -= crash_get_record_size(head);
+            read += crash_get_record_size(head);
+            if (read >= CRASH_BUF_SIZE) {
+                read -= CRASH_BUF_SIZE;
+            }
+        }
+        crash_ram.span = SPAN_PACK(read, used);
+    }
+
+    if (pad_size) {
+        head = crash_get_head(write);
+        head->size = (uint16_t) ((pad_size - sizeof(RecordHead)) | RECORD_PAD_FLAG);
+        head->crc = crash_record_crc(head);
+        used += pad_size;
+        write = 0;
+    }
+    head = crash_get_head(write);
+    head->size = (uint16_t) size;
+    if (size < LOG_MAX_SIZE || size <= newline_len) {
+        memcpy(head + 1, log, size);
+    } else {
+        /* the truncated log keeps it's newline sign */
+        memcpy(head + 1, log, size - newline_len);
+        memcpy((char *) (head + 1) + size - newline_len, ELOG_NEWLINE_SIGN, newline_len);
+    }
+    head->crc = crash_record_crc(head);
+    crash_ram.span = SPAN_PACK(read, used + record_size);
+
+    return size;
+}
+
+/**
+ * Record the fault context. It only writes the retained RAM without lock, so it can be
+ * called in HardFault and NMI handler, even the fault is in the log output.
+ *
+ * @param type @see ElogCrashType
+ * @param frame stacked registers by exception: r0, r1, r2, r3, r12, lr, pc, xpsr, NULL: unknown
+ * @param sp SP before the exception
+ * @param info EXC_RETURN of the exception, or the line number of the assert
+ */
+void elog_crash_set_fault(uint8_t type, const uint32_t *frame, uint32_t sp, uint32_t info) {
+    ElogCrashFault *fault = &crash_ram.fault;
+    size_t i;
+
+    fault->type = type;
+    for (i = 0; i < sizeof(fault->frame) / sizeof(fault->frame[0]); i++) {
+        fault->frame[i] = frame ? frame[i] : 0;
+    }
+    fault->sp = sp;
+    fault->info = info;
+    fault->crc = crash_fault_crc(fault);
+    /* the logs are kept when the recorder is not initialized */
+    crash_ram.magic = CRASH_MAGIC;
+}
+
+#endif /* ELOG_CRASH_ENABLE */
@@ -0,0 +1,229 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Logs duplicate suppression. The consecutive same logs are counted,
+ *           then they are output as one repeated summary log.
+ * Created on: 2026-10-17
+ */
+
+#include <elog.h>
+#include <string.h>
+
+#ifdef ELOG_DEDUP_ENABLE
+
+/* the timeout(ms) to output the repeated summary when the log is not changed */
+#ifdef ELOG_DEDUP_TIMEOUT
+#define DEDUP_TIMEOUT                            ELOG_DEDUP_TIMEOUT
+#else
+#define DEDUP_TIMEOUT                            1000
+#endif /* ELOG_DEDUP_TIMEOUT */
+
+/* FNV-1a hash parameters */
+#define FNV_OFFSET_BASIS                         2166136261UL
+#define FNV_PRIME                                16777619UL
+
+/* the repeated summary format, it names the repeated log by the sequence number, because the
+ * summary is output after the changed log. The summary log is not checked by duplicate suppression */
+static const char repeat_format[] = "log #%u repeated %u times";
+
+/* the repeated summary of a log */
+typedef struct {
+    uint32_t num;
+    /* sequence number of the repeated log which is output */
+    uint32_t seq;
+    uint8_t level;
+    ElogTagId tag_id;
+    /* the tag is only copied when it has no tag ID, the caller's tag pointer is not kept */
+    char tag[ELOG_FILTER_TAG_MAX_LEN + 1];
+} RepeatInfo;
+
+/* the last output log's hash and size */
+static uint32_t last_hash = 0;
+static size_t last_size = 0;
+/* repeated info of the last log, the timestamp when it is first repeated */
+static RepeatInfo last_repeat = { 0 };
+static uint64_t repeat_first_time = 0;
+/* the repeated summary which waits to output after the log context buffer is released */
+static RepeatInfo pending_repeat = { 0 };
+
+extern void elog_output_lock(void);
+extern void elog_output_unlock(void);
+
+/**
+ * hash the data by FNV-1a
+ *
+ * @param hash current hash
+ * @param data data
+ * @param size data size
+ *
+ * @return new hash
+ */
+static uint32_t fnv_hash(uint32_t hash, const void *data, size_t size) {
+    const uint8_t *p = data;
+
+    while (size--) {
+        hash ^= *p++;
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/**
+ * Output the repeated summary. The record is on the stack, so the summary which is
+ * preempted by other context's summary is not changed.
+ *
+ * @param repeat repeated summary, it's tag is resolved by the tag ID now
+ */
+static void output_repeat(const RepeatInfo *repeat) {
+    extern uint64_t elog_port_get_timestamp(void);
+    ElogRecord record;
+
+    memset(&record, 0, sizeof(record));
+    /* the summary is output now, it's time and sequence number follow the changed log */
+    record.timestamp = elog_port_get_timestamp();
+    record.seq = ELOG_SEQ_NONE;
+    record.level = repeat->level;
+    record.tag_id = repeat->tag_id;
+    record.site_id = ELOG_SITE_ID_NONE;
+    if (repeat->tag_id != ELOG_TAG_ID_NONE) {
+        record.tag = elog_tag_get_name(repeat->tag_id);
+    } else {
+        record.tag = repeat->tag;
+    }
+    elog_output_record(&record, repeat_format, (unsigned int) repeat->seq, (unsigned int) repeat->num);
+}
+
+/**
+ * Check the packaged log is same as the last one. The same log is counted and not
+ * output. When the log is changed, the repeated summary of the last log is pending,
+ * it is output by elog_dedup_flush after the log context buffer is released, so it
+ * follows the changed log and names the repeated log by it's sequence number.
+ * @note the time info is not in the payload, so the log which only time is changed is same
+ *
+ * @param record log record, the changed log takes it's sequence number here
+ * @param format log format
+ * @param payload the log payload without log head
+ * @param size payload size
+ *
+ * @return true: the log is duplicate and it should not be output
+ */
+bool elog_dedup_check(ElogRecord *record, const char *format, const char *payload, size_t size) {
+    extern uint64_t elog_port_get_timestamp(void);
+    uint8_t level = record->level;
+    const char *tag = record->tag ? record->tag : "";
+    uint32_t hash;
+
+    if (format == repeat_format) {
+        return false;
+    }
+
+    hash = fnv_hash(FNV_OFFSET_BASIS, &level, sizeof(level));
+    hash = fnv_hash(hash, tag, strlen(tag));
+    hash = fnv_hash(hash, payload, size);
+
+    elog_output_lock();
+    if (hash == last_hash && size == last_size && level == last_repeat.level) {
+        if (last_repeat.num++ == 0) {
+            repeat_first_time = elog_port_get_timestamp();
+        }
+        elog_output_unlock();
+        return true;
+    }
+    /* the log is changed, the repeated summary of the last log will be output */
+    if (last_repeat.num) {
+        if (pending_repeat.num == 0) {
+            pending_repeat = last_repeat;
+        } else {
+            /* the pending summary is not output yet, such as preempted before flush */
+            elog_stat_drop(ELOG_STAGE_CORE, last_repeat.level, 0);
+        }
+    }
+    /* the changed log is output, it's sequence number is named by the repeated summary */
+    if (record->seq == ELOG_SEQ_NONE) {
+        record->seq = elog_seq_take();
+    }
+    last_hash = hash;
+    last_size = size;
+    last_repeat.num = 0;
+    last_repeat.seq = record->seq;
+    last_repeat.level = level;
+    last_repeat.tag_id = record->tag_id;
+    last_repeat.tag[0] = '\0';
+    if (record->tag_id == ELOG_TAG_ID_NONE) {
+        strncpy(last_repeat.tag, tag, ELOG_FILTER_TAG_MAX_LEN);
+        last_repeat.tag[ELOG_FILTER_TAG_MAX_LEN] = '\0';
+    }
+    elog_output_unlock();
+
+    return false;
+}
+
+/**
+ * Output the pending repeated summary. It must be called after the log context
+ * buffer is released, the summary output claims a context buffer again.
+ */
+void elog_dedup_flush(void) {
+    RepeatInfo repeat;
+
+    /* fast check without lock, the pending summary is rare */
+    if (pending_repeat.num == 0) {
+        return;
+    }
+    elog_output_lock();
+    repeat = pending_repeat;
+    pending_repeat.num = 0;
+    elog_output_unlock();
+
+    if (repeat.num) {
+        output_repeat(&repeat);
+    }
+}
+
+/**
+ * Output the repeated summary when the last log is repeated for timeout.
+ * It should be called in idle time, such as elog_idle().
+ */
+void elog_dedup_poll(void) {
+    extern uint64_t elog_port_get_timestamp(void);
+    RepeatInfo repeat;
+
+    elog_dedup_flush();
+
+    elog_output_lock();
+    repeat.num = 0;
+    if (last_repeat.num && elog_port_get_timestamp() - repeat_first_time >=
+            (uint64_t) DEDUP_TIMEOUT * ELOG_TIMESTAMP_PER_MS) {
+        /* the last log is kept, the next same log will be counted again */
+        repeat = last_repeat;
+        last_repeat.num = 0;
+    }
+    elog_output_unlock();
+
+    if (repeat.num) {
+        output_repeat(&repeat);
+    }
+}
+
+#endif /* ELOG_DEDUP_ENABLE */
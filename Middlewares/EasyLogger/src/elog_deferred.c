@@ -0,0 +1,187 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Logs deferred output. The log call only captures the raw arguments,
+ *           the formatting is done in elog_idle().
+ * Created on: 2026-10-17
+ */
+
+#include <elog.h>
+#include <string.h>
+
+#ifdef ELOG_DEFERRED_OUTPUT_ENABLE
+
+/* the highest output level for deferred mode, other level will sync output */
+#ifdef ELOG_DEFERRED_OUTPUT_LVL
+#define OUTPUT_LVL                               ELOG_DEFERRED_OUTPUT_LVL
+#else
+#define OUTPUT_LVL                               ELOG_LVL_ERROR
+#endif /* ELOG_DEFERRED_OUTPUT_LVL */
+
+/* record number of the deferred output ring */
+#ifdef ELOG_DEFERRED_RECORD_NUM
+#define RECORD_NUM                               ELOG_DEFERRED_RECORD_NUM
+#else
+#define RECORD_NUM                               16
+#endif /* ELOG_DEFERRED_RECORD_NUM */
+
+#if (RECORD_NUM & (RECORD_NUM - 1)) != 0
+    #error "Deferred output record number must be power of 2 (in elog_cfg.h)"
+#endif
+
+/* deferred log record */
+typedef struct {
+    /* the record has been filled completely */
+    volatile bool ready;
+    /* the format is NULL when the arguments can't be captured, the log was output directly */
+    ElogRecord record;
+    ElogArgs args;
+    /* the tag is copied when it is not interned, the caller's tag may be released before drain */
+    char tag[ELOG_FILTER_TAG_MAX_LEN + 1];
+} DeferredRecord;
+
+/* deferred output mode enabled flag */
+static bool is_enabled = false;
+/* deferred output mode's record ring */
+static DeferredRecord records[RECORD_NUM];
+/* record ring put index, it is free running and only changed in locked */
+static volatile size_t put_index = 0;
+/* record ring get index, it is free running and only changed by drain */
+static volatile size_t get_index = 0;
+/* dropped log number when the record ring is full */
+static size_t drop_num = 0;
+/* the message which is formatted by drain */
+static char msg_buf[ELOG_LINE_BUF_SIZE] = { 0 };
+
+extern void elog_output_lock(void);
+extern void elog_output_unlock(void);
+
+/**
+ * Put the log to deferred output ring. Only the record and raw arguments are
+ * copied, it is cheap enough for ISR and tight loop.
+ *
+ * @param record log record, it's file, function and format must be constant strings, the tag may be variable
+ * @param format output format, it must be a constant string
+ * @param args arguments, it may be used even if the log is not deferred
+ *
+ * @return true: the log is deferred or dropped, false: the log should output directly
+ */
+bool elog_deferred_output(const ElogRecord *record, const char *format, va_list *args) {
+    DeferredRecord *deferred;
+    bool result = true;
+
+    if (!is_enabled || record->level < OUTPUT_LVL) {
+        return false;
+    }
+
+    /* claim a record, the ISR which preempts here will claim the next one */
+    elog_output_lock();
+    if (put_index - get_index >= RECORD_NUM) {
+        drop_num++;
+        elog_stat_drop(ELOG_STAGE_DEFERRED, record->level, 0);
+        /* the deferred log takes it's sequence number when it is output, the lost one leaves a gap */
+        elog_seq_take();
+        elog_output_unlock();
+        return true;
+    }
+    deferred = &records[put_index & (RECORD_NUM - 1)];
+    put_index++;
+    elog_output_unlock();
+
+    deferred->record = *record;
+    /* the tag is resolved by it's ID when drain, the caller's tag pointer is not kept */
+    deferred->record.tag = NULL;
+    deferred->tag[0] = '\0';
+    if (record->tag_id == ELOG_TAG_ID_NONE && record->tag) {
+        strncpy(deferred->tag, record->tag, ELOG_FILTER_TAG_MAX_LEN);
+        deferred->tag[ELOG_FILTER_TAG_MAX_LEN] = '\0';
+    }
+    if (elog_args_capture(&deferred->args, format, args)) {
+        deferred->record.format = format;
+        deferred->record.args = &deferred->args;
+    } else {
+        /* too many arguments or too long strings, drain will skip this record */
+        deferred->record.format = NULL;
+        result = false;
+    }
+    deferred->ready = true;
+
+    return result;
+}
+
+/**
+ * Format and output the deferred logs. It should be called in idle time,
+ * such as elog_idle().
+ *
+ * @param max_num max log number to output, it limits the time of once drain
+ *
+ * @return output log number
+ */
+size_t elog_deferred_drain(size_t max_num) {
+    DeferredRecord *deferred;
+    size_t num = 0;
+
+    while (num < max_num && get_index != put_index) {
+        deferred = &records[get_index & (RECORD_NUM - 1)];
+        /* the record is still being filled, keep the output order */
+        if (!deferred->ready) {
+            break;
+        }
+        if (deferred->record.format) {
+            if (deferred->record.tag_id != ELOG_TAG_ID_NONE) {
+                deferred->record.tag = elog_tag_get_name(deferred->record.tag_id);
+            } else {
+                deferred->record.tag = deferred->tag;
+            }
+            elog_args_format(msg_buf, sizeof(msg_buf), deferred->record.format, &deferred->args);
+            elog_output_record(&deferred->record, "%s", msg_buf);
+            num++;
+        }
+        deferred->ready = false;
+        get_index++;
+    }
+
+    return num;
+}
+
+/**
+ * get the dropped log number when the deferred output ring is full
+ *
+ * @return dropped log number
+ */
+size_t elog_deferred_get_drop_num(void) {
+    return drop_num;
+}
+
+/**
+ * enable or disable deferred output mode
+ * the log will be output directly when mode is disabled
+ *
+ * @param enabled true: enabled, false: disabled
+ */
+void elog_deferred_enabled(bool enabled) {
+    is_enabled = enabled;
+}
+
+#endif /* ELOG_DEFERRED_OUTPUT_ENABLE */
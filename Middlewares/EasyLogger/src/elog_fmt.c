@@ -0,0 +1,1195 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Log formatter and arguments capture. The built-in formatter
+ *           converts the integer without division, it is fast on Cortex-M0+.
+ * Created on: 2026-10-17
+ */
+
+#include <elog.h>
+#include <string.h>
+#include <stdio.h>
+#include <float.h>
+
+/* max length of one conversion specification, such as "%-08.3lld" */
+#define FMT_SPEC_MAX_LEN                         24
+
+/* conversion specification flags */
+#define FMT_FLAG_LEFT                            (1 << 0)
+#define FMT_FLAG_PLUS                            (1 << 1)
+#define FMT_FLAG_SPACE                           (1 << 2)
+#define FMT_FLAG_ALT                             (1 << 3)
+#define FMT_FLAG_ZERO                            (1 << 4)
+
+/* the argument type which is consumed by one conversion specification */
+typedef enum {
+    ARG_TYPE_NONE,
+    ARG_TYPE_INT,
+    ARG_TYPE_LONG,
+    ARG_TYPE_LLONG,
+    ARG_TYPE_SIZE,
+    ARG_TYPE_PTR,
+    ARG_TYPE_DOUBLE,
+    ARG_TYPE_LDOUBLE,
+    ARG_TYPE_STR,
+    ARG_TYPE_COUNT,
+} ArgType;
+
+/* one parsed conversion specification */
+typedef struct {
+    const char *start;
+    size_t len;
+    bool width_star;
+    bool prec_star;
+    ArgType type;
+    uint8_t flags;
+    uint8_t h_num;
+    /* -1: width or precision is not used */
+    int width;
+    int prec;
+    char conv;
+} FmtSpec;
+
+#ifdef ELOG_BUILTIN_FMT_ENABLE
+
+/* float max precision */
+#ifdef ELOG_BUILTIN_FMT_FLOAT_MAX_PREC
+#define FLOAT_MAX_PREC                           ELOG_BUILTIN_FMT_FLOAT_MAX_PREC
+#else
+#define FLOAT_MAX_PREC                           6
+#endif /* ELOG_BUILTIN_FMT_FLOAT_MAX_PREC */
+
+#if FLOAT_MAX_PREC > 9
+    #error "Float max precision must be less than 10 (in elog_cfg.h)"
+#endif
+
+/* the widest integer which can be converted */
+#ifdef ELOG_BUILTIN_FMT_LLONG_ENABLE
+typedef unsigned long long FmtUint;
+typedef long long FmtInt;
+#else
+typedef uint32_t FmtUint;
+typedef int32_t FmtInt;
+#endif /* ELOG_BUILTIN_FMT_LLONG_ENABLE */
+
+/* the max digits number of the widest integer, it is octal 64-bit integer */
+#define INT_DIGITS_MAX_LEN                       22
+
+/* the arguments source of the formatter, they come from va_list or captured arguments */
+typedef struct {
+    va_list *args;
+    const ElogArgs *captured;
+    size_t index;
+} ArgSource;
+
+/* one fetched argument */
+typedef union {
+    int i;
+    long l;
+    long long ll;
+    size_t z;
+    void *p;
+    double d;
+    const char *s;
+} ArgValue;
+
+/* formatted output buffer, the output length is counted even if the buffer is full */
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+} FmtOut;
+
+static const char digits_lower[] = "0123456789abcdef";
+static const char digits_upper[] = "0123456789ABCDEF";
+
+#ifdef ELOG_BUILTIN_FMT_FLOAT_ENABLE
+static const uint32_t pow10_table[] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+#endif
+
+#endif /* ELOG_BUILTIN_FMT_ENABLE */
+
+/**
+ * parse one conversion specification of the format
+ *
+ * @param fmt it must point to the '%' sign
+ * @param spec parsed specification
+ *
+ * @return the position after this specification
+ */
+static const char *parse_fmt_spec(const char *fmt, FmtSpec *spec) {
+    const char *p = fmt + 1;
+    uint8_t l_num = 0;
+    bool size_used = false, ll_used = false, ldouble_used = false;
+
+    spec->start = fmt;
+    spec->width_star = false;
+    spec->prec_star = false;
+    spec->type = ARG_TYPE_NONE;
+    spec->flags = 0;
+    spec->h_num = 0;
+    spec->width = -1;
+    spec->prec = -1;
+    /* flags */
+    while (true) {
+        if (*p == '-') {
+            spec->flags |= FMT_FLAG_LEFT;
+        } else if (*p == '+') {
+            spec->flags |= FMT_FLAG_PLUS;
+        } else if (*p == ' ') {
+            spec->flags |= FMT_FLAG_SPACE;
+        } else if (*p == '#') {
+            spec->flags |= FMT_FLAG_ALT;
+        } else if (*p == '0') {
+            spec->flags |= FMT_FLAG_ZERO;
+        } else {
+            break;
+        }
+        p++;
+    }
+    /* width */
+    if (*p == '*') {
+        spec->width_star = true;
+        p++;
+    } else if (*p >= '0' && *p <= '9') {
+        spec->width = 0;
+        while (*p >= '0' && *p <= '9') {
+            spec->width = spec->width * 10 + (*p++ - '0');
+        }
+    }
+    /* precision */
+    if (*p == '.') {
+        p++;
+        spec->prec = 0;
+        if (*p == '*') {
+            spec->prec_star = true;
+            p++;
+        } else {
+            while (*p >= '0' && *p <= '9') {
+                spec->prec = spec->prec * 10 + (*p++ - '0');
+            }
+        }
+    }
+    /* length modifier, the char and short argument are promoted to int */
+    while (true) {
+        if (*p == 'l') {
+            l_num++;
+        } else if (*p == 'h') {
+            spec->h_num++;
+        } else if (*p == 'z' || *p == 't') {
+            size_used = true;
+        } else if (*p == 'j' || *p == 'q') {
+            ll_used = true;
+        } else if (*p == 'L') {
+            ldouble_used = true;
+        } else {
+            break;
+        }
+        p++;
+    }
+    /* conversion */
+    spec->conv = *p;
+    switch (*p) {
+    case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+        if (ll_used || l_num >= 2) {
+            spec->type = ARG_TYPE_LLONG;
+        } else if (l_num == 1) {
+            spec->type = ARG_TYPE_LONG;
+        } else if (size_used) {
+            spec->type = ARG_TYPE_SIZE;
+        } else {
+            spec->type = ARG_TYPE_INT;
+        }
+        break;
+    case 'c':
+        spec->type = ARG_TYPE_INT;
+        break;
+    case 'p':
+        spec->type = ARG_TYPE_PTR;
+        break;
+    case 's':
+        spec->type = ARG_TYPE_STR;
+        break;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        spec->type = ldouble_used ? ARG_TYPE_LDOUBLE : ARG_TYPE_DOUBLE;
+        break;
+    case 'n':
+        spec->type = ARG_TYPE_COUNT;
+        break;
+    default:
+        break;
+    }
+    if (*p != '\0') {
+        p++;
+    }
+    spec->len = p - fmt;
+
+    return p;
+}
+
+/**
+ * put some words into the captured arguments
+ *
+ * @param captured captured arguments
+ * @param value value address
+ * @param size value size, it will be rounded up to word
+ *
+ * @return false: there is no space for this value
+ */
+static bool args_put(ElogArgs *captured, const void *value, size_t size) {
+    size_t word_num = (size + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    if (captured->arg_num + word_num > ELOG_ARGS_MAX_NUM) {
+        return false;
+    }
+    memcpy(&captured->arg[captured->arg_num], value, size);
+    captured->arg_num += word_num;
+
+    return true;
+}
+
+/**
+ * get some words from the captured arguments
+ *
+ * @param captured captured arguments
+ * @param index current word index, it will be moved to the next argument
+ * @param value value address
+ * @param size value size, it will be rounded up to word
+ *
+ * @return false: all captured arguments are used
+ */
+static bool args_get(const ElogArgs *captured, size_t *index, void *value, size_t size) {
+    size_t word_num = (size + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    if (*index + word_num > captured->arg_num) {
+        return false;
+    }
+    memcpy(value, &captured->arg[*index], size);
+    *index += word_num;
+
+    return true;
+}
+
+/**
+ * Capture the raw arguments of a log call by it's format. The captured arguments
+ * can be formatted later by elog_args_format. The string(%s) argument content is
+ * copied, so the caller's string buffer can be released after this function.
+ *
+ * @param captured captured arguments
+ * @param format log format
+ * @param args arguments which are not used yet
+ *
+ * @return false: there are too many arguments or the strings are too long to capture,
+ *         the arguments are not usable and the log should be formatted directly
+ */
+bool elog_args_capture(ElogArgs *captured, const char *format, va_list *args) {
+    const char *p = format;
+    FmtSpec spec;
+    size_t str_len, str_space;
+    uint8_t str_offset;
+    const char *str;
+
+    assert(captured);
+    assert(format);
+
+    captured->arg_num = 0;
+    captured->str_len = 0;
+
+    while ((p = strchr(p, '%')) != NULL) {
+        p = parse_fmt_spec(p, &spec);
+        if (spec.width_star) {
+            int width = va_arg(*args, int);
+            if (!args_put(captured, &width, sizeof(width))) {
+                return false;
+            }
+        }
+        if (spec.prec_star) {
+            int prec = va_arg(*args, int);
+            if (!args_put(captured, &prec, sizeof(prec))) {
+                return false;
+            }
+        }
+        switch (spec.type) {
+        case ARG_TYPE_INT: {
+            int value = va_arg(*args, int);
+            if (!args_put(captured, &value, sizeof(value))) {
+                return false;
+            }
+            break;
+        }
+        case ARG_TYPE_LONG: {
+            long value = va_arg(*args, long);
+            if (!args_put(captured, &value, sizeof(value))) {
+                return false;
+            }
+            break;
+        }
+        case ARG_TYPE_LLONG: {
+            long long value = va_arg(*args, long long);
+            if (!args_put(captured, &value, sizeof(value))) {
+                return false;
+            }
+            break;
+        }
+        case ARG_TYPE_SIZE: {
+            size_t value = va_arg(*args, size_t);
+            if (!args_put(captured, &value, sizeof(value))) {
+                return false;
+            }
+            break;
+        }
+        case ARG_TYPE_PTR:
+        case ARG_TYPE_COUNT: {
+            void *value = va_arg(*args, void *);
+            if (spec.type == ARG_TYPE_PTR && !args_put(captured, &value, sizeof(value))) {
+                return false;
+            }
+            break;
+        }
+        case ARG_TYPE_DOUBLE:
+        case ARG_TYPE_LDOUBLE: {
+            double value;
+            if (spec.type == ARG_TYPE_LDOUBLE) {
+                value = (double) va_arg(*args, long double);
+            } else {
+                value = va_arg(*args, double);
+            }
+            if (!args_put(captured, &value, sizeof(value))) {
+                return false;
+            }
+            break;
+        }
+        case ARG_TYPE_STR: {
+            str = va_arg(*args, const char *);
+            if (str == NULL) {
+                str = "(null)";
+            }
+            /* the string which is not fit is never truncated, the log will be formatted directly */
+            str_space = ELOG_ARGS_STR_BUF_SIZE - captured->str_len;
+            str_len = strlen(str);
+            if (str_len + 1 > str_space) {
+                return false;
+            }
+            str_offset = captured->str_len;
+            memcpy(captured->str + str_offset, str, str_len);
+            captured->str[str_offset + str_len] = '\0';
+            captured->str_len += str_len + 1;
+            if (!args_put(captured, &str_offset, sizeof(str_offset))) {
+                return false;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    return true;
+}
+
+#ifdef ELOG_BUILTIN_FMT_ENABLE
+
+/**
+ * fetch the next argument from va_list or captured arguments
+ *
+ * @param src arguments source
+ * @param type argument type
+ * @param value fetched argument
+ *
+ * @return false: all captured arguments are used
+ */
+static bool arg_fetch(ArgSource *src, ArgType type, ArgValue *value) {
+    if (src->args) {
+        switch (type) {
+        case ARG_TYPE_INT:
+            value->i = va_arg(*src->args, int);
+            break;
+        case ARG_TYPE_LONG:
+            value->l = va_arg(*src->args, long);
+            break;
+        case ARG_TYPE_LLONG:
+            value->ll = va_arg(*src->args, long long);
+            break;
+        case ARG_TYPE_SIZE:
+            value->z = va_arg(*src->args, size_t);
+            break;
+        case ARG_TYPE_PTR:
+        case ARG_TYPE_COUNT:
+            value->p = va_arg(*src->args, void *);
+            break;
+        case ARG_TYPE_DOUBLE:
+            value->d = va_arg(*src->args, double);
+            break;
+        case ARG_TYPE_LDOUBLE:
+            value->d = (double) va_arg(*src->args, long double);
+            break;
+        case ARG_TYPE_STR:
+            value->s = va_arg(*src->args, const char *);
+            if (value->s == NULL) {
+                value->s = "(null)";
+            }
+            break;
+        default:
+            break;
+        }
+        return true;
+    }
+
+    switch (type) {
+    case ARG_TYPE_INT:
+        return args_get(src->captured, &src->index, &value->i, sizeof(value->i));
+    case ARG_TYPE_LONG:
+        return args_get(src->captured, &src->index, &value->l, sizeof(value->l));
+    case ARG_TYPE_LLONG:
+        return args_get(src->captured, &src->index, &value->ll, sizeof(value->ll));
+    case ARG_TYPE_SIZE:
+        return args_get(src->captured, &src->index, &value->z, sizeof(value->z));
+    case ARG_TYPE_PTR:
+        return args_get(src->captured, &src->index, &value->p, sizeof(value->p));
+    case ARG_TYPE_DOUBLE:
+    case ARG_TYPE_LDOUBLE:
+        return args_get(src->captured, &src->index, &value->d, sizeof(value->d));
+    case ARG_TYPE_STR: {
+        uint8_t str_offset;
+        if (!args_get(src->captured, &src->index, &str_offset, sizeof(str_offset))) {
+            return false;
+        }
+        value->s = src->captured->str + str_offset;
+        return true;
+    }
+    default:
+        /* the count argument is not captured */
+        return true;
+    }
+}
+
+/**
+ * output one char to the formatted buffer, the '\0' space is always reserved
+ *
+ * @param out formatted output buffer
+ * @param ch char
+ */
+static void out_char(FmtOut *out, char ch) {
+    if (out->len + 1 < out->size) {
+        out->buf[out->len] = ch;
+    }
+    out->len++;
+}
+
+/**
+ * output some same chars to the formatted buffer
+ *
+ * @param out formatted output buffer
+ * @param ch char
+ * @param num char number, nothing is output when it is not positive
+ */
+static void out_pad(FmtOut *out, char ch, int num) {
+    while (num-- > 0) {
+        out_char(out, ch);
+    }
+}
+
+/**
+ * output a string to the formatted buffer
+ *
+ * @param out formatted output buffer
+ * @param str string
+ * @param len string length
+ */
+static void out_str(FmtOut *out, const char *str, size_t len) {
+    while (len--) {
+        out_char(out, *str++);
+    }
+}
+
+#endif /* ELOG_BUILTIN_FMT_ENABLE */
+
+/**
+ * Divide the 32-bit number by 10 without division instruction. The Cortex-M0+
+ * has no divider, the software division is very slow.
+ *
+ * @param n dividend
+ * @param rem remainder
+ *
+ * @return quotient
+ */
+static uint32_t divu10(uint32_t n, uint32_t *rem) {
+    uint32_t q, r;
+
+    /* q = n * 0.8, then q / 8 is close to n / 10 */
+    q = (n >> 1) + (n >> 2);
+    q += q >> 4;
+    q += q >> 8;
+    q += q >> 16;
+    q >>= 3;
+    /* the estimated quotient is less than the real one at most 1 */
+    r = n - ((q << 3) + (q << 1));
+    if (r > 9) {
+        q++;
+        r -= 10;
+    }
+    *rem = r;
+
+    return q;
+}
+
+/**
+ * divide the 64-bit number by 10 without division instruction
+ *
+ * @param n dividend
+ * @param rem remainder
+ *
+ * @return quotient
+ */
+static unsigned long long divu10_64(unsigned long long n, uint32_t *rem) {
+    unsigned long long q, r;
+
+    q = (n >> 1) + (n >> 2);
+    q += q >> 4;
+    q += q >> 8;
+    q += q >> 16;
+    q += q >> 32;
+    q >>= 3;
+    r = n - ((q << 3) + (q << 1));
+    if (r > 9) {
+        q++;
+        r -= 10;
+    }
+    *rem = (uint32_t) r;
+
+    return q;
+}
+
+#ifdef ELOG_BUILTIN_FMT_ENABLE
+
+/**
+ * convert the unsigned integer to digits, the digits are put backward
+ *
+ * @param value unsigned integer
+ * @param base 8, 10 or 16
+ * @param digits digits table
+ * @param end the end of digits buffer
+ *
+ * @return digits number
+ */
+static size_t utoa(FmtUint value, uint8_t base, const char *digits, char *end) {
+    char *p = end;
+    uint32_t value32, rem;
+
+    if (base == 10) {
+#ifdef ELOG_BUILTIN_FMT_LLONG_ENABLE
+        /* the 64-bit division is slow, it is only used for the high digits */
+        while (value > UINT32_MAX) {
+            value = divu10_64(value, &rem);
+            *--p = (char) ('0' + rem);
+        }
+#endif
+        value32 = (uint32_t) value;
+        do {
+            value32 = divu10(value32, &rem);
+            *--p = (char) ('0' + rem);
+        } while (value32);
+    } else {
+        /* the base is power of 2 */
+        uint8_t shift = (base == 16) ? 4 : 3;
+        do {
+            *--p = digits[value & (base - 1)];
+            value >>= shift;
+        } while (value);
+    }
+
+    return end - p;
+}
+
+/**
+ * output the integer by conversion specification
+ *
+ * @param out formatted output buffer
+ * @param spec conversion specification
+ * @param value absolute value
+ * @param negative the value is negative
+ */
+static void format_int(FmtOut *out, const FmtSpec *spec, FmtUint value, bool negative) {
+    char digits_buf[INT_DIGITS_MAX_LEN], prefix[2];
+    const char *digits = digits_lower;
+    size_t digits_num = 0, prefix_len = 0;
+    uint8_t base = 10;
+    int zeros = 0, pad;
+
+    if (spec->conv == 'x' || spec->conv == 'p') {
+        base = 16;
+    } else if (spec->conv == 'X') {
+        base = 16;
+        digits = digits_upper;
+    } else if (spec->conv == 'o') {
+        base = 8;
+    }
+    /* "%.0d" outputs nothing for zero */
+    if (value != 0 || spec->prec != 0) {
+        digits_num = utoa(value, base, digits, digits_buf + sizeof(digits_buf));
+    }
+    if (spec->prec > (int) digits_num) {
+        zeros = spec->prec - (int) digits_num;
+    }
+    /* sign and prefix */
+    if (negative) {
+        prefix[prefix_len++] = '-';
+    } else if (spec->conv == 'd' || spec->conv == 'i') {
+        if (spec->flags & FMT_FLAG_PLUS) {
+            prefix[prefix_len++] = '+';
+        } else if (spec->flags & FMT_FLAG_SPACE) {
+            prefix[prefix_len++] = ' ';
+        }
+    }
+    if (spec->flags & FMT_FLAG_ALT) {
+        if (base == 16 && (value != 0 || spec->conv == 'p')) {
+            prefix[prefix_len++] = '0';
+            prefix[prefix_len++] = (spec->conv == 'X') ? 'X' : 'x';
+        } else if (base == 8 && zeros == 0 && (digits_num == 0 ||
+                digits_buf[sizeof(digits_buf) - digits_num] != '0')) {
+            zeros = 1;
+        }
+    }
+    pad = spec->width - (int) (prefix_len + zeros + digits_num);
+    /* the zero flag is ignored when precision is used */
+    if ((spec->flags & FMT_FLAG_ZERO) && !(spec->flags & FMT_FLAG_LEFT) && spec->prec < 0) {
+        zeros += pad > 0 ? pad : 0;
+        pad = 0;
+    }
+    if (!(spec->flags & FMT_FLAG_LEFT)) {
+        out_pad(out, ' ', pad);
+    }
+    out_str(out, prefix, prefix_len);
+    out_pad(out, '0', zeros);
+    out_str(out, digits_buf + sizeof(digits_buf) - digits_num, digits_num);
+    if (spec->flags & FMT_FLAG_LEFT) {
+        out_pad(out, ' ', pad);
+    }
+}
+
+/**
+ * output the signed integer by conversion specification
+ *
+ * @param out formatted output buffer
+ * @param spec conversion specification
+ * @param value signed value
+ */
+static void format_signed(FmtOut *out, const FmtSpec *spec, FmtInt value) {
+    if (value < 0) {
+        format_int(out, spec, (FmtUint) 0 - (FmtUint) value, true);
+    } else {
+        format_int(out, spec, (FmtUint) value, false);
+    }
+}
+
+/**
+ * output the string with width and precision
+ *
+ * @param out formatted output buffer
+ * @param spec conversion specification
+ * @param str string
+ */
+static void format_str(FmtOut *out, const FmtSpec *spec, const char *str) {
+    size_t len = 0;
+    int pad;
+
+    while (str[len] != '\0' && (spec->prec < 0 || len < (size_t) spec->prec)) {
+        len++;
+    }
+    pad = spec->width - (int) len;
+    if (!(spec->flags & FMT_FLAG_LEFT)) {
+        out_pad(out, ' ', pad);
+    }
+    out_str(out, str, len);
+    if (spec->flags & FMT_FLAG_LEFT) {
+        out_pad(out, ' ', pad);
+    }
+}
+
+#ifdef ELOG_BUILTIN_FMT_FLOAT_ENABLE
+/**
+ * Output the float in fixed-point format. All float conversions are output as "%f",
+ * the precision is limited by ELOG_BUILTIN_FMT_FLOAT_MAX_PREC.
+ *
+ * @param out formatted output buffer
+ * @param spec conversion specification
+ * @param value float value
+ */
+static void format_float(FmtOut *out, const FmtSpec *spec, double value) {
+    char digits_buf[INT_DIGITS_MAX_LEN + FLOAT_MAX_PREC + 1];
+    char *end = digits_buf + sizeof(digits_buf);
+    FmtSpec int_spec = *spec;
+    FmtUint int_part;
+    uint32_t frac_part, scale;
+    size_t frac_num;
+    bool negative = false;
+    int prec = spec->prec < 0 ? 6 : spec->prec;
+
+    if (prec > FLOAT_MAX_PREC) {
+        prec = FLOAT_MAX_PREC;
+    }
+    if (value < 0) {
+        negative = true;
+        value = -value;
+    }
+    /* NaN, infinite and the value which is out of integer range */
+    if (value != value || value >= (double) ((FmtUint) -1)) {
+        int_spec.prec = -1;
+        if (value != value) {
+            format_str(out, &int_spec, "nan");
+        } else if (value > DBL_MAX) {
+            format_str(out, &int_spec, negative ? "-inf" : "inf");
+        } else {
+            format_str(out, &int_spec, negative ? "-ovf" : "ovf");
+        }
+        return;
+    }
+    scale = pow10_table[prec];
+    int_part = (FmtUint) value;
+    frac_part = (uint32_t) ((value - (double) int_part) * scale + 0.5);
+    if (frac_part >= scale) {
+        frac_part -= scale;
+        int_part++;
+    }
+    /* fractional digits with leading zeros and decimal point */
+    frac_num = 0;
+    if (prec > 0 || (spec->flags & FMT_FLAG_ALT)) {
+        frac_num = utoa(frac_part, 10, digits_lower, end);
+        while (frac_num < (size_t) prec) {
+            end[-(int) ++frac_num] = '0';
+        }
+        if (prec == 0) {
+            frac_num = 0;
+        }
+        end[-(int) ++frac_num] = '.';
+    }
+    /* the integer part is output with the fractional part as suffix */
+    int_spec.conv = 'd';
+    int_spec.prec = -1;
+    int_spec.width = spec->width - (int) frac_num;
+    if (spec->flags & FMT_FLAG_LEFT) {
+        int_spec.width = 0;
+    }
+    format_int(out, &int_spec, int_part, negative);
+    out_str(out, end - frac_num, frac_num);
+    if (spec->flags & FMT_FLAG_LEFT) {
+        FmtOut count = { NULL, 0, 0 };
+        format_int(&count, &int_spec, int_part, negative);
+        out_pad(out, ' ', spec->width - (int) (count.len + frac_num));
+    }
+}
+#endif /* ELOG_BUILTIN_FMT_FLOAT_ENABLE */
+
+/**
+ * format the arguments from va_list or captured arguments
+ *
+ * @param buf output buffer
+ * @param size output buffer size
+ * @param format format
+ * @param src arguments source
+ *
+ * @return the length which would have been output if the buffer is large enough
+ */
+static int format_args(char *buf, size_t size, const char *format, ArgSource *src) {
+    FmtOut out = { buf, size, 0 };
+    const char *p = format;
+    FmtSpec spec;
+    ArgValue value;
+
+    while (*p != '\0') {
+        if (*p != '%') {
+            out_char(&out, *p++);
+            continue;
+        }
+        p = parse_fmt_spec(p, &spec);
+        if (spec.width_star) {
+            if (!arg_fetch(src, ARG_TYPE_INT, &value)) {
+                break;
+            }
+            spec.width = value.i;
+            if (spec.width < 0) {
+                spec.flags |= FMT_FLAG_LEFT;
+                spec.width = -spec.width;
+            }
+        }
+        if (spec.prec_star) {
+            if (!arg_fetch(src, ARG_TYPE_INT, &value)) {
+                break;
+            }
+            spec.prec = value.i < 0 ? -1 : value.i;
+        }
+        if (spec.type == ARG_TYPE_NONE) {
+            /* "%%" will output '%', the unknown specification will output as it is */
+            if (spec.conv == '%') {
+                out_char(&out, '%');
+            } else {
+                out_str(&out, spec.start, spec.len);
+            }
+            continue;
+        }
+        if (!arg_fetch(src, spec.type, &value)) {
+            break;
+        }
+        switch (spec.type) {
+        case ARG_TYPE_INT:
+            if (spec.conv == 'c') {
+                char ch = (char) value.i;
+                spec.prec = -1;
+                out_pad(&out, ' ', (spec.flags & FMT_FLAG_LEFT) ? 0 : spec.width - 1);
+                out_char(&out, ch);
+                out_pad(&out, ' ', (spec.flags & FMT_FLAG_LEFT) ? spec.width - 1 : 0);
+            } else if (spec.conv == 'd' || spec.conv == 'i') {
+                if (spec.h_num == 1) {
+                    value.i = (short) value.i;
+                } else if (spec.h_num >= 2) {
+                    value.i = (signed char) value.i;
+                }
+                format_signed(&out, &spec, value.i);
+            } else {
+                unsigned int u = (unsigned int) value.i;
+                if (spec.h_num == 1) {
+                    u = (unsigned short) u;
+                } else if (spec.h_num >= 2) {
+                    u = (unsigned char) u;
+                }
+                format_int(&out, &spec, u, false);
+            }
+            break;
+        case ARG_TYPE_LONG:
+            if (spec.conv == 'd' || spec.conv == 'i') {
+                format_signed(&out, &spec, (FmtInt) value.l);
+            } else {
+                format_int(&out, &spec, (FmtUint) (unsigned long) value.l, false);
+            }
+            break;
+        case ARG_TYPE_LLONG:
+            if (spec.conv == 'd' || spec.conv == 'i') {
+                format_signed(&out, &spec, (FmtInt) value.ll);
+            } else {
+                format_int(&out, &spec, (FmtUint) (unsigned long long) value.ll, false);
+            }
+            break;
+        case ARG_TYPE_SIZE:
+            if (spec.conv == 'd' || spec.conv == 'i') {
+                format_signed(&out, &spec, (FmtInt) (long) value.z);
+            } else {
+                format_int(&out, &spec, (FmtUint) value.z, false);
+            }
+            break;
+        case ARG_TYPE_PTR:
+            spec.flags |= FMT_FLAG_ALT;
+            format_int(&out, &spec, (FmtUint) (size_t) value.p, false);
+            break;
+        case ARG_TYPE_DOUBLE:
+        case ARG_TYPE_LDOUBLE:
+#ifdef ELOG_BUILTIN_FMT_FLOAT_ENABLE
+            format_float(&out, &spec, value.d);
+#else
+            /* the float conversion is not enabled, output it as it is */
+            out_str(&out, spec.start, spec.len);
+#endif
+            break;
+        case ARG_TYPE_STR:
+            format_str(&out, &spec, value.s);
+            break;
+        default:
+            break;
+        }
+    }
+    if (size > 0) {
+        buf[out.len < size ? out.len : size - 1] = '\0';
+    }
+
+    return (int) out.len;
+}
+
+#endif /* ELOG_BUILTIN_FMT_ENABLE */
+
+/**
+ * Format the captured arguments to the buffer. It works like snprintf.
+ *
+ * @param buf output buffer
+ * @param size output buffer size
+ * @param format log format, it must be same as the captured format
+ * @param captured captured arguments by elog_args_capture
+ *
+ * @return formatted length, it is less than the output buffer size
+ */
+#ifdef ELOG_BUILTIN_FMT_ENABLE
+int elog_args_format(char *buf, size_t size, const char *format, const ElogArgs *captured) {
+    ArgSource src = { NULL, captured, 0 };
+    int len;
+
+    assert(buf);
+    assert(format);
+    assert(captured);
+
+    if (size == 0) {
+        return 0;
+    }
+    len = format_args(buf, size, format, &src);
+
+    return len < (int) size ? len : (int) size - 1;
+}
+#else
+int elog_args_format(char *buf, size_t size, const char *format, const ElogArgs *captured) {
+    const char *p = format, *next;
+    char spec_buf[FMT_SPEC_MAX_LEN + 1];
+    size_t len = 0, index = 0, spec_len, i;
+    int star[2], star_num, fmt_result = 0;
+    FmtSpec spec;
+
+    assert(buf);
+    assert(format);
+    assert(captured);
+
+    if (size == 0) {
+        return 0;
+    }
+
+    while (*p != '\0' && len < size - 1) {
+        if (*p != '%') {
+            buf[len++] = *p++;
+            continue;
+        }
+        next = parse_fmt_spec(p, &spec);
+        star_num = 0;
+        if (spec.width_star && !args_get(captured, &index, &star[star_num++], sizeof(int))) {
+            break;
+        }
+        if (spec.prec_star && !args_get(captured, &index, &star[star_num++], sizeof(int))) {
+            break;
+        }
+        /* copy the specification and replace the '*' by the captured value */
+        for (i = 0, spec_len = 0, star_num = 0; i < spec.len && spec_len < FMT_SPEC_MAX_LEN; i++) {
+            if (spec.start[i] == '*') {
+                fmt_result = snprintf(spec_buf + spec_len, FMT_SPEC_MAX_LEN + 1 - spec_len, "%d",
+                        star[star_num++]);
+                spec_len += fmt_result > 0 ? fmt_result : 0;
+            } else {
+                spec_buf[spec_len++] = spec.start[i];
+            }
+        }
+        spec_buf[spec_len < FMT_SPEC_MAX_LEN ? spec_len : FMT_SPEC_MAX_LEN] = '\0';
+
+        switch (spec.type) {
+        case ARG_TYPE_NONE:
+            /* "%%" will output '%', the unknown specification will output as it is */
+            if (spec.len == 2 && spec.start[1] == '%') {
+                buf[len] = '%';
+                fmt_result = 1;
+            } else {
+                fmt_result = snprintf(buf + len, size - len, "%.*s", (int) spec.len, spec.start);
+            }
+            break;
+        case ARG_TYPE_INT: {
+            int value;
+            if (!args_get(captured, &index, &value, sizeof(value))) {
+                goto __exit;
+            }
+            fmt_result = snprintf(buf + len, size - len, spec_buf, value);
+            break;
+        }
+        case ARG_TYPE_LONG: {
+            long value;
+            if (!args_get(captured, &index, &value, sizeof(value))) {
+                goto __exit;
+            }
+            fmt_result = snprintf(buf + len, size - len, spec_buf, value);
+            break;
+        }
+        case ARG_TYPE_LLONG: {
+            long long value;
+            if (!args_get(captured, &index, &value, sizeof(value))) {
+                goto __exit;
+            }
+            fmt_result = snprintf(buf + len, size - len, spec_buf, value);
+            break;
+        }
+        case ARG_TYPE_SIZE: {
+            size_t value;
+            if (!args_get(captured, &index, &value, sizeof(value))) {
+                goto __exit;
+            }
+            fmt_result = snprintf(buf + len, size - len, spec_buf, value);
+            break;
+        }
+        case ARG_TYPE_PTR: {
+            void *value;
+            if (!args_get(captured, &index, &value, sizeof(value))) {
+                goto __exit;
+            }
+            fmt_result = snprintf(buf + len, size - len, spec_buf, value);
+            break;
+        }
+        case ARG_TYPE_DOUBLE: {
+            double value;
+            if (!args_get(captured, &index, &value, sizeof(value))) {
+                goto __exit;
+            }
+            fmt_result = snprintf(buf + len, size - len, spec_buf, value);
+            break;
+        }
+        case ARG_TYPE_LDOUBLE: {
+            double value;
+            if (!args_get(captured, &index, &value, sizeof(value))) {
+                goto __exit;
+            }
+            fmt_result = snprintf(buf + len, size - len, spec_buf, (long double) value);
+            break;
+        }
+        case ARG_TYPE_STR: {
+            uint8_t str_offset;
+            if (!args_get(captured, &index, &str_offset, sizeof(str_offset))) {
+                goto __exit;
+            }
+            fmt_result = snprintf(buf + len, size - len, spec_buf, captured->str + str_offset);
+            break;
+        }
+        default:
+            fmt_result = 0;
+            break;
+        }
+        if (fmt_result > 0) {
+            len += fmt_result;
+        }
+        p = next;
+    }
+
+__exit:
+    if (len > size - 1) {
+        len = size - 1;
+    }
+    buf[len] = '\0';
+
+    return len;
+}
+#endif /* ELOG_BUILTIN_FMT_ENABLE */
+
+/**
+ * Format the arguments to the buffer. It works like vsnprintf, the built-in
+ * formatter is used when ELOG_BUILTIN_FMT_ENABLE is defined.
+ *
+ * @param buf output buffer
+ * @param size output buffer size
+ * @param format format
+ * @param args arguments
+ *
+ * @return the length which would have been output if the buffer is large enough
+ */
+int elog_vsnprintf(char *buf, size_t size, const char *format, va_list args) {
+#ifdef ELOG_BUILTIN_FMT_ENABLE
+    ArgSource src = { NULL, NULL, 0 };
+    va_list args_copy;
+    int result;
+
+    va_copy(args_copy, args);
+    src.args = &args_copy;
+    result = format_args(buf, size, format, &src);
+    va_end(args_copy);
+
+    return result;
+#else
+    return vsnprintf(buf, size, format, args);
+#endif /* ELOG_BUILTIN_FMT_ENABLE */
+}
+
+/**
+ * Format the arguments to the buffer. It works like snprintf.
+ *
+ * @param buf output buffer
+ * @param size output buffer size
+ * @param format format
+ * @param ... arguments
+ *
+ * @return the length which would have been output if the buffer is large enough
+ */
+int elog_snprintf(char *buf, size_t size, const char *format, ...) {
+    va_list args;
+    int result;
+
+    va_start(args, format);
+    result = elog_vsnprintf(buf, size, format, args);
+    va_end(args);
+
+    return result;
+}
+
+/**
+ * convert the unsigned 32-bit number to decimal string, it is faster than elog_snprintf
+ *
+ * @param buf output buffer, it's size must be ELOG_U32_STR_MAX_LEN + 1 at least
+ * @param value number
+ *
+ * @return string length
+ */
+size_t elog_u32toa(char *buf, uint32_t value) {
+    char digits_buf[ELOG_U32_STR_MAX_LEN];
+    char *p = digits_buf + sizeof(digits_buf);
+    size_t len;
+    uint32_t rem;
+
+    do {
+        value = divu10(value, &rem);
+        *--p = (char) ('0' + rem);
+    } while (value);
+    len = digits_buf + sizeof(digits_buf) - p;
+    memcpy(buf, p, len);
+    buf[len] = '\0';
+
+    return len;
+}
+
+/**
+ * convert the unsigned 64-bit number to decimal string
+ *
+ * @param buf output buffer, it's size must be ELOG_U64_STR_MAX_LEN + 1 at least
+ * @param value number
+ *
+ * @return string length
+ */
+size_t elog_u64toa(char *buf, uint64_t value) {
+    char digits_buf[ELOG_U64_STR_MAX_LEN];
+    char *p = digits_buf + sizeof(digits_buf);
+    size_t len;
+    uint32_t rem, value32;
+
+    /* the 64-bit division is only used for the high digits */
+    while (value > UINT32_MAX) {
+        value = divu10_64(value, &rem);
+        *--p = (char) ('0' + rem);
+    }
+    value32 = (uint32_t) value;
+    do {
+        value32 = divu10(value32, &rem);
+        *--p = (char) ('0' + rem);
+    } while (value32);
+    len = digits_buf + sizeof(digits_buf) - p;
+    memcpy(buf, p, len);
+    buf[len] = '\0';
+
+    return len;
+}
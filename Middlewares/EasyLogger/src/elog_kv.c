@@ -0,0 +1,307 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Structured key-value logs. The typed fields are encoded in binary
+ *           output mode, or they are rendered to "event key=value" text.
+ * Created on: 2026-10-17
+ */
+
+#include <elog.h>
+#include <string.h>
+
+/* max fraction digits of the fixed-point value */
+#define KV_FIXED_MAX_SCALE                       9
+
+/*
+ * field encoding, the varint is LEB128 and the signed value is zigzag encoded:
+ * | type(low 4 bits) scale(high 4 bits) | key | '\0' | value |
+ * int and fixed:  zigzag varint
+ * uint:           varint
+ * str and bytes:  varint size | data |
+ */
+
+#ifndef ELOG_BIN_OUTPUT_ENABLE
+/* buffer size for the rendered text */
+#ifdef ELOG_KV_BUF_SIZE
+#define KV_BUF_SIZE                              ELOG_KV_BUF_SIZE
+#else
+#define KV_BUF_SIZE                              64
+#endif /* ELOG_KV_BUF_SIZE */
+
+/* rendered text buffer of every nested context */
+static char text_buf[ELOG_CTX_MAX_NUM][KV_BUF_SIZE];
+#endif
+
+/**
+ * put the unsigned varint to buffer
+ *
+ * @param buf buffer
+ * @param size buffer size
+ * @param value value
+ *
+ * @return put size, 0: no space
+ */
+static size_t put_varint(uint8_t *buf, size_t size, uint32_t value) {
+    size_t len = 0;
+
+    do {
+        if (len >= size) {
+            return 0;
+        }
+        buf[len++] = (uint8_t) ((value & 0x7F) | (value > 0x7F ? 0x80 : 0));
+        value >>= 7;
+    } while (value);
+
+    return len;
+}
+
+/**
+ * put the field to buffer
+ *
+ * @param buf buffer
+ * @param size buffer size
+ * @param field field
+ *
+ * @return put size, 0: no space
+ */
+static size_t put_field(uint8_t *buf, size_t size, const ElogKvField *field) {
+    size_t len, key_len = strlen(field->key), value_len;
+    const void *data = NULL;
+    uint32_t value;
+
+    if (key_len + 2 > size) {
+        return 0;
+    }
+    buf[0] = (uint8_t) (field->type | (field->scale << 4));
+    memcpy(buf + 1, field->key, key_len + 1);
+    len = key_len + 2;
+
+    switch (field->type) {
+    case ELOG_KV_TYPE_INT:
+    case ELOG_KV_TYPE_FIXED:
+        /* zigzag encoding, the small negative number is small */
+        value = ((uint32_t) field->value.i << 1) ^ (uint32_t) (field->value.i >> 31);
+        break;
+    case ELOG_KV_TYPE_UINT:
+        value = field->value.u;
+        break;
+    case ELOG_KV_TYPE_STR:
+        data = field->value.s ? field->value.s : "";
+        value = (uint32_t) strlen(data);
+        break;
+    default:
+        data = field->value.b;
+        value = data ? field->size : 0;
+        break;
+    }
+    if ((value_len = put_varint(buf + len, size - len, value)) == 0) {
+        return 0;
+    }
+    len += value_len;
+    if (data) {
+        if (len + value > size) {
+            return 0;
+        }
+        memcpy(buf + len, data, value);
+        len += value;
+    }
+
+    return len;
+}
+
+/**
+ * Encode the fields in compact binary. The field which has no space is dropped
+ * with all the fields after it.
+ *
+ * @param buf buffer
+ * @param size buffer size
+ * @param fields fields
+ * @param num field number
+ *
+ * @return encoded size
+ */
+size_t elog_kv_encode(uint8_t *buf, size_t size, const ElogKvField *fields, size_t num) {
+    size_t len = 0, field_len;
+
+    for (; num; num--, fields++) {
+        if ((field_len = put_field(buf + len, size - len, fields)) == 0) {
+            break;
+        }
+        len += field_len;
+    }
+
+    return len;
+}
+
+#ifndef ELOG_BIN_OUTPUT_ENABLE
+/**
+ * put the string to text buffer, the string is truncated when no space
+ *
+ * @param buf text buffer
+ * @param len current length
+ * @param src string
+ * @param n string length
+ *
+ * @return new length
+ */
+static size_t text_put(char *buf, size_t len, const char *src, size_t n) {
+    if (n > KV_BUF_SIZE - 1 - len) {
+        n = KV_BUF_SIZE - 1 - len;
+    }
+    memcpy(buf + len, src, n);
+
+    return len + n;
+}
+
+/**
+ * render the fixed-point value, the fraction digits are not divided
+ *
+ * @param buf output buffer, it's size is ELOG_U32_STR_MAX_LEN + KV_FIXED_MAX_SCALE + 3 at least
+ * @param value scaled value
+ * @param scale fraction digits
+ *
+ * @return rendered length
+ */
+static size_t render_fixed(char *buf, int32_t value, uint8_t scale) {
+    char digits[ELOG_U32_STR_MAX_LEN + 1];
+    size_t digits_len, int_len, frac_len, len = 0;
+    uint32_t mag = (uint32_t) value;
+
+    if (value < 0) {
+        buf[len++] = '-';
+        mag = 0U - mag;
+    }
+    digits_len = elog_u32toa(digits, mag);
+    if (scale > KV_FIXED_MAX_SCALE) {
+        scale = KV_FIXED_MAX_SCALE;
+    }
+    if (scale == 0) {
+        memcpy(buf + len, digits, digits_len);
+        return len + digits_len;
+    }
+    int_len = (digits_len > scale) ? digits_len - scale : 0;
+    if (int_len) {
+        memcpy(buf + len, digits, int_len);
+        len += int_len;
+    } else {
+        buf[len++] = '0';
+    }
+    buf[len++] = '.';
+    for (frac_len = digits_len - int_len; frac_len < scale; frac_len++) {
+        buf[len++] = '0';
+    }
+    memcpy(buf + len, digits + int_len, digits_len - int_len);
+
+    return len + digits_len - int_len;
+}
+
+/**
+ * render the fields to "event key=value key=value" text
+ *
+ * @param buf text buffer
+ * @param event event name
+ * @param fields fields
+ * @param num field number
+ *
+ * @return text length
+ */
+static size_t render_text(char *buf, const char *event, const ElogKvField *fields, size_t num) {
+    static const char hex[] = "0123456789abcdef";
+    char value_buf[ELOG_U32_STR_MAX_LEN + KV_FIXED_MAX_SCALE + 3];
+    size_t len, value_len, i;
+    const uint8_t *bytes;
+
+    len = text_put(buf, 0, event, strlen(event));
+    for (; num; num--, fields++) {
+        len = text_put(buf, len, " ", 1);
+        len = text_put(buf, len, fields->key, strlen(fields->key));
+        len = text_put(buf, len, "=", 1);
+        switch (fields->type) {
+        case ELOG_KV_TYPE_INT:
+        case ELOG_KV_TYPE_FIXED:
+            value_len = render_fixed(value_buf, fields->value.i,
+                    fields->type == ELOG_KV_TYPE_FIXED ? fields->scale : 0);
+            len = text_put(buf, len, value_buf, value_len);
+            break;
+        case ELOG_KV_TYPE_UINT:
+            value_len = elog_u32toa(value_buf, fields->value.u);
+            len = text_put(buf, len, value_buf, value_len);
+            break;
+        case ELOG_KV_TYPE_STR:
+            if (fields->value.s) {
+                len = text_put(buf, len, fields->value.s, strlen(fields->value.s));
+            }
+            break;
+        default:
+            bytes = fields->value.b;
+            for (i = 0; bytes && i < fields->size; i++) {
+                value_buf[0] = hex[bytes[i] >> 4];
+                value_buf[1] = hex[bytes[i] & 0x0F];
+                len = text_put(buf, len, value_buf, 2);
+            }
+            break;
+        }
+    }
+    buf[len] = '\0';
+
+    return len;
+}
+#endif /* ELOG_BIN_OUTPUT_ENABLE */
+
+/**
+ * Output the key-value log. The event name and constant info are in the call site.
+ * The fields are encoded in binary output mode, the host tool renders them as text
+ * or JSON. Otherwise they are rendered to text on device.
+ *
+ * @param site log call site, the event name is it's format
+ * @param tag tag
+ * @param fields fields
+ * @param num field number
+ */
+void elog_kv_output(const ElogSite *site, const char *tag, const ElogKvField *fields, size_t num) {
+    ElogTagCache *cache = site->tag ? &site->state->cache : NULL;
+#ifndef ELOG_BIN_OUTPUT_ENABLE
+    int ctx;
+#endif
+
+    ELOG_ASSERT(site->format);
+
+    /* check output enabled, level and tag filter */
+    if (!elog_output_filter((uint8_t) site->level, tag, cache)) {
+        return;
+    }
+
+#ifdef ELOG_BIN_OUTPUT_ENABLE
+    elog_bin_output_kv(site, fields, num);
+#else
+    /* claim the buffer of current context, it is not locked when rendering */
+    if ((ctx = elog_ctx_claim((uint8_t) site->level)) < 0) {
+        return;
+    }
+    render_text(text_buf[ctx], site->format, fields, num);
+    /* the record of the text log keeps the site ID */
+    elog_output_site(site, tag, "%s", text_buf[ctx]);
+    elog_ctx_release();
+#endif /* ELOG_BIN_OUTPUT_ENABLE */
+}
@@ -0,0 +1,351 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Logs output router. The log is formatted once, then it is output to
+ *           every registered sink which accepts it by the sink's own filter.
+ * Created on: 2026-10-17
+ */
+
+#include <elog.h>
+#include <string.h>
+
+#ifdef ELOG_SINK_ENABLE
+
+/* max registered sink number */
+#ifdef ELOG_SINK_MAX_NUM
+#define SINK_MAX_NUM                             ELOG_SINK_MAX_NUM
+#else
+#define SINK_MAX_NUM                             4
+#endif /* ELOG_SINK_MAX_NUM */
+
+/* record buffer size for the asynchronous sinks */
+#ifdef ELOG_SINK_ASYNC_BUF_SIZE
+#define ASYNC_BUF_SIZE                           ELOG_SINK_ASYNC_BUF_SIZE
+#else
+#define ASYNC_BUF_SIZE                           1024
+#endif /* ELOG_SINK_ASYNC_BUF_SIZE */
+
+#if SINK_MAX_NUM < 1 || SINK_MAX_NUM > 8
+    #error "Sink max number must be 1-8 (in elog_cfg.h)"
+#endif
+
+#if (ASYNC_BUF_SIZE & (ASYNC_BUF_SIZE - 1)) != 0 || ASYNC_BUF_SIZE < 64
+    #error "Sink asynchronous buffer size must be power of 2 and not less than 64 (in elog_cfg.h)"
+#endif
+
+/* the record is aligned by 8 bytes for the timestamp in the head */
+#define RECORD_ALIGN_SIZE                        8
+#define RECORD_ALIGN(size)                       (((size) + RECORD_ALIGN_SIZE - 1) & ~(RECORD_ALIGN_SIZE - 1))
+
+/*
+ * head of the record in the asynchronous buffer, the log follows it. The record is never
+ * split by the buffer end, the end space is skipped by a pad record which mask is 0, or
+ * skipped directly when it is less than the head.
+ */
+typedef struct {
+    uint64_t timestamp;
+    uint32_t seq;
+    uint16_t size;
+    uint16_t site_id;
+    uint16_t payload;
+    uint16_t payload_size;
+    uint8_t level;
+    ElogTagId tag_id;
+    /* bit n is set when the log is output to sink n */
+    uint8_t mask;
+} RecordHead;
+
+/* registered sinks, the index is the bit of the record mask */
+static ElogSink *sink_table[SINK_MAX_NUM] = { NULL };
+/* the record buffer for asynchronous sinks */
+static uint64_t async_buf[ASYNC_BUF_SIZE / sizeof(uint64_t)];
+/* record buffer put and get index, they are free running */
+static volatile size_t put_index = 0;
+static volatile size_t get_index = 0;
+/* the record which is rebuilt from the queued record head by drain */
+static ElogRecord drain_record;
+
+extern void elog_output_lock(void);
+extern void elog_output_unlock(void);
+
+/**
+ * Register the sink. The sink is owned by the caller, it must be valid until
+ * it is unregistered.
+ *
+ * example:
+ *     static size_t uart_output(const ElogRecord *record);
+ *     static ElogSink uart_sink = { "uart", uart_output, ELOG_LVL_WARN, ELOG_SINK_ASYNC, NULL };
+ *     elog_sink_register(&uart_sink);
+ *
+ * @param sink sink
+ *
+ * @return true: registered, false: the sink table is full
+ */
+bool elog_sink_register(ElogSink *sink) {
+    size_t i;
+    bool result = false;
+
+    ELOG_ASSERT(sink && sink->output);
+
+    elog_output_lock();
+    for (i = 0; i < SINK_MAX_NUM; i++) {
+        if (sink_table[i] == sink) {
+            result = true;
+            break;
+        }
+    }
+    for (i = 0; !result && i < SINK_MAX_NUM; i++) {
+        if (sink_table[i] == NULL) {
+            sink_table[i] = sink;
+            result = true;
+        }
+    }
+    elog_output_unlock();
+
+    return result;
+}
+
+/**
+ * unregister the sink, it's queued records will not be output to it
+ *
+ * @param sink sink
+ */
+void elog_sink_unregister(ElogSink *sink) {
+    size_t i;
+
+    elog_output_lock();
+    for (i = 0; i < SINK_MAX_NUM; i++) {
+        if (sink_table[i] == sink) {
+            sink_table[i] = NULL;
+        }
+    }
+    elog_output_unlock();
+}
+
+/**
+ * find the registered sink by name
+ *
+ * @param name sink name
+ *
+ * @return sink, NULL: not found
+ */
+ElogSink *elog_sink_find(const char *name) {
+    size_t i;
+
+    for (i = 0; i < SINK_MAX_NUM; i++) {
+        if (sink_table[i] && !strcmp(sink_table[i]->name, name)) {
+            return sink_table[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * get the mask of the registered sinks
+ *
+ * @param sink sink, NULL: all registered sinks
+ *
+ * @return bit n is set when sink n is the given sink, 0: the sink is not registered
+ */
+uint8_t elog_sink_get_mask(const ElogSink *sink) {
+    uint8_t mask = 0;
+    size_t i;
+
+    for (i = 0; i < SINK_MAX_NUM; i++) {
+        if (sink_table[i] && (sink == NULL || sink_table[i] == sink)) {
+            mask |= 1 << i;
+        }
+    }
+
+    return mask;
+}
+
+/**
+ * put the log to asynchronous buffer once for all asynchronous sinks which accept it
+ *
+ * @param record log record, it's log must be packaged
+ * @param mask the asynchronous sinks which accept it
+ *
+ * @return true: the log is put, false: no space
+ */
+static bool async_put(const ElogRecord *record, uint8_t mask) {
+    size_t offset = put_index & (ASYNC_BUF_SIZE - 1), record_size = RECORD_ALIGN(sizeof(RecordHead) + record->size);
+    size_t pad_size = 0;
+    RecordHead *head;
+
+    if (record->size > UINT16_MAX) {
+        return false;
+    }
+    /* the record which will be split by the buffer end is put at the buffer start */
+    if (offset + record_size > ASYNC_BUF_SIZE) {
+        pad_size = ASYNC_BUF_SIZE - offset;
+    }
+    if (put_index - get_index + pad_size + record_size > ASYNC_BUF_SIZE) {
+        return false;
+    }
+    if (pad_size >= sizeof(RecordHead)) {
+        head = (RecordHead *) ((uint8_t *) async_buf + offset);
+        head->size = (uint16_t) (pad_size - sizeof(RecordHead));
+        head->mask = 0;
+    }
+    put_index += pad_size;
+    offset = (offset + pad_size) & (ASYNC_BUF_SIZE - 1);
+    head = (RecordHead *) ((uint8_t *) async_buf + offset);
+    head->timestamp = record->timestamp;
+    head->seq = record->seq;
+    head->size = (uint16_t) record->size;
+    head->site_id = record->site_id;
+    head->payload = record->payload;
+    head->payload_size = record->payload_size;
+    head->level = record->level;
+    head->tag_id = record->tag_id;
+    head->mask = mask;
+    memcpy(head + 1, record->log, record->size);
+    put_index += record_size;
+
+    return true;
+}
+
+/**
+ * find the sinks which accept the log
+ *
+ * @param level level
+ * @param tag tag, NULL: the log has no tag, it is only accepted by the sink which has no tag filter
+ * @param text it will be set to true when any accepted sink needs the packaged log, NULL: don't care
+ *
+ * @return bit n is set when the log is accepted by sink n, 0: no sink accepts it
+ */
+uint8_t elog_sink_match(uint8_t level, const char *tag, bool *text) {
+    ElogSink *sink;
+    uint8_t mask = 0;
+    size_t i;
+
+    for (i = 0; i < SINK_MAX_NUM; i++) {
+        sink = sink_table[i];
+        if (sink == NULL || level > sink->level) {
+            continue;
+        }
+        if (sink->tag && (!tag || !strstr(tag, sink->tag))) {
+            continue;
+        }
+        mask |= 1 << i;
+        if (text && sink->policy != ELOG_SINK_RECORD) {
+            *text = true;
+        }
+    }
+
+    return mask;
+}
+
+/**
+ * Output the log record to the sinks which accept it. The synchronous and record
+ * sinks output it directly, and it is queued once for all asynchronous sinks.
+ * @note it is called in output locked
+ *
+ * @param record log record, it's log may be not packaged only when all accepted sinks are record sinks
+ * @param mask the sinks which accept it, @see elog_sink_match
+ */
+void elog_sink_output(const ElogRecord *record, uint8_t mask) {
+    ElogSink *sink;
+    uint8_t async_mask = 0;
+    size_t i;
+
+    for (i = 0; i < SINK_MAX_NUM; i++) {
+        sink = sink_table[i];
+        if (sink == NULL || !(mask & (1 << i))) {
+            continue;
+        }
+        if (sink->policy == ELOG_SINK_ASYNC) {
+            async_mask |= 1 << i;
+        } else if (sink->output(record) == 0) {
+            sink->drop_num++;
+        }
+    }
+
+    if (async_mask && !async_put(record, async_mask)) {
+        for (i = 0; i < SINK_MAX_NUM; i++) {
+            if ((async_mask & (1 << i)) && sink_table[i]) {
+                sink_table[i]->drop_num++;
+            }
+        }
+        elog_stat_drop(ELOG_STAGE_SINK, record->level, record->size);
+    }
+}
+
+/**
+ * Output the queued logs to the asynchronous sinks. It should be called in idle
+ * time, such as elog_idle(). The sinks are called without output locked.
+ *
+ * @param max_size max log size to output, it limits the time of once drain
+ *
+ * @return output log size
+ */
+size_t elog_sink_drain(size_t max_size) {
+    const RecordHead *head;
+    ElogRecord *record = &drain_record;
+    ElogSink *sink;
+    size_t i, offset, out_size = 0;
+
+    while (out_size < max_size && get_index != put_index) {
+        offset = get_index & (ASYNC_BUF_SIZE - 1);
+        /* the end space which is less than the head is skipped */
+        if (ASYNC_BUF_SIZE - offset < sizeof(RecordHead)) {
+            elog_output_lock();
+            get_index += ASYNC_BUF_SIZE - offset;
+            elog_output_unlock();
+            continue;
+        }
+        head = (const RecordHead *) ((const uint8_t *) async_buf + offset);
+        if (head->mask) {
+            record->timestamp = head->timestamp;
+            record->seq = head->seq;
+            record->level = head->level;
+            record->tag_id = head->tag_id;
+            record->site_id = head->site_id;
+            record->tag = elog_tag_get_name(head->tag_id);
+            record->log = (const char *) (head + 1);
+            record->size = head->size;
+            record->payload = head->payload;
+            record->payload_size = head->payload_size;
+            for (i = 0; i < SINK_MAX_NUM; i++) {
+                sink = sink_table[i];
+                if ((head->mask & (1 << i)) && sink && sink->output(record) == 0) {
+                    elog_output_lock();
+                    sink->drop_num++;
+                    elog_output_unlock();
+                }
+            }
+            out_size += head->size;
+        }
+        /* the record is released after all sinks output it */
+        elog_output_lock();
+        get_index += RECORD_ALIGN(sizeof(RecordHead) + head->size);
+        elog_output_unlock();
+    }
+
+    return out_size;
+}
+
+#endif /* ELOG_SINK_ENABLE */
@@ -0,0 +1,320 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Log call sites runtime control. Every log call site is placed in
+ *           the site section, so it can be enabled or disabled at runtime.
+ * Created on: 2026-10-17
+ */
+
+#include <elog.h>
+#include <string.h>
+
+/* rate limited log's max burst number */
+#ifdef ELOG_RATELIMIT_BURST
+#define RATELIMIT_BURST                          ELOG_RATELIMIT_BURST
+#else
+#define RATELIMIT_BURST                          10
+#endif /* ELOG_RATELIMIT_BURST */
+
+/* the period(ms) to refill one token for rate limited log */
+#ifdef ELOG_RATELIMIT_PERIOD
+#define RATELIMIT_PERIOD                         ELOG_RATELIMIT_PERIOD
+#else
+#define RATELIMIT_PERIOD                         100
+#endif /* ELOG_RATELIMIT_PERIOD */
+
+/* the refill period in timestamp unit, the low 32-bit timestamp is enough for it */
+#define RATELIMIT_PERIOD_TS                      ((uint32_t) RATELIMIT_PERIOD * ELOG_TIMESTAMP_PER_MS)
+
+#if RATELIMIT_BURST < 1 || RATELIMIT_BURST > UINT16_MAX
+    #error "Rate limited log's burst number is out of range (in elog_cfg.h)"
+#endif
+
+extern void elog_output_lock(void);
+extern void elog_output_unlock(void);
+
+/* rate limited sites which have suppressed logs, it is locked by output lock */
+static ElogRateLimit *pending_limit = NULL;
+
+/* the site section start and end address are defined by linker */
+#if defined(__CC_ARM) || defined(__ARMCC_VERSION)
+extern const uint32_t elog_site$$Base;
+extern const uint32_t elog_site$$Limit;
+#define SITE_SECTION_BASE                        ((const uint8_t *) &elog_site$$Base)
+#define SITE_SECTION_LIMIT                       ((const uint8_t *) &elog_site$$Limit)
+#elif defined(__GNUC__)
+extern const uint32_t __start_elog_site;
+extern const uint32_t __stop_elog_site;
+#define SITE_SECTION_BASE                        ((const uint8_t *) &__start_elog_site)
+#define SITE_SECTION_LIMIT                       ((const uint8_t *) &__stop_elog_site)
+#else
+    #error "The site section address is not supported by this compiler"
+#endif
+
+/**
+ * Enable or disable the log call sites which are matched. The disabled site
+ * doesn't evaluate it's arguments and doesn't call the output function.
+ *
+ * example:
+ *     // disable all verbose logs in the file
+ *     elog_site_set_enabled(NULL, "bsp_delay.c", 0, UINT32_MAX, ELOG_LVL_VERBOSE, false);
+ *     // enable the logs from line 100 to 200 of the "main" tag
+ *     elog_site_set_enabled("main", NULL, 100, 200, ELOG_LVL_ASSERT, true);
+ *
+ * @param tag site tag, NULL: all tags
+ * @param file the site file path contains it, NULL: all files
+ * @param line_min min site line number
+ * @param line_max max site line number
+ * @param level the site which level is greater than or equal to it will be matched,
+ *        ELOG_LVL_ASSERT: all levels
+ * @param enabled true: enable, false: disable
+ *
+ * @return matched site number
+ */
+size_t elog_site_set_enabled(const char *tag, const char *file, uint32_t line_min, uint32_t line_max,
+        uint8_t level, bool enabled) {
+    const ElogSite *site = (const ElogSite *) SITE_SECTION_BASE;
+    const ElogSite *limit = (const ElogSite *) SITE_SECTION_LIMIT;
+    size_t num = 0;
+
+    for (; site < limit; site++) {
+        if (site->level < level || site->line < line_min || site->line > line_max) {
+            continue;
+        }
+        /* the site which tag is variable is only matched by all tags */
+        if (tag && (!site->tag || strcmp(site->tag, tag))) {
+            continue;
+        }
+        if (file && (!site->file || !strstr(site->file, file))) {
+            continue;
+        }
+        site->state->disabled = !enabled;
+        num++;
+    }
+
+    return num;
+}
+
+/**
+ * log call site initialize, check the site section is small enough for the site ID
+ *
+ * @return result
+ */
+ElogErrCode elog_site_init(void) {
+    /* the site ID is the 16-bit word offset, the section which is larger than 256KB makes
+     * the ID of the last sites reach ELOG_SITE_ID_NONE or wrap around */
+    if ((size_t) (SITE_SECTION_LIMIT - SITE_SECTION_BASE) >> 2 > ELOG_SITE_ID_NONE) {
+        ELOG_ASSERT(false);
+    }
+
+    return ELOG_NO_ERR;
+}
+
+/**
+ * get the log call site number in the site section
+ *
+ * @return site number
+ */
+size_t elog_site_get_num(void) {
+    return (const ElogSite *) SITE_SECTION_LIMIT - (const ElogSite *) SITE_SECTION_BASE;
+}
+
+/**
+ * get the log call site ID, it is the word offset of the site in the site section
+ * @note the site section size is checked by elog_site_init()
+ *
+ * @param site log call site
+ *
+ * @return site ID
+ */
+uint16_t elog_site_get_id(const ElogSite *site) {
+    return (uint16_t) (((const uint8_t *) site - SITE_SECTION_BASE) >> 2);
+}
+
+/**
+ * get the log call site by it's ID
+ *
+ * @param id site ID, it must be got by elog_site_get_id()
+ *
+ * @return log call site
+ */
+const ElogSite *elog_site_get(uint16_t id) {
+    ELOG_ASSERT(id != ELOG_SITE_ID_NONE);
+
+    return (const ElogSite *) (SITE_SECTION_BASE + ((size_t) id << 2));
+}
+
+/**
+ * check the log of the call site is passed output enabled, level and tag filter
+ *
+ * @param site log call site
+ * @param tag log tag
+ *
+ * @return true: the log should be output
+ */
+bool elog_site_filter(const ElogSite *site, const char *tag) {
+    /* only the constant tag is cached by the site */
+    return elog_output_filter((uint8_t) site->level, tag, site->tag ? &site->state->cache : NULL);
+}
+
+/**
+ * refill the tokens of the rate limit state, it is bounded by the burst number
+ *
+ * @param limit limit state of the log call site
+ * @param now low 32-bit timestamp
+ */
+static void ratelimit_refill(ElogRateLimit *limit, uint32_t now) {
+    /* the full bucket doesn't store more tokens */
+    if (limit->count == 0) {
+        limit->tick = now;
+    }
+    while (limit->count > 0 && now - limit->tick >= RATELIMIT_PERIOD_TS) {
+        limit->count--;
+        limit->tick += RATELIMIT_PERIOD_TS;
+    }
+}
+
+/**
+ * output the summary of the suppressed log number
+ *
+ * @param site log call site
+ * @param tag log tag
+ * @param suppressed suppressed log number
+ */
+static void ratelimit_output(const ElogSite *site, const char *tag, uint16_t suppressed) {
+    elog_output((uint8_t) site->level, tag, site->file, site->func, site->line,
+            "%u logs are suppressed", suppressed);
+}
+
+/**
+ * Check the rate limited log by token bucket. When the log is output after some
+ * logs are suppressed, a summary of the suppressed log number is output before it.
+ * The suppressing site is linked to the pending list, so the summary of the site which
+ * is quiet after a burst is output by elog_ratelimit_poll().
+ *
+ * @param limit limit state of the log call site
+ * @param site log call site
+ * @param tag log tag
+ *
+ * @return true: the log should be output
+ */
+bool elog_ratelimit_pass(ElogRateLimit *limit, const ElogSite *site, const char *tag) {
+    extern uint64_t elog_port_get_timestamp(void);
+    uint32_t now = (uint32_t) elog_port_get_timestamp();
+    uint16_t suppressed = 0;
+    bool pass = false;
+
+    elog_output_lock();
+    ratelimit_refill(limit, now);
+    if (limit->count >= RATELIMIT_BURST) {
+        if (limit->suppressed < UINT16_MAX) {
+            limit->suppressed++;
+        }
+        if (!limit->site) {
+            /* the tag name is kept by it's ID, the variable tag buffer may be changed */
+            limit->site = site;
+            limit->tag_id = elog_tag_intern(tag);
+            limit->next = pending_limit;
+            pending_limit = limit;
+        }
+    } else {
+        limit->count++;
+        /* the site is unlinked by the next poll */
+        suppressed = limit->suppressed;
+        limit->suppressed = 0;
+        pass = true;
+    }
+    elog_output_unlock();
+
+    if (suppressed) {
+        ratelimit_output(site, tag, suppressed);
+    }
+
+    return pass;
+}
+
+/**
+ * Output the suppressed summary of the rate limited sites which have tokens again.
+ * It should be called in idle time, such as elog_idle().
+ */
+void elog_ratelimit_poll(void) {
+    extern uint64_t elog_port_get_timestamp(void);
+    uint32_t now = (uint32_t) elog_port_get_timestamp();
+    ElogRateLimit **prev, *limit;
+    const ElogSite *site;
+    const char *tag;
+    ElogTagId tag_id;
+    uint16_t suppressed;
+
+    do {
+        suppressed = 0;
+        elog_output_lock();
+        for (prev = &pending_limit; (limit = *prev) != NULL;) {
+            ratelimit_refill(limit, now);
+            if (limit->suppressed && limit->count >= RATELIMIT_BURST) {
+                /* the site is still suppressing */
+                prev = &limit->next;
+                continue;
+            }
+            *prev = limit->next;
+            site = limit->site;
+            tag_id = limit->tag_id;
+            suppressed = limit->suppressed;
+            limit->suppressed = 0;
+            limit->site = NULL;
+            limit->next = NULL;
+            if (suppressed) {
+                break;
+            }
+        }
+        elog_output_unlock();
+
+        /* the summary is output without lock, the list is walked again after it */
+        if (suppressed) {
+            if ((tag = elog_tag_get_name(tag_id)) == NULL) {
+                tag = site->tag ? site->tag : "";
+            }
+            ratelimit_output(site, tag, suppressed);
+        }
+    } while (suppressed);
+}
+
+/**
+ * check the sampled log, only 1 in n logs is output
+ *
+ * @param limit limit state of the log call site
+ * @param n sampling rate, 0 and 1: all logs are output
+ *
+ * @return true: the log should be output
+ */
+bool elog_sample_pass(ElogRateLimit *limit, uint16_t n) {
+    /* the first log of every n logs is output */
+    bool pass = (limit->count == 0);
+
+    if (++limit->count >= n) {
+        limit->count = 0;
+    }
+
+    return pass;
+}
@@ -0,0 +1,244 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Logs sequence number and the drop and truncation counters of every
+ *           output stage, so the lost logs can be found by the host.
+ * Created on: 2026-10-17
+ */
+
+#include <elog.h>
+#include <string.h>
+
+/* the period(ms) to output the summary when the counters are changed, 0: no periodic summary */
+#ifdef ELOG_STAT_SUMMARY_PERIOD
+#define SUMMARY_PERIOD                           ELOG_STAT_SUMMARY_PERIOD
+#else
+#define SUMMARY_PERIOD                           0
+#endif /* ELOG_STAT_SUMMARY_PERIOD */
+
+/* the next sequence number */
+static uint32_t seq_num = 0;
+/* drop and truncation counters of every stage */
+static ElogStat stat_table[ELOG_STAGE_NUM] = { 0 };
+/* the counters are changed since the last summary */
+static bool stat_changed = false;
+#if SUMMARY_PERIOD > 0
+/* the timestamp when the last periodic summary is output */
+static uint64_t summary_time = 0;
+#endif
+/* stage name for summary */
+static const char *stage_name[] = {
+        [ELOG_STAGE_CORE]     = "core",
+        [ELOG_STAGE_DEFERRED] = "deferred",
+        [ELOG_STAGE_ASYNC]    = "async",
+        [ELOG_STAGE_BUF]      = "buf",
+        [ELOG_STAGE_PORT]     = "port",
+        [ELOG_STAGE_FLASH]    = "flash",
+        [ELOG_STAGE_SINK]     = "sink",
+        [ELOG_STAGE_TRIG]     = "trig",
+};
+
+extern void elog_output_lock(void);
+extern void elog_output_unlock(void);
+
+/**
+ * Take the sequence number for a new log. It is taken when the log is accepted
+ * by a sink and it is not duplicate, so only the lost log leaves a gap in the sequence.
+ *
+ * @return sequence number
+ */
+uint32_t elog_seq_next(void) {
+    uint32_t seq;
+
+    elog_output_lock();
+    seq = elog_seq_take();
+    elog_output_unlock();
+
+    return seq;
+}
+
+/**
+ * take the sequence number in output locked, @see elog_seq_next
+ *
+ * @return sequence number, it is never ELOG_SEQ_NONE
+ */
+uint32_t elog_seq_take(void) {
+    uint32_t seq = seq_num++;
+
+    if (seq_num == ELOG_SEQ_NONE) {
+        seq_num = 0;
+    }
+
+    return seq;
+}
+
+/**
+ * get the sequence number which will be taken by the next log, it is the taken log number
+ *
+ * @return next sequence number
+ */
+uint32_t elog_get_seq(void) {
+    return seq_num;
+}
+
+/**
+ * count the dropped log of the stage
+ *
+ * @param stage output stage @see ElogStage
+ * @param level log level, ELOG_STAT_LVL_NONE: the level is unknown, such as a block of logs
+ * @param size dropped size
+ */
+void elog_stat_drop(uint8_t stage, uint8_t level, size_t size) {
+    ELOG_ASSERT(stage < ELOG_STAGE_NUM);
+
+    elog_output_lock();
+    if (level < ELOG_LVL_TOTAL_NUM) {
+        stat_table[stage].drop[level]++;
+    }
+    stat_table[stage].lost_size += size;
+    stat_changed = true;
+    elog_output_unlock();
+}
+
+/**
+ * count the truncated log of the stage
+ *
+ * @param stage output stage @see ElogStage
+ * @param level log level, ELOG_STAT_LVL_NONE: the level is unknown, such as a block of logs
+ * @param size truncated size, 0: it is unknown
+ */
+void elog_stat_trunc(uint8_t stage, uint8_t level, size_t size) {
+    ELOG_ASSERT(stage < ELOG_STAGE_NUM);
+
+    elog_output_lock();
+    if (level < ELOG_LVL_TOTAL_NUM) {
+        stat_table[stage].trunc[level]++;
+    }
+    stat_table[stage].lost_size += size;
+    stat_changed = true;
+    elog_output_unlock();
+}
+
+/**
+ * count the log by the size which is put to the stage
+ *
+ * @param stage output stage @see ElogStage
+ * @param level log level, ELOG_STAT_LVL_NONE: the level is unknown, such as a block of logs
+ * @param size log size
+ * @param put_size the size which is put, 0: the log is dropped, less than log size: truncated
+ */
+void elog_stat_put(uint8_t stage, uint8_t level, size_t size, size_t put_size) {
+    if (put_size == 0 && size) {
+        elog_stat_drop(stage, level, size);
+    } else if (put_size < size) {
+        elog_stat_trunc(stage, level, size - put_size);
+    }
+}
+
+/**
+ * get the drop and truncation counters of the stage
+ *
+ * @param stage output stage @see ElogStage
+ * @param stat counters
+ */
+void elog_get_stat(uint8_t stage, ElogStat *stat) {
+    ELOG_ASSERT(stage < ELOG_STAGE_NUM);
+    ELOG_ASSERT(stat);
+
+    elog_output_lock();
+    *stat = stat_table[stage];
+    elog_output_unlock();
+}
+
+/**
+ * reset the drop and truncation counters of all stages, the sequence number is not reset
+ */
+void elog_stat_reset(void) {
+    elog_output_lock();
+    memset(stat_table, 0, sizeof(stat_table));
+    stat_changed = false;
+    elog_output_unlock();
+}
+
+/**
+ * check the counters are all zero
+ *
+ * @param stat counters
+ *
+ * @return true: no log is dropped or truncated
+ */
+static bool stat_is_clean(const ElogStat *stat) {
+    size_t i;
+
+    for (i = 0; i < ELOG_LVL_TOTAL_NUM; i++) {
+        if (stat->drop[i] || stat->trunc[i]) {
+            return false;
+        }
+    }
+
+    return stat->lost_size == 0;
+}
+
+/**
+ * Output the summary of the stages which have dropped or truncated logs.
+ * Every counter is ordered by level: A/E/W/I/D/V.
+ */
+void elog_stat_summary(void) {
+    ElogStat stat;
+    const uint32_t *d = stat.drop, *t = stat.trunc;
+    uint8_t stage;
+
+    elog_output_lock();
+    stat_changed = false;
+    elog_output_unlock();
+
+    for (stage = 0; stage < ELOG_STAGE_NUM; stage++) {
+        elog_get_stat(stage, &stat);
+        if (stat_is_clean(&stat)) {
+            continue;
+        }
+        elog_output(ELOG_LVL_WARN, "elog", NULL, NULL, 0,
+                "%s drop %u/%u/%u/%u/%u/%u trunc %u/%u/%u/%u/%u/%u lost %u bytes, seq %u", stage_name[stage],
+                (unsigned int) d[0], (unsigned int) d[1], (unsigned int) d[2], (unsigned int) d[3],
+                (unsigned int) d[4], (unsigned int) d[5], (unsigned int) t[0], (unsigned int) t[1],
+                (unsigned int) t[2], (unsigned int) t[3], (unsigned int) t[4], (unsigned int) t[5],
+                (unsigned int) stat.lost_size, (unsigned int) seq_num);
+    }
+}
+
+/**
+ * Output the summary periodically when the counters are changed.
+ * It should be called in idle time, such as elog_idle().
+ */
+void elog_stat_poll(void) {
+#if SUMMARY_PERIOD > 0
+    extern uint64_t elog_port_get_timestamp(void);
+    uint64_t now = elog_port_get_timestamp();
+
+    if (stat_changed && now - summary_time >= (uint64_t) SUMMARY_PERIOD * ELOG_TIMESTAMP_PER_MS) {
+        summary_time = now;
+        elog_stat_summary();
+    }
+#endif /* SUMMARY_PERIOD > 0 */
+}
@@ -0,0 +1,394 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Pre-trigger logs. The low level logs are kept in RAM ring by their
+ *           captured arguments, they are output as the context when triggered.
+ * Created on: 2026-10-17
+ */
+
+#include <elog.h>
+#include <string.h>
+
+#ifdef ELOG_TRIG_ENABLE
+
+#ifndef ELOG_SINK_ENABLE
+    #error "Pre-trigger logs need ELOG_SINK_ENABLE (in elog_cfg.h)"
+#endif
+
+/* pre-trigger ring buffer size */
+#ifdef ELOG_TRIG_BUF_SIZE
+#define TRIG_BUF_SIZE                            ELOG_TRIG_BUF_SIZE
+#else
+#define TRIG_BUF_SIZE                            2048
+#endif /* ELOG_TRIG_BUF_SIZE */
+
+/* the highest kept level */
+#ifdef ELOG_TRIG_KEEP_LVL
+#define KEEP_LVL                                 ELOG_TRIG_KEEP_LVL
+#else
+#define KEEP_LVL                                 ELOG_LVL_VERBOSE
+#endif /* ELOG_TRIG_KEEP_LVL */
+
+/* the lowest level which fires the output */
+#ifdef ELOG_TRIG_LVL
+#define TRIG_LVL                                 ELOG_TRIG_LVL
+#else
+#define TRIG_LVL                                 ELOG_LVL_ERROR
+#endif /* ELOG_TRIG_LVL */
+
+/* max kept message size of the log which arguments are not captured */
+#ifdef ELOG_TRIG_TEXT_MAX_SIZE
+#define TEXT_MAX_SIZE                            ELOG_TRIG_TEXT_MAX_SIZE
+#else
+#define TEXT_MAX_SIZE                            64
+#endif /* ELOG_TRIG_TEXT_MAX_SIZE */
+
+#if (TRIG_BUF_SIZE & (TRIG_BUF_SIZE - 1)) != 0 || TRIG_BUF_SIZE < 256
+    #error "Pre-trigger buffer size must be power of 2 and not less than 256 (in elog_cfg.h)"
+#endif
+
+#if TEXT_MAX_SIZE >= ELOG_LINE_BUF_SIZE || TEXT_MAX_SIZE > TRIG_BUF_SIZE / 4
+    #error "Pre-trigger text max size must be less than the line buffer and quarter of the buffer (in elog_cfg.h)"
+#endif
+
+/* the record is aligned by 8 bytes for the timestamp in the head */
+#define RECORD_ALIGN_SIZE                        8
+#define RECORD_ALIGN(size)                       (((size) + RECORD_ALIGN_SIZE - 1) & ~(RECORD_ALIGN_SIZE - 1))
+
+/* the data type after the record head */
+#define RECORD_TYPE_PAD                          0
+#define RECORD_TYPE_ARGS                         1
+#define RECORD_TYPE_TEXT                         2
+
+/*
+ * head of the record in the pre-trigger buffer. The data follows it, it is the captured
+ * arguments then their strings, or the log message when the arguments are not captured.
+ * The record is never split by the buffer end, the end space is skipped by a pad record,
+ * or skipped directly when it is less than the head.
+ */
+typedef struct {
+    uint64_t timestamp;
+    const char *file;
+    const char *func;
+    const char *format;
+    long line;
+    uint32_t seq;
+    /* data size */
+    uint16_t size;
+    uint16_t site_id;
+    uint8_t level;
+    ElogTagId tag_id;
+    uint8_t type;
+    uint8_t arg_num;
+} RecordHead;
+
+static size_t trig_sink_output(const ElogRecord *record);
+/* pre-trigger sink, it only keeps the log and outputs nothing */
+static ElogSink trig_sink = { "trig", trig_sink_output, KEEP_LVL, ELOG_SINK_RECORD, NULL, 0 };
+/* pre-trigger ring buffer */
+static uint64_t trig_buf[TRIG_BUF_SIZE / sizeof(uint64_t)];
+/* record put and get index, they are free running and only changed in locked */
+static volatile size_t put_index = 0;
+static volatile size_t get_index = 0;
+/* the records before it are the pre-trigger logs */
+static volatile size_t trig_index = 0;
+/* the next record to output */
+static volatile size_t dump_index = 0;
+/* the output is fired and not finished */
+static volatile bool is_fired = false;
+/* the begin banner of the fired output has been output */
+static bool is_begun = false;
+/* the drain is running, it is not reentrant */
+static volatile bool is_draining = false;
+/* the record, arguments and message which are rebuilt by drain */
+static ElogRecord dump_record;
+static ElogArgs dump_args;
+static char msg_buf[ELOG_LINE_BUF_SIZE] = { 0 };
+
+extern void elog_output_lock(void);
+extern void elog_output_unlock(void);
+extern uint64_t elog_port_get_timestamp(void);
+
+/**
+ * Pre-trigger logs initialize, the pre-trigger sink is registered. The level of
+ * other sinks can be set to ELOG_TRIG_LVL, so the low level logs are only output
+ * when triggered.
+ *
+ * example:
+ *     elog_sink_find("port")->level = ELOG_TRIG_LVL;
+ *
+ * @return result
+ */
+ElogErrCode elog_trig_init(void) {
+    if (!elog_sink_register(&trig_sink)) {
+        /* the sink table is full, ELOG_SINK_MAX_NUM should be increased */
+        ELOG_ASSERT(false);
+    }
+
+    return ELOG_NO_ERR;
+}
+
+/**
+ * get the buffer space from the record to the next one
+ *
+ * @param index record index
+ *
+ * @return record space
+ */
+static size_t trig_get_span(size_t index) {
+    size_t offset = index & (TRIG_BUF_SIZE - 1);
+    const RecordHead *head;
+
+    /* the end space which is less than the head is skipped */
+    if (TRIG_BUF_SIZE - offset < sizeof(RecordHead)) {
+        return TRIG_BUF_SIZE - offset;
+    }
+    head = (const RecordHead *) ((const uint8_t *) trig_buf + offset);
+
+    return RECORD_ALIGN(sizeof(RecordHead) + head->size);
+}
+
+/**
+ * put the log to pre-trigger buffer, the oldest logs are overwritten when there is no space
+ * @note it is called in output locked
+ *
+ * @param record log record
+ *
+ * @return put size, 0: the log has neither captured arguments nor packaged log
+ */
+static size_t trig_put(const ElogRecord *record) {
+    size_t offset, record_size, data_size, args_size = 0, pad_size = 0;
+    RecordHead *head;
+    uint8_t *data;
+
+    if (record->args) {
+        args_size = record->args->arg_num * sizeof(uint32_t);
+        data_size = args_size + record->args->str_len;
+    } else if (record->log) {
+        data_size = record->payload_size < TEXT_MAX_SIZE ? record->payload_size : TEXT_MAX_SIZE;
+        if (data_size < record->payload_size) {
+            elog_stat_trunc(ELOG_STAGE_TRIG, record->level, record->payload_size - data_size);
+        }
+    } else {
+        return 0;
+    }
+    record_size = RECORD_ALIGN(sizeof(RecordHead) + data_size);
+    /* the record which will be split by the buffer end is put at the buffer start */
+    offset = put_index & (TRIG_BUF_SIZE - 1);
+    if (offset + record_size > TRIG_BUF_SIZE) {
+        pad_size = TRIG_BUF_SIZE - offset;
+    }
+    while (put_index - get_index + pad_size + record_size > TRIG_BUF_SIZE) {
+        get_index += trig_get_span(get_index);
+    }
+    if (pad_size >= sizeof(RecordHead)) {
+        head = (RecordHead *) ((uint8_t *) trig_buf + offset);
+        head->size = (uint16_t) (pad_size - sizeof(RecordHead));
+        head->type = RECORD_TYPE_PAD;
+    }
+    put_index += pad_size;
+
+    head = (RecordHead *) ((uint8_t *) trig_buf + (put_index & (TRIG_BUF_SIZE - 1)));
+    head->timestamp = record->timestamp;
+    head->file = record->file;
+    head->func = record->func;
+    head->format = record->format;
+    head->line = record->line;
+    head->seq = record->seq;
+    head->size = (uint16_t) data_size;
+    head->site_id = record->site_id;
+    head->level = record->level;
+    head->tag_id = record->tag_id;
+    data = (uint8_t *) (head + 1);
+    if (record->args) {
+        head->type = RECORD_TYPE_ARGS;
+        head->arg_num = record->args->arg_num;
+        memcpy(data, record->args->arg, args_size);
+        memcpy(data + args_size, record->args->str, record->args->str_len);
+    } else {
+        head->type = RECORD_TYPE_TEXT;
+        head->arg_num = 0;
+        memcpy(data, record->log + record->payload, data_size);
+    }
+    put_index += record_size;
+
+    return sizeof(RecordHead) + data_size;
+}
+
+/**
+ * fire the output of the pre-trigger logs, the logs which are kept after it are
+ * output by the next trigger
+ * @note it is called in output locked
+ */
+static void trig_fire(void) {
+    if (!is_fired) {
+        dump_index = get_index;
+        is_begun = false;
+        is_fired = true;
+    }
+    trig_index = put_index;
+}
+
+/**
+ * keep the log, or fire the output of the kept logs by the trigger log
+ * @note it is called in output locked
+ *
+ * @param record log record
+ *
+ * @return kept size
+ */
+static size_t trig_sink_output(const ElogRecord *record) {
+    if (record->level <= TRIG_LVL) {
+        /* the raw log and hex dump have no format, they don't fire */
+        if (record->format) {
+            trig_fire();
+        }
+        /* the trigger log is output by other sinks, it is not kept and never dropped */
+        return 1;
+    }
+
+    return trig_put(record);
+}
+
+/**
+ * Fire the output of the pre-trigger logs by user, such as the unexpected state
+ * which is not logged as error. They are output by elog_idle().
+ */
+void elog_trig_fire(void) {
+    elog_output_lock();
+    trig_fire();
+    elog_output_unlock();
+}
+
+/**
+ * output the banner of the pre-trigger logs
+ *
+ * @param mask the sinks to output
+ * @param text banner text
+ */
+static void trig_output_banner(uint8_t mask, const char *text) {
+    memset(&dump_record, 0, sizeof(dump_record));
+    dump_record.timestamp = elog_port_get_timestamp();
+    dump_record.seq = ELOG_SEQ_NONE;
+    dump_record.level = ELOG_LVL_INFO;
+    dump_record.tag_id = ELOG_TAG_ID_NONE;
+    dump_record.site_id = ELOG_SITE_ID_NONE;
+    dump_record.tag = "elog";
+    elog_output_record_to(&dump_record, mask, "%s", text);
+}
+
+/**
+ * Output the fired pre-trigger logs to all other sinks, the level and tag filter of
+ * the sinks are skipped. The timestamp, sequence number and call site of the logs
+ * are kept. It should be called in idle time, such as elog_idle(), and it is called
+ * by the assert before stop.
+ *
+ * @param max_num max log number to output, it limits the time of once drain
+ *
+ * @return output log number
+ */
+size_t elog_trig_drain(size_t max_num) {
+    const RecordHead *head;
+    size_t num = 0, offset, used, args_size;
+    uint8_t mask, type;
+
+    if (!is_fired) {
+        return 0;
+    }
+    /* the drain which preempts another drain does nothing */
+    elog_output_lock();
+    if (is_draining) {
+        elog_output_unlock();
+        return 0;
+    }
+    is_draining = true;
+    elog_output_unlock();
+
+    mask = elog_sink_get_mask(NULL) & ~elog_sink_get_mask(&trig_sink);
+    if (!is_begun) {
+        is_begun = true;
+        trig_output_banner(mask, "---- pre-trigger logs begin ----");
+    }
+    while (num < max_num) {
+        elog_output_lock();
+        used = put_index - get_index;
+        /* the overwritten logs are skipped */
+        if (dump_index - get_index > used) {
+            dump_index = get_index;
+        }
+        /* all pre-trigger logs are output, or the rest are overwritten */
+        if (trig_index - get_index > used || dump_index - get_index >= trig_index - get_index) {
+            if (trig_index - get_index <= used) {
+                get_index = trig_index;
+            }
+            is_fired = false;
+            elog_output_unlock();
+            trig_output_banner(mask, "---- pre-trigger logs end ----");
+            break;
+        }
+        offset = dump_index & (TRIG_BUF_SIZE - 1);
+        dump_index += trig_get_span(dump_index);
+        head = (const RecordHead *) ((const uint8_t *) trig_buf + offset);
+        if (TRIG_BUF_SIZE - offset < sizeof(RecordHead) || head->type == RECORD_TYPE_PAD) {
+            elog_output_unlock();
+            continue;
+        }
+        /* the record is copied in locked, it may be overwritten after unlock */
+        memset(&dump_record, 0, sizeof(dump_record));
+        dump_record.timestamp = head->timestamp;
+        dump_record.seq = head->seq;
+        dump_record.level = head->level;
+        dump_record.tag_id = head->tag_id;
+        dump_record.site_id = head->site_id;
+        dump_record.tag = elog_tag_get_name(head->tag_id);
+        dump_record.file = head->file;
+        dump_record.func = head->func;
+        dump_record.line = head->line;
+        dump_record.format = head->format;
+        type = head->type;
+        if (type == RECORD_TYPE_ARGS) {
+            args_size = head->arg_num * sizeof(uint32_t);
+            dump_args.arg_num = head->arg_num;
+            dump_args.str_len = (uint8_t) (head->size - args_size);
+            memcpy(dump_args.arg, head + 1, args_size);
+            memcpy(dump_args.str, (const uint8_t *) (head + 1) + args_size, dump_args.str_len);
+            dump_record.args = &dump_args;
+        } else {
+            memcpy(msg_buf, head + 1, head->size);
+            msg_buf[head->size] = '\0';
+        }
+        elog_output_unlock();
+
+        if (type == RECORD_TYPE_ARGS) {
+            elog_args_format(msg_buf, sizeof(msg_buf), dump_record.format, &dump_args);
+        }
+        elog_output_record_to(&dump_record, mask, "%s", msg_buf);
+        num++;
+    }
+    is_draining = false;
+
+    return num;
+}
+
+#endif /* ELOG_TRIG_ENABLE */
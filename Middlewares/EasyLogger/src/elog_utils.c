@@ -101,3 +101,45 @@ void *elog_memcpy(void *dst, const void *src, size_t count) {
 
     return dst;
 }
+
+/**
+ * Copy data to the reserved output space. The data will be split when the
+ * space is wrapped.
+ *
+ * @param span reserved output space
+ * @param offset offset in the reserved space
+ * @param data source data
+ * @param size data size, the data out of the reserved space will be dropped
+ *
+ * @return the offset after the copied data
+ */
+size_t elog_span_write(const ElogSpan *span, size_t offset, const void *data, size_t size) {
+    const char *src = (const char *) data;
+    size_t copy_size;
+
+    assert(span);
+    assert(data);
+
+    /* first part */
+    if (offset < span->size[0]) {
+        copy_size = span->size[0] - offset;
+        if (copy_size > size) {
+            copy_size = size;
+        }
+        memcpy(span->buf[0] + offset, src, copy_size);
+        offset += copy_size;
+        src += copy_size;
+        size -= copy_size;
+    }
+    /* second part which is wrapped */
+    if (size && offset - span->size[0] < span->size[1]) {
+        copy_size = span->size[1] - (offset - span->size[0]);
+        if (copy_size > size) {
+            copy_size = size;
+        }
+        memcpy(span->buf[1] + offset - span->size[0], src, copy_size);
+        offset += copy_size;
+    }
+
+    return offset;
+}
@@ -0,0 +1,372 @@
+#!/usr/bin/env python3
+#
+# This file is part of the EasyLogger Library.
+#
+# Copyright (c) 2025, Ethan-Hang
+#
+# Function: Decode the EasyLogger binary output mode stream. The log call sites
+#           are read from the ELF file, then the log text is rebuilt.
+# Created on: 2026-10-17
+#
+# usage: elog_decode.py [--json] firmware.axf [rtt_stream.bin]
+#        the stream is read from stdin when the stream file is not given
+#
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+FRAME_SITE = 0xE5
+FRAME_TEXT = 0xE6
+FRAME_SITE_TEXT = 0xE7
+FRAME_KV = 0xE8
+
+# key-value field types, same as ElogKvType
+KV_TYPE_INT = 0
+KV_TYPE_UINT = 1
+KV_TYPE_FIXED = 2
+KV_TYPE_STR = 3
+KV_TYPE_BYTES = 4
+
+SITE_SECTION = "elog_site"
+# the site section start symbol, armlink and GNU ld
+SITE_BASE_SYMBOLS = ("elog_site$$Base", "__start_elog_site")
+
+LEVEL_INFO = ("A/", "E/", "W/", "I/", "D/", "V/")
+# the tag is aligned by space like ELOG_FILTER_TAG_MAX_LEN / 2
+TAG_ALIGN_LEN = 15
+# elog_port_get_timestamp() unit is microsecond, the frame only has it's low 32-bit
+TIMESTAMP_PER_SEC = 1000000
+TIMESTAMP_WRAP = 1 << 32
+# the frame only has the low 16-bit sequence number
+SEQ_WRAP = 1 << 16
+
+SHT_SYMTAB = 2
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+
+FMT_SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?([hlLqjzt]*)([diouxXcpsfFeEgGaAn%])?")
+
+
+class Elf(object):
+    """ELF file reader, only the little endian file is supported."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF" or self.data[5] != 1:
+            raise ValueError("%s is not a little endian ELF file" % path)
+        self.is_64 = self.data[4] == 2
+        self.ptr_size = 8 if self.is_64 else 4
+        if self.is_64:
+            shoff, = struct.unpack_from("<Q", self.data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 0x3A)
+        else:
+            shoff, = struct.unpack_from("<I", self.data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            off = shoff + i * shentsize
+            if self.is_64:
+                name, type_, flags, addr, offset, size, link = struct.unpack_from("<IIQQQQI", self.data, off)
+                entsize, = struct.unpack_from("<Q", self.data, off + 0x38)
+            else:
+                name, type_, flags, addr, offset, size, link = struct.unpack_from("<IIIIIII", self.data, off)
+                entsize, = struct.unpack_from("<I", self.data, off + 0x24)
+            self.sections.append({"name": name, "type": type_, "flags": flags, "addr": addr,
+                                  "offset": offset, "size": size, "link": link, "entsize": entsize})
+        names = self.sections[shstrndx]
+        for sec in self.sections:
+            sec["name"] = self._str(names["offset"] + sec["name"])
+
+    def _str(self, offset):
+        end = self.data.index(b"\0", offset)
+        return self.data[offset:end].decode("utf-8", "replace")
+
+    def symbol(self, name):
+        for sec in self.sections:
+            if sec["type"] != SHT_SYMTAB:
+                continue
+            strtab = self.sections[sec["link"]]
+            entsize = sec["entsize"] or (24 if self.is_64 else 16)
+            for off in range(sec["offset"], sec["offset"] + sec["size"], entsize):
+                if self.is_64:
+                    st_name, = struct.unpack_from("<I", self.data, off)
+                    st_value, = struct.unpack_from("<Q", self.data, off + 8)
+                else:
+                    st_name, st_value = struct.unpack_from("<II", self.data, off)
+                if st_name and self._str(strtab["offset"] + st_name) == name:
+                    return st_value
+        return None
+
+    def section(self, name):
+        for sec in self.sections:
+            if sec["name"] == name:
+                return sec
+        return None
+
+    def read(self, addr, size):
+        for sec in self.sections:
+            if not sec["flags"] & SHF_ALLOC or sec["type"] == SHT_NOBITS:
+                continue
+            if sec["addr"] <= addr and addr + size <= sec["addr"] + sec["size"]:
+                off = sec["offset"] + addr - sec["addr"]
+                return self.data[off:off + size]
+        return None
+
+    def read_ptr(self, addr):
+        raw = self.read(addr, self.ptr_size)
+        if raw is None:
+            return None
+        return struct.unpack("<Q" if self.is_64 else "<I", raw)[0]
+
+    def read_str(self, addr):
+        if not addr:
+            return None
+        for sec in self.sections:
+            if not sec["flags"] & SHF_ALLOC or sec["type"] == SHT_NOBITS:
+                continue
+            if sec["addr"] <= addr < sec["addr"] + sec["size"]:
+                return self._str(sec["offset"] + addr - sec["addr"])
+        return None
+
+
+class Sites(object):
+    """Log call sites table in the ELF file."""
+
+    def __init__(self, elf):
+        self.elf = elf
+        self.base = None
+        for name in SITE_BASE_SYMBOLS:
+            self.base = elf.symbol(name)
+            if self.base is not None:
+                break
+        if self.base is None:
+            sec = elf.section(SITE_SECTION)
+            if sec is None:
+                raise ValueError("log call site section is not found, is ELOG_BIN_OUTPUT_ENABLE defined?")
+            self.base = sec["addr"]
+        self.cache = {}
+
+    def get(self, site_id):
+        if site_id not in self.cache:
+            addr = self.base + site_id * 4
+            ptr = self.elf.ptr_size
+            raw = self.elf.read(addr + ptr * 4, 8)
+            if raw is None:
+                return None
+            line, level = struct.unpack("<II", raw)
+            self.cache[site_id] = {
+                "tag": self.elf.read_str(self.elf.read_ptr(addr)),
+                "file": self.elf.read_str(self.elf.read_ptr(addr + ptr)),
+                "func": self.elf.read_str(self.elf.read_ptr(addr + ptr * 2)),
+                "format": self.elf.read_str(self.elf.read_ptr(addr + ptr * 3)) or "",
+                "line": line,
+                "level": level,
+            }
+        return self.cache[site_id]
+
+
+def format_args(fmt, words, strs, ptr_size):
+    """Format the captured argument words like elog_args_format() in elog_utils.c."""
+    ptr_words = ptr_size // 4
+    index = [0]
+
+    def take(num):
+        value = 0
+        for i in range(num):
+            if index[0] < len(words):
+                value |= words[index[0]] << (32 * i)
+            index[0] += 1
+        return value
+
+    def signed(value, bits):
+        return value - (1 << bits) if value & (1 << (bits - 1)) else value
+
+    def render(match):
+        flags, width, prec, length, conv = match.groups()
+        if conv is None:
+            return match.group(0)
+        if conv == "%":
+            return "%"
+        if width == "*":
+            width = str(signed(take(1), 32))
+        if prec == "*":
+            prec = str(signed(take(1), 32))
+        spec = "%" + flags + (width or "") + ("." + prec if prec is not None else "")
+        if conv in "diouxXc":
+            if "ll" in length or "j" in length or "q" in length:
+                num, bits = 2, 64
+            elif length in ("l", "z", "t"):
+                num, bits = ptr_words, ptr_size * 8
+            else:
+                num, bits = 1, 32
+            value = take(num)
+            if conv in "di":
+                return (spec + "d") % signed(value, bits)
+            if conv == "c":
+                return (spec + "c") % chr(value & 0xFF)
+            if conv == "u":
+                return (spec + "d") % value
+            return (spec + conv) % value
+        if conv == "p":
+            return "0x%0*x" % (ptr_size * 2, take(ptr_words))
+        if conv == "s":
+            offset = take(1) & 0xFF
+            end = strs.find(b"\0", offset)
+            text = strs[offset:end if end >= 0 else len(strs)].decode("utf-8", "replace")
+            return (spec + "s") % text
+        if conv == "n":
+            return ""
+        value, = struct.unpack("<d", struct.pack("<Q", take(2)))
+        return (spec + conv) % value
+
+    return FMT_SPEC.sub(render, fmt)
+
+
+def get_varint(data, pos):
+    """Read the LEB128 varint, return the value and the next position."""
+    value = shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def decode_fields(data):
+    """Decode the key-value fields encoded by elog_kv_encode(), return (key, type, value) list."""
+    fields = []
+    pos = 0
+    while pos < len(data):
+        type_, scale = data[pos] & 0x0F, data[pos] >> 4
+        end = data.index(b"\0", pos + 1)
+        key = data[pos + 1:end].decode("utf-8", "replace")
+        value, pos = get_varint(data, end + 1)
+        if type_ in (KV_TYPE_INT, KV_TYPE_FIXED):
+            value = (value >> 1) ^ -(value & 1)
+            if type_ == KV_TYPE_FIXED and scale:
+                sign = "-" if value < 0 else ""
+                int_part, frac_part = divmod(abs(value), 10 ** scale)
+                value = "%s%u.%0*u" % (sign, int_part, scale, frac_part)
+        elif type_ in (KV_TYPE_STR, KV_TYPE_BYTES):
+            raw = data[pos:pos + value]
+            pos += value
+            value = raw.decode("utf-8", "replace") if type_ == KV_TYPE_STR else raw.hex()
+        fields.append((key, type_, value))
+    return fields
+
+
+def render_fields(event, fields):
+    """Render the key-value fields like the device text mode."""
+    return " ".join([event] + ["%s=%s" % (key, value) for key, _, value in fields])
+
+
+def json_log(site, timestamp, seq, text=None, event=None, fields=None):
+    """Render the log as one JSON line, the fixed-point value is kept as a JSON number."""
+    log = {"seq": seq, "time": "%u.%06u" % divmod(timestamp, TIMESTAMP_PER_SEC)} if site else {}
+    if site:
+        log["level"] = LEVEL_INFO[site["level"]][0] if site["level"] < len(LEVEL_INFO) else "?"
+        log["tag"] = site["tag"]
+        for key in ("file", "line", "func"):
+            if site[key]:
+                log[key] = site[key]
+    if event is not None:
+        log["event"] = event
+        log["fields"] = {}
+        for key, type_, value in fields:
+            log["fields"][key] = json.loads(value) if type_ == KV_TYPE_FIXED else value
+    else:
+        log["text"] = text
+    return json.dumps(log)
+
+
+def render_log(site, timestamp, seq, text):
+    """Rebuild the log line like elog_output() with all formats enabled."""
+    level = LEVEL_INFO[site["level"]] if site["level"] < len(LEVEL_INFO) else "?/"
+    sec, frac = divmod(timestamp, TIMESTAMP_PER_SEC)
+    log = "%s%-*s #%u [%5u.%06u] " % (level, TAG_ALIGN_LEN, site["tag"] or "", seq, sec, frac)
+    where = site["file"] or ""
+    if site["line"]:
+        where += (":" if where else "") + str(site["line"])
+    if site["func"]:
+        where += (" " if where else "") + site["func"]
+    if where:
+        log += "(%s)" % where
+    return log + text
+
+
+def decode(stream, sites, out, as_json=False):
+    """Decode the frames in the stream, the unknown bytes are skipped."""
+    ptr_size = sites.elf.ptr_size
+    pos = 0
+    # the 32-bit timestamp is unwrapped, it is right when the log interval is less than the wrap
+    epoch = last_timestamp = 0
+    # the 16-bit sequence number is unwrapped by the distance from the last one
+    seq = -1
+    while pos < len(stream):
+        frame = stream[pos]
+        if frame == FRAME_TEXT and pos + 3 <= len(stream):
+            size, = struct.unpack_from("<H", stream, pos + 1)
+            text = stream[pos + 3:pos + 3 + size].decode("utf-8", "replace")
+            out.write(json_log(None, 0, None, text.rstrip("\r\n")) + "\n" if as_json else text)
+            pos += 3 + size
+        elif frame in (FRAME_SITE, FRAME_SITE_TEXT, FRAME_KV) and pos + 11 <= len(stream):
+            site_id, seq_low, timestamp = struct.unpack_from("<HHI", stream, pos + 1)
+            site = sites.get(site_id)
+            if site is None:
+                pos += 1
+                continue
+            if timestamp < last_timestamp:
+                epoch += TIMESTAMP_WRAP
+            last_timestamp = timestamp
+            seq = seq_low if seq < 0 else seq + ((seq_low - seq) % SEQ_WRAP)
+            if frame == FRAME_SITE:
+                word_num, str_size = stream[pos + 9], stream[pos + 10]
+                body = pos + 11
+                words = list(struct.unpack_from("<%dI" % word_num, stream, body))
+                strs = stream[body + word_num * 4:body + word_num * 4 + str_size]
+                text = format_args(site["format"], words, strs, ptr_size)
+                pos = body + word_num * 4 + str_size
+            elif frame == FRAME_KV:
+                size, = struct.unpack_from("<H", stream, pos + 9)
+                fields = decode_fields(stream[pos + 11:pos + 11 + size])
+                pos += 11 + size
+                if as_json:
+                    out.write(json_log(site, epoch + timestamp, seq, event=site["format"], fields=fields) + "\n")
+                    continue
+                text = render_fields(site["format"], fields)
+            else:
+                size, = struct.unpack_from("<H", stream, pos + 9)
+                text = stream[pos + 11:pos + 11 + size].decode("utf-8", "replace")
+                pos += 11 + size
+            if as_json:
+                out.write(json_log(site, epoch + timestamp, seq, text) + "\n")
+            else:
+                out.write(render_log(site, epoch + timestamp, seq, text) + "\n")
+        else:
+            pos += 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode EasyLogger binary output mode stream.")
+    parser.add_argument("elf", help="firmware ELF file, such as SRPIP.axf")
+    parser.add_argument("stream", nargs="?", help="binary stream file, default is stdin")
+    parser.add_argument("--json", action="store_true", help="output one JSON object for every log")
+    args = parser.parse_args()
+
+    sites = Sites(Elf(args.elf))
+    if args.stream:
+        with open(args.stream, "rb") as f:
+            stream = f.read()
+    else:
+        stream = sys.stdin.buffer.read()
+    decode(stream, sites, sys.stdout, args.json)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+#
+# This file is part of the EasyLogger Library.
+#
+# Copyright (c) 2025, Ethan-Hang
+#
+# Function: Render the EasyLogger raw hex dump stream. The chunks output by
+#           elog_hexdump_raw() are joined, then dumped as hex or saved as file.
+# Created on: 2026-10-17
+#
+# usage: elog_rawdump.py [--width 16] [--save DIR] [raw_stream.bin]
+#        the stream is read from stdin when the stream file is not given
+#
+
+import argparse
+import os
+import struct
+import sys
+
+RAW_FRAME = 0xE9
+# elog_port_get_timestamp() unit is microsecond, the frame only has it's low 32-bit
+TIMESTAMP_PER_SEC = 1000000
+
+
+def parse(stream):
+    """Parse the chunks in the stream, return (timestamp, name, total size, offset, data) list."""
+    chunks = []
+    pos = 0
+    while pos < len(stream):
+        if stream[pos] != RAW_FRAME or pos + 6 > len(stream):
+            pos += 1
+            continue
+        timestamp, name_size = struct.unpack_from("<IB", stream, pos + 1)
+        body = pos + 6 + name_size
+        if body + 10 > len(stream):
+            break
+        name = stream[pos + 6:body].decode("utf-8", "replace")
+        total, offset, size = struct.unpack_from("<IIH", stream, body)
+        data = stream[body + 10:body + 10 + size]
+        chunks.append((timestamp, name, total, offset, data))
+        pos = body + 10 + size
+    return chunks
+
+
+def join(chunks):
+    """Join the chunks of every dump, the device stops the dump at the first dropped chunk."""
+    dumps = []
+    for timestamp, name, total, offset, data in chunks:
+        if (offset == 0 or not dumps or dumps[-1]["name"] != name or dumps[-1]["total"] != total
+                or dumps[-1]["next"] != offset):
+            if offset != 0:
+                # the head of this dump is lost, such as the stream is captured from it's middle
+                continue
+            dumps.append({"timestamp": timestamp, "name": name, "total": total,
+                          "data": bytearray(), "next": 0})
+        dump = dumps[-1]
+        dump["data"] += data
+        dump["next"] = offset + len(data)
+    for dump in dumps:
+        dump["missing"] = dump["total"] - dump["next"]
+    return dumps
+
+
+def hexdump(dump, width, out):
+    """Dump the data like elog_hexdump()."""
+    sec, frac = divmod(dump["timestamp"], TIMESTAMP_PER_SEC)
+    out.write("RAW %s [%5u.%06u] %u bytes" % (dump["name"], sec, frac, dump["total"]))
+    out.write(", %u bytes are dropped\n" % dump["missing"] if dump["missing"] else "\n")
+    data = dump["data"]
+    for i in range(0, len(data), width):
+        line = data[i:i + width]
+        hex_text = ""
+        for j in range(width):
+            hex_text += "%02X " % line[j] if j < len(line) else "   "
+            if j % 8 == 7:
+                hex_text += " "
+        char_text = "".join(chr(b) if 0x20 <= b < 0x7F else "." for b in line)
+        out.write("D/HEX %s: %04X-%04X: %s  %s\n" % (dump["name"], i, i + width - 1, hex_text, char_text))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Render EasyLogger raw hex dump stream.")
+    parser.add_argument("stream", nargs="?", help="raw channel stream file, default is stdin")
+    parser.add_argument("--width", type=int, default=16, help="hex number for every line")
+    parser.add_argument("--save", metavar="DIR", help="save every dump as a file in the directory")
+    args = parser.parse_args()
+
+    if args.stream:
+        with open(args.stream, "rb") as f:
+            stream = f.read()
+    else:
+        stream = sys.stdin.buffer.read()
+    for index, dump in enumerate(join(parse(stream))):
+        if args.save:
+            path = os.path.join(args.save, "%04u_%s.bin" % (index, dump["name"]))
+            with open(path, "wb") as f:
+                f.write(dump["data"])
+            sys.stdout.write("%s: %u bytes\n" % (path, len(dump["data"])))
+        else:
+            hexdump(dump, args.width, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
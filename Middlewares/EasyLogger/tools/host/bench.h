@@ -0,0 +1,62 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Host benchmark helpers. Every case is run for some rounds, the
+ *           best round is reported to filter the host scheduling noise.
+ * Created on: 2026-10-17
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "elog_port_host.h"
+
+/* round number of every case, the best round is reported */
+#define BENCH_ROUND_NUM     7
+
+/* run the statement for loop number in every round, the result is the best time per loop, unit: ns */
+#define BENCH_RUN(result, loop_num, stmt)                                     \
+    do {                                                                      \
+        uint64_t bench_start, bench_time;                                     \
+        uint32_t bench_round, bench_loop;                                     \
+        (result) = UINT64_MAX;                                                \
+        for (bench_round = 0; bench_round < BENCH_ROUND_NUM; bench_round++) { \
+            bench_start = elog_port_host_now_ns();                            \
+            for (bench_loop = 0; bench_loop < (loop_num); bench_loop++) {     \
+                stmt;                                                         \
+            }                                                                 \
+            bench_time = (elog_port_host_now_ns() - bench_start) / (loop_num); \
+            if (bench_time < (result)) {                                      \
+                (result) = bench_time;                                        \
+            }                                                                 \
+        }                                                                     \
+    } while (0)
+
+/* print the result row */
+#define BENCH_PRINT(name, ns)  printf("  %-40s %8llu ns\n", (name), (unsigned long long) (ns))
+
+#endif /* __BENCH_H__ */
@@ -0,0 +1,109 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Deferred output benchmark. The cost in the log call is compared
+ *           between synchronous formatting and deferred argument capture,
+ *           the drain cost of the deferred logs is reported too.
+ * Created on: 2026-10-17
+ */
+
+#define LOG_TAG    "bench"
+
+#include <stdlib.h>
+
+#include "elog.h"
+#include "bench.h"
+
+/* log number of every batch, the deferred ring is drained between batches */
+#define BATCH_LOG_NUM       ELOG_DEFERRED_RECORD_NUM
+#define BATCH_NUM           1000
+
+/**
+ * output a batch of typical logs
+ *
+ * @param base the first value
+ */
+static void output_batch(uint32_t base) {
+    uint32_t i;
+
+    for (i = 0; i < BATCH_LOG_NUM; i++) {
+        log_i("sensor %d value %u state %s", (int) (i & 7), (unsigned int) (base + i), "ready");
+    }
+}
+
+/**
+ * run the batches, the deferred logs are drained after every batch
+ *
+ * @param call_ns best cost in the log call, unit: ns
+ * @param drain_ns best drain cost of every log, unit: ns
+ */
+static void run_batches(uint64_t *call_ns, uint64_t *drain_ns) {
+    uint64_t start, call_time, drain_time;
+    uint32_t round, batch;
+
+    *call_ns = UINT64_MAX;
+    *drain_ns = UINT64_MAX;
+    for (round = 0; round < BENCH_ROUND_NUM; round++) {
+        call_time = 0;
+        drain_time = 0;
+        for (batch = 0; batch < BATCH_NUM; batch++) {
+            start = elog_port_host_now_ns();
+            output_batch(batch * BATCH_LOG_NUM);
+            call_time += elog_port_host_now_ns() - start;
+            start = elog_port_host_now_ns();
+            elog_deferred_drain(BATCH_LOG_NUM);
+            drain_time += elog_port_host_now_ns() - start;
+        }
+        call_time /= BATCH_NUM * BATCH_LOG_NUM;
+        drain_time /= BATCH_NUM * BATCH_LOG_NUM;
+        if (call_time < *call_ns) {
+            *call_ns = call_time;
+        }
+        if (drain_time < *drain_ns) {
+            *drain_ns = drain_time;
+        }
+    }
+}
+
+int main(void) {
+    uint64_t sync_ns, deferred_ns, drain_ns, unused_ns;
+
+    elog_init();
+    elog_start();
+
+    printf("deferred output, log: \"sensor %%d value %%u state %%s\"\n");
+    elog_deferred_enabled(false);
+    run_batches(&sync_ns, &unused_ns);
+    BENCH_PRINT("sync output in log call", sync_ns);
+
+    elog_deferred_enabled(true);
+    run_batches(&deferred_ns, &drain_ns);
+    elog_deferred_enabled(false);
+    BENCH_PRINT("deferred capture in log call", deferred_ns);
+    BENCH_PRINT("deferred drain in idle, every log", drain_ns);
+    printf("  log call speedup %.1fx, dropped %u\n", (double) sync_ns / (deferred_ns ? deferred_ns : 1),
+            (unsigned int) elog_deferred_get_drop_num());
+
+    return elog_deferred_get_drop_num() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Log filter benchmark. The cost of the log call is reported when
+ *           the log is rejected by the level, tag level and tag filter of the
+ *           interned tag, or the disabled call site, the passed log is the base.
+ *           The keyword matcher is measured before and after formatting.
+ * Created on: 2026-10-17
+ */
+
+#define LOG_TAG    "bench"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "elog.h"
+#include "bench.h"
+
+#define LOOP_NUM            100000
+
+static volatile int value = 42;
+static size_t fail_num = 0;
+
+/**
+ * output a log by the constant tag
+ */
+static void log_const_tag(void) {
+    log_i("sensor %d state %s", value, "ready");
+}
+
+/**
+ * output a log which has no argument, the keyword is only matched before formatting
+ */
+static void log_no_args(void) {
+    log_i("sensor state ready");
+}
+
+/**
+ * output a log by the variable tag, it is found in the tag table by name
+ */
+static void log_var_tag(void) {
+    char tag[8] = "bench";
+
+    elog_i(tag, "sensor %d state %s", value, "ready");
+}
+
+/**
+ * run a filter case, the rejected log must not be output
+ *
+ * @param name case name
+ * @param log log function
+ * @param passed true: the log is passed by the filters
+ */
+static void filter_case(const char *name, void (*log)(void), bool passed) {
+    size_t output_size = elog_port_host_get_output_size();
+    uint64_t ns;
+
+    log();
+    if ((elog_port_host_get_output_size() != output_size) != passed) {
+        printf("  %-40s %s\n", name, passed ? "not output" : "not rejected");
+        fail_num++;
+        return;
+    }
+    BENCH_RUN(ns, LOOP_NUM, log());
+    BENCH_PRINT(name, ns);
+}
+
+int main(void) {
+    elog_init();
+    elog_start();
+    elog_deferred_enabled(false);
+
+    printf("log filter, the log call cost\n");
+    filter_case("passed, output", log_const_tag, true);
+    filter_case("passed, output, variable tag", log_var_tag, true);
+
+    elog_set_filter_lvl(ELOG_LVL_WARN);
+    filter_case("rejected by level", log_const_tag, false);
+    elog_set_filter_lvl(ELOG_FILTER_LVL_ALL);
+
+    elog_set_filter_tag_lvl(LOG_TAG, ELOG_LVL_WARN);
+    filter_case("rejected by tag level", log_const_tag, false);
+    filter_case("rejected by tag level, variable tag", log_var_tag, false);
+    elog_set_filter_tag_lvl(LOG_TAG, ELOG_FILTER_LVL_ALL);
+
+    elog_set_filter_tag("other");
+    filter_case("rejected by tag", log_const_tag, false);
+    elog_set_filter_tag("");
+
+    elog_site_set_enabled(LOG_TAG, NULL, 0, UINT32_MAX, ELOG_LVL_ASSERT, false);
+    filter_case("rejected by call site", log_const_tag, false);
+    elog_site_set_enabled(LOG_TAG, NULL, 0, UINT32_MAX, ELOG_LVL_ASSERT, true);
+
+    elog_set_filter_kw("sensor");
+    filter_case("keyword in format, passed", log_const_tag, true);
+    elog_set_filter_kw("ready");
+    filter_case("keyword in argument, passed", log_const_tag, true);
+    elog_set_filter_kw("motor");
+    filter_case("keyword, rejected before formatting", log_no_args, false);
+    filter_case("keyword, rejected after formatting", log_const_tag, false);
+    elog_add_filter_kw("pump");
+    elog_add_filter_kw("valve");
+    elog_add_filter_kw("fan");
+    filter_case("4 keywords, rejected before formatting", log_no_args, false);
+    filter_case("4 keywords, rejected after formatting", log_const_tag, false);
+    elog_set_filter_kw("");
+
+    /* all filters are removed */
+    filter_case("passed again, output", log_const_tag, true);
+
+    return fail_num ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,100 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Built-in formatter benchmark. Every case is formatted by the
+ *           built-in formatter and the C library vsnprintf, the results must
+ *           be same, and the cost of both is reported.
+ * Created on: 2026-10-17
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "elog.h"
+#include "bench.h"
+
+#define LOOP_NUM            100000
+#define FMT_BUF_SIZE        128
+
+static char elog_buf[FMT_BUF_SIZE];
+static char libc_buf[FMT_BUF_SIZE];
+/* the arguments are loaded in every call */
+static volatile int small_int = -42;
+static volatile unsigned int big_uint = 4000000000U;
+static volatile unsigned long long big_ull = 18000000000000000000ULL;
+static const char *volatile str = "sensor_ready";
+static int ptr_target;
+static void *volatile ptr = &ptr_target;
+static size_t fail_num = 0;
+
+/**
+ * format by the C library, it is called by va_list as the built-in formatter
+ */
+static int libc_snprintf(char *buf, size_t size, const char *format, ...) {
+    va_list args;
+    int result;
+
+    va_start(args, format);
+    result = vsnprintf(buf, size, format, args);
+    va_end(args);
+
+    return result;
+}
+
+/* run a format case, the results of both formatters are checked first */
+#define FMT_CASE(name, ...)                                                   \
+    do {                                                                      \
+        uint64_t elog_ns, libc_ns;                                            \
+        int elog_len = elog_snprintf(elog_buf, sizeof(elog_buf), __VA_ARGS__); \
+        int libc_len = libc_snprintf(libc_buf, sizeof(libc_buf), __VA_ARGS__); \
+        if (elog_len != libc_len || strcmp(elog_buf, libc_buf)) {             \
+            printf("  %-24s mismatched: \"%s\" \"%s\"\n", name, elog_buf, libc_buf); \
+            fail_num++;                                                       \
+            break;                                                            \
+        }                                                                     \
+        BENCH_RUN(elog_ns, LOOP_NUM, elog_snprintf(elog_buf, sizeof(elog_buf), __VA_ARGS__)); \
+        BENCH_RUN(libc_ns, LOOP_NUM, libc_snprintf(libc_buf, sizeof(libc_buf), __VA_ARGS__)); \
+        printf("  %-24s %8llu ns %8llu ns %6.1fx\n", name, (unsigned long long) elog_ns, \
+                (unsigned long long) libc_ns, (double) libc_ns / (elog_ns ? elog_ns : 1)); \
+    } while (0)
+
+int main(void) {
+    printf("built-in formatter\n  %-24s %11s %11s\n", "case", "built-in", "vsnprintf");
+    FMT_CASE("%d", "%d", small_int);
+    FMT_CASE("%u", "%u", big_uint);
+    FMT_CASE("%08x", "%08x", big_uint);
+    FMT_CASE("%s", "%s", str);
+    FMT_CASE("%-16s|", "%-16s|", str);
+    FMT_CASE("%c", "%c", 'A');
+    FMT_CASE("%p", "%p", ptr);
+#ifdef ELOG_BUILTIN_FMT_LLONG_ENABLE
+    FMT_CASE("%llu", "%llu", big_ull);
+#endif
+#ifdef ELOG_BUILTIN_FMT_FLOAT_ENABLE
+    FMT_CASE("%.3f", "%.3f", small_int / 7.0);
+#endif
+    FMT_CASE("typical log", "sensor %d value %u state %s", small_int, big_uint, str);
+
+    return fail_num ? EXIT_FAILURE : EXIT_SUCCESS;
+}
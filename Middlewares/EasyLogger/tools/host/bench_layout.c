@@ -0,0 +1,320 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Output layout benchmark. The log call cost is reported for every
+ *           format set which is compiled by elog_set_fmt(), with and without
+ *           the text color. The log head cost is compared with a reference
+ *           of the packaging before the compiled layout, which checks the
+ *           format set for every log. The compile cost of elog_set_fmt() is
+ *           reported too.
+ * Created on: 2026-10-17
+ */
+
+#define LOG_TAG    "bench"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "elog.h"
+#include "bench.h"
+
+#define LOOP_NUM            100000
+#define PASS_NUM            3
+#define CHECK_BUF_SIZE      (4 * ELOG_LINE_BUF_SIZE)
+
+/* the sign of the color end, it is same as the library */
+#define CSI_END             "\033[0m"
+
+static volatile int value = 42;
+
+/* the format sets to compare */
+static const struct {
+    const char *name;
+    size_t set;
+} fmt_sets[] = {
+    { "none",                 0 },
+    { "lvl",                  ELOG_FMT_LVL },
+    { "lvl|tag",              ELOG_FMT_LVL | ELOG_FMT_TAG },
+    { "lvl|tag|time",         ELOG_FMT_LVL | ELOG_FMT_TAG | ELOG_FMT_TIME },
+    { "lvl|tag|time|seq",     ELOG_FMT_LVL | ELOG_FMT_TAG | ELOG_FMT_TIME | ELOG_FMT_SEQ },
+    { "lvl|tag|dir|func|line", ELOG_FMT_LVL | ELOG_FMT_TAG | ELOG_FMT_DIR | ELOG_FMT_FUNC | ELOG_FMT_LINE },
+    { "all",                  ELOG_FMT_ALL },
+};
+#define FMT_SET_NUM         (sizeof(fmt_sets) / sizeof(fmt_sets[0]))
+
+/* the baseline's format set and color setting, they are checked for every log as before */
+static size_t baseline_fmt_set[ELOG_LVL_TOTAL_NUM];
+static bool baseline_color = false;
+/* the color sign of the info level, it is probed from the library output */
+static char baseline_color_info[32];
+static char baseline_buf[ELOG_LINE_BUF_SIZE];
+
+/**
+ * output a short log, the log head is the most part of the cost
+ */
+static void log_short(void) {
+    log_i("value %d", value);
+}
+
+static bool baseline_fmt_enabled(uint8_t level, size_t set) {
+    return (baseline_fmt_set[level] & set) ? true : false;
+}
+
+/**
+ * The reference of the log packaging before the compiled layout. The format set
+ * is checked for every part of the log head. The time is rendered by the current
+ * port interface, and the sequence number is packaged at the same position as the
+ * layout, so the output is same as the library.
+ *
+ * @param buf log buffer
+ * @param level level
+ * @param tag tag
+ * @param file file name
+ * @param func function name
+ * @param line line number
+ * @param format output format
+ * @param ... args
+ *
+ * @return packaged log length
+ */
+static size_t baseline_package(char *buf, uint8_t level, const char *tag, const char *file, const char *func,
+        long line, const char *format, ...) {
+    extern size_t elog_port_timestamp_render(char *buf, uint64_t timestamp);
+    extern uint64_t elog_port_get_timestamp(void);
+    extern const char *elog_port_get_p_info(void);
+    extern const char *elog_port_get_t_info(void);
+    static const char *level_output_info[] = { "A/", "E/", "W/", "I/", "D/", "V/" };
+    size_t tag_len = strlen(tag), log_len = 0, newline_len = strlen(ELOG_NEWLINE_SIGN);
+    char line_num[ELOG_LINE_NUM_MAX_LEN + 1] = { 0 };
+    char tag_space[ELOG_FILTER_TAG_MAX_LEN / 2 + 1] = { 0 };
+    va_list args;
+    int fmt_result;
+
+    if (baseline_color) {
+        log_len += elog_strcpy(log_len, buf + log_len, baseline_color_info);
+    }
+    if (baseline_fmt_enabled(level, ELOG_FMT_LVL)) {
+        log_len += elog_strcpy(log_len, buf + log_len, level_output_info[level]);
+    }
+    if (baseline_fmt_enabled(level, ELOG_FMT_TAG)) {
+        log_len += elog_strcpy(log_len, buf + log_len, tag);
+        if (tag_len <= ELOG_FILTER_TAG_MAX_LEN / 2) {
+            memset(tag_space, ' ', ELOG_FILTER_TAG_MAX_LEN / 2 - tag_len);
+            log_len += elog_strcpy(log_len, buf + log_len, tag_space);
+        }
+        log_len += elog_strcpy(log_len, buf + log_len, " ");
+    }
+    if (baseline_fmt_enabled(level, ELOG_FMT_SEQ)) {
+        log_len += elog_strcpy(log_len, buf + log_len, "#");
+        log_len += elog_u32toa(buf + log_len, elog_seq_next());
+        log_len += elog_strcpy(log_len, buf + log_len, " ");
+    }
+    if (baseline_fmt_enabled(level, ELOG_FMT_TIME | ELOG_FMT_P_INFO | ELOG_FMT_T_INFO)) {
+        log_len += elog_strcpy(log_len, buf + log_len, "[");
+        if (baseline_fmt_enabled(level, ELOG_FMT_TIME)) {
+            log_len += elog_port_timestamp_render(buf + log_len, elog_port_get_timestamp());
+            if (baseline_fmt_enabled(level, ELOG_FMT_P_INFO | ELOG_FMT_T_INFO)) {
+                log_len += elog_strcpy(log_len, buf + log_len, " ");
+            }
+        }
+        if (baseline_fmt_enabled(level, ELOG_FMT_P_INFO)) {
+            log_len += elog_strcpy(log_len, buf + log_len, elog_port_get_p_info());
+            if (baseline_fmt_enabled(level, ELOG_FMT_T_INFO)) {
+                log_len += elog_strcpy(log_len, buf + log_len, " ");
+            }
+        }
+        if (baseline_fmt_enabled(level, ELOG_FMT_T_INFO)) {
+            log_len += elog_strcpy(log_len, buf + log_len, elog_port_get_t_info());
+        }
+        log_len += elog_strcpy(log_len, buf + log_len, "] ");
+    }
+    if ((file && baseline_fmt_enabled(level, ELOG_FMT_DIR)) || (func && baseline_fmt_enabled(level, ELOG_FMT_FUNC))
+            || (line && baseline_fmt_enabled(level, ELOG_FMT_LINE))) {
+        log_len += elog_strcpy(log_len, buf + log_len, "(");
+        if (file && baseline_fmt_enabled(level, ELOG_FMT_DIR)) {
+            log_len += elog_strcpy(log_len, buf + log_len, file);
+            if (func && baseline_fmt_enabled(level, ELOG_FMT_FUNC)) {
+                log_len += elog_strcpy(log_len, buf + log_len, ":");
+            } else if (line && baseline_fmt_enabled(level, ELOG_FMT_LINE)) {
+                log_len += elog_strcpy(log_len, buf + log_len, " ");
+            }
+        }
+        if (line && baseline_fmt_enabled(level, ELOG_FMT_LINE)) {
+            elog_snprintf(line_num, ELOG_LINE_NUM_MAX_LEN, "%ld", line);
+            log_len += elog_strcpy(log_len, buf + log_len, line_num);
+            if (func && baseline_fmt_enabled(level, ELOG_FMT_FUNC)) {
+                log_len += elog_strcpy(log_len, buf + log_len, " ");
+            }
+        }
+        if (func && baseline_fmt_enabled(level, ELOG_FMT_FUNC)) {
+            log_len += elog_strcpy(log_len, buf + log_len, func);
+        }
+        log_len += elog_strcpy(log_len, buf + log_len, ")");
+    }
+
+    va_start(args, format);
+    fmt_result = elog_vsnprintf(buf + log_len, ELOG_LINE_BUF_SIZE - log_len, format, args);
+    va_end(args);
+    if ((log_len + fmt_result <= ELOG_LINE_BUF_SIZE) && (fmt_result > -1)) {
+        log_len += fmt_result;
+    } else {
+        log_len = ELOG_LINE_BUF_SIZE;
+    }
+    if (log_len + (sizeof(CSI_END) - 1) + newline_len > ELOG_LINE_BUF_SIZE) {
+        log_len = ELOG_LINE_BUF_SIZE - (sizeof(CSI_END) - 1) - newline_len;
+    }
+    if (baseline_color) {
+        log_len += elog_strcpy(log_len, buf + log_len, CSI_END);
+    }
+    log_len += elog_strcpy(log_len, buf + log_len, ELOG_NEWLINE_SIGN);
+
+    return log_len;
+}
+
+/**
+ * package the short log by the baseline, it is same as log_short()
+ *
+ * @return packaged log length
+ */
+static size_t baseline_short(void) {
+    return baseline_package(baseline_buf, ELOG_LVL_INFO, LOG_TAG, __FILE__, "log_short", __LINE__, "value %d", value);
+}
+
+/**
+ * compare the logs, the digits such as time, sequence and line number are skipped
+ *
+ * @return true: same
+ */
+static bool log_same(const char *log1, size_t size1, const char *log2, size_t size2) {
+    size_t i = 0, j = 0;
+
+    while (i < size1 && j < size2) {
+        if (isdigit((unsigned char) log1[i]) && isdigit((unsigned char) log2[j])) {
+            while (i < size1 && isdigit((unsigned char) log1[i])) i++;
+            while (j < size2 && isdigit((unsigned char) log2[j])) j++;
+        } else if (log1[i++] != log2[j++]) {
+            return false;
+        }
+    }
+
+    return i == size1 && j == size2;
+}
+
+/**
+ * set the format set and color of the library and the baseline, check both output are same
+ *
+ * @return true: same
+ */
+static bool layout_set(size_t set, bool color) {
+    static char check_buf[CHECK_BUF_SIZE];
+    size_t size;
+
+    elog_set_fmt(ELOG_LVL_INFO, set);
+    elog_set_text_color_enabled(color);
+    baseline_fmt_set[ELOG_LVL_INFO] = set;
+    baseline_color = color;
+
+    elog_port_host_capture(check_buf, sizeof(check_buf));
+    log_short();
+    size = elog_port_host_get_output_size();
+    elog_port_host_capture(NULL, 0);
+
+    return log_same(check_buf, size, baseline_buf, baseline_short());
+}
+
+#ifdef ELOG_COLOR_ENABLE
+/**
+ * probe the color sign of the info level by the library output without log head
+ */
+static void probe_color_info(void) {
+    char check_buf[CHECK_BUF_SIZE];
+    const char *end;
+
+    elog_set_fmt(ELOG_LVL_INFO, 0);
+    elog_set_text_color_enabled(true);
+    elog_port_host_capture(check_buf, sizeof(check_buf));
+    log_short();
+    elog_port_host_capture(NULL, 0);
+    end = strstr(check_buf, "value");
+    if (end && (size_t) (end - check_buf) < sizeof(baseline_color_info)) {
+        memcpy(baseline_color_info, check_buf, end - check_buf);
+    }
+}
+#endif
+
+int main(void) {
+    uint64_t call_ns[2][FMT_SET_NUM], base_ns[2][FMT_SET_NUM], ns, set_ns;
+    size_t i, mismatched = 0;
+    int color, color_num = 1, pass;
+
+    elog_init();
+    elog_start();
+    elog_deferred_enabled(false);
+#ifdef ELOG_COLOR_ENABLE
+    probe_color_info();
+    color_num = 2;
+#endif
+
+    /* the cases are run in some passes and the best one is kept, so the host noise is spread */
+    memset(call_ns, 0xFF, sizeof(call_ns));
+    memset(base_ns, 0xFF, sizeof(base_ns));
+    for (pass = 0; pass < PASS_NUM; pass++) {
+        for (color = 0; color < color_num; color++) {
+            for (i = 0; i < FMT_SET_NUM; i++) {
+                if (!layout_set(fmt_sets[i].set, color)) {
+                    if (pass == 0) {
+                        printf("  %s%s: the baseline output is not same\n", fmt_sets[i].name, color ? " color" : "");
+                    }
+                    mismatched++;
+                }
+                BENCH_RUN(ns, LOOP_NUM, log_short());
+                call_ns[color][i] = ns < call_ns[color][i] ? ns : call_ns[color][i];
+                BENCH_RUN(ns, LOOP_NUM, baseline_short());
+                base_ns[color][i] = ns < base_ns[color][i] ? ns : base_ns[color][i];
+            }
+        }
+    }
+
+    /* the head cost is the packaging cost more than the log without head */
+    printf("output layout, the log head cost of the compiled layout and the baseline which checks the format set\n");
+    printf("for every log, and the log call cost\n");
+    printf("  %-26s %11s %11s %11s %11s\n", "format set", "head", "baseline", "color head", "baseline");
+    for (i = 0; i < FMT_SET_NUM; i++) {
+        printf("  %-26s", fmt_sets[i].name);
+        for (color = 0; color < color_num; color++) {
+            printf(" %8llu ns %8llu ns",
+                    (unsigned long long) (call_ns[color][i] > call_ns[color][0] ? call_ns[color][i] - call_ns[color][0] : 0),
+                    (unsigned long long) (base_ns[color][i] > base_ns[color][0] ? base_ns[color][i] - base_ns[color][0] : 0));
+        }
+        printf("\n");
+    }
+    BENCH_PRINT("log call, none", call_ns[0][0]);
+    BENCH_PRINT("log call, all", call_ns[0][FMT_SET_NUM - 1]);
+    /* the layout is compiled once when the format set is changed */
+    BENCH_RUN(set_ns, LOOP_NUM, elog_set_fmt(ELOG_LVL_INFO, ELOG_FMT_ALL));
+    BENCH_PRINT("elog_set_fmt() compile", set_ns);
+
+    return mismatched ? EXIT_FAILURE : EXIT_SUCCESS;
+}
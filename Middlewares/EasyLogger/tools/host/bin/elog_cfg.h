@@ -0,0 +1,44 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Host binary output configuration for the decoder round trip test.
+ * Created on: 2026-10-17
+ */
+
+#ifndef _ELOG_HOST_BIN_CFG_H_
+#define _ELOG_HOST_BIN_CFG_H_
+
+#include "../elog_cfg.h"
+
+/* binary output mode, the stream is decoded by tools/elog_decode.py */
+#ifndef ELOG_BIN_OUTPUT_ENABLE
+#define ELOG_BIN_OUTPUT_ENABLE
+#endif
+
+/* the site logs are routed to the sinks, the round trip checks a record sink gets them too */
+#ifndef ELOG_SINK_ENABLE
+#define ELOG_SINK_ENABLE
+#endif
+
+#endif /* _ELOG_HOST_BIN_CFG_H_ */
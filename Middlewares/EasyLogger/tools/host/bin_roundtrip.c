@@ -0,0 +1,160 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Binary output round trip program. The logs are output as the binary
+ *           stream, and the expected text of every log is formatted by the C
+ *           library. test_elog_decode.py decodes the stream with this ELF file
+ *           and checks the text. It must be linked without PIE, so the string
+ *           pointers in the call sites are the final addresses. A record
+ *           sink checks the binary site logs are routed to the sinks too.
+ * Created on: 2026-10-17
+ */
+
+#define LOG_TAG    "rt"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "elog.h"
+#include "elog_port_host.h"
+
+#define STREAM_BUF_SIZE     4096
+
+static char stream_buf[STREAM_BUF_SIZE];
+static FILE *expected_file;
+static const char level_sign[] = "AEWIDV";
+/* the logs which are output to the record sink */
+static size_t sink_num, sink_args_num;
+static uint32_t sink_last_seq;
+static bool sink_seq_broken;
+
+/**
+ * record sink output, the site log which arguments are captured is not packaged
+ *
+ * @param record log record
+ *
+ * @return output size
+ */
+static size_t record_output(const ElogRecord *record) {
+    if (sink_num && record->seq <= sink_last_seq) {
+        sink_seq_broken = true;
+    }
+    sink_last_seq = record->seq;
+    sink_num++;
+    if (record->args) {
+        sink_args_num++;
+    }
+
+    return 1;
+}
+
+static ElogSink record_sink = { "record", record_output, ELOG_LVL_VERBOSE, ELOG_SINK_RECORD, NULL, 0 };
+
+/**
+ * write the expected text of a log
+ *
+ * @param level log level, ELOG_LVL_TOTAL_NUM: the raw line
+ * @param format format of the expected text
+ */
+static void expect(uint8_t level, const char *format, ...) {
+    va_list args;
+
+    if (level < ELOG_LVL_TOTAL_NUM) {
+        fprintf(expected_file, "%c/%s|", level_sign[level], LOG_TAG);
+    } else {
+        fprintf(expected_file, "raw|");
+    }
+    va_start(args, format);
+    vfprintf(expected_file, format, args);
+    va_end(args);
+    fputc('\n', expected_file);
+}
+
+int main(int argc, char *argv[]) {
+    static const uint8_t bytes[] = { 0x0A, 0x0B, 0xFF };
+    const char *long_str = "a string which is longer than the captured string buffer";
+    unsigned long long u64 = 0x123456789ABCDEF0ULL;
+    long long s64 = -1234567890123LL;
+    FILE *stream_file;
+
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s stream.bin expected.txt\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    expected_file = fopen(argv[2], "w");
+    if (expected_file == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    elog_port_host_capture(stream_buf, sizeof(stream_buf));
+    elog_init();
+    elog_sink_register(&record_sink);
+    elog_start();
+    elog_deferred_enabled(false);
+    /* the initialize log is output before the capture is reset */
+    elog_port_host_capture(stream_buf, sizeof(stream_buf));
+    sink_num = 0;
+    sink_args_num = 0;
+
+    /* site frame with captured arguments */
+    log_i("sensor %d value %u state %s", -5, 3000000000U, "ok");
+    expect(ELOG_LVL_INFO, "sensor %d value %u state %s", -5, 3000000000U, "ok");
+    log_w("hex %08x char %c width %5d|%-5s|", 0xBEEFU, 'Z', 42, "ab");
+    expect(ELOG_LVL_WARN, "hex %08x char %c width %5d|%-5s|", 0xBEEFU, 'Z', 42, "ab");
+    /* 64-bit arguments */
+    log_e("u64 %llu hex %llx s64 %lld long %ld", u64, u64, s64, -7L);
+    expect(ELOG_LVL_ERROR, "u64 %llu hex %llx s64 %lld long %ld", u64, u64, s64, -7L);
+    /* 9 arguments are more than the captured words, the site frame has the formatted text */
+    log_d("%d %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8, 9);
+    expect(ELOG_LVL_DEBUG, "%d %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8, 9);
+    /* the string which is longer than the captured string buffer */
+    log_v("long %s", long_str);
+    expect(ELOG_LVL_VERBOSE, "long %s", long_str);
+    /* key-value frame */
+    log_kv(ELOG_LVL_INFO, "motor", ELOG_KV_INT("rpm", -1200), ELOG_KV_UINT("cnt", 70000),
+            ELOG_KV_FIXED("temp", -325, 2), ELOG_KV_STR("name", "fan"), ELOG_KV_BYTES("raw", bytes, sizeof(bytes)));
+    expect(ELOG_LVL_INFO, "motor rpm=-1200 cnt=70000 temp=-3.25 name=fan raw=0a0bff");
+    /* raw line */
+    elog_raw("raw line %d\r\n", 7);
+    expect(ELOG_LVL_TOTAL_NUM, "raw line %d", 7);
+
+    stream_file = fopen(argv[1], "wb");
+    if (stream_file == NULL) {
+        return EXIT_FAILURE;
+    }
+    fwrite(stream_buf, 1, elog_port_host_get_output_size(), stream_file);
+    fclose(stream_file);
+    fclose(expected_file);
+
+    /* the key-value frame is output to port directly, the other logs are routed to the record sink,
+     * only the first 3 site logs have the captured arguments */
+    if (sink_num != 6 || sink_args_num != 3 || sink_seq_broken) {
+        fprintf(stderr, "record sink got %u logs, %u with arguments, sequence %s\n", (unsigned int) sink_num,
+                (unsigned int) sink_args_num, sink_seq_broken ? "broken" : "ok");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,41 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Host benchmark configuration. The firmware configuration is used,
+ *           only the options which are needed by the host benchmarks are added.
+ * Created on: 2026-10-17
+ */
+
+#ifndef _ELOG_HOST_CFG_H_
+#define _ELOG_HOST_CFG_H_
+
+/* the firmware configuration, the benchmark measures the same layout and buffer size */
+#include "../../inc/elog_cfg.h"
+
+/* deferred output mode, it is enabled at runtime by the deferred benchmark only */
+#ifndef ELOG_DEFERRED_OUTPUT_ENABLE
+#define ELOG_DEFERRED_OUTPUT_ENABLE
+#endif
+
+#endif /* _ELOG_HOST_CFG_H_ */
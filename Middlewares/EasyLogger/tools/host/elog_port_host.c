@@ -0,0 +1,364 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Host stub port for the benchmarks and stress tests. The log is
+ *           copied to a RTT like buffer or captured for checking, the POSIX
+ *           signals are masked by the output lock as the simulated interrupts.
+ * Created on: 2026-10-17
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+
+#include "elog.h"
+#include "elog_port_host.h"
+
+/* RTT like output buffer, the log is only copied to it */
+#define RTT_BUF_SIZE        4096
+
+static char rtt_buf[RTT_BUF_SIZE];
+static size_t rtt_index = 0;
+/* captured output buffer, NULL: the log is not captured */
+static char *capture_buf = NULL;
+static size_t capture_size = 0;
+static volatile size_t output_size = 0;
+/* simulated interrupts which are masked by output lock, the lock is only counted when it is empty */
+static sigset_t irq_set;
+static volatile int irq_sim = 0;
+/* output lock nested number, the signal mask and time before the first output lock */
+static volatile uint32_t lock_nest = 0;
+static sigset_t lock_irq_set;
+static uint64_t lock_start_time = 0;
+static HostLockStat lock_stat = { 0 };
+
+
+/**
+ * EasyLogger port initialize
+ *
+ * @return result
+ */
+ElogErrCode elog_port_init(void)
+{
+    return ELOG_NO_ERR;
+}
+
+/**
+ * EasyLogger port deinitialize
+ *
+ */
+void elog_port_deinit(void)
+{
+}
+
+/**
+ * output log port interface
+ *
+ * @param log output of log
+ * @param size log size
+ *
+ * @return output size, the log is dropped when it is 0 and truncated when it is less than size
+ */
+size_t elog_port_output(const char *log, size_t size)
+{
+    size_t len, put_size;
+
+    if (capture_buf)
+    {
+        if (output_size + size > capture_size)
+        {
+            return 0;
+        }
+        memcpy(capture_buf + output_size, log, size);
+        output_size += size;
+        return size;
+    }
+    /* only the copy cost is kept, the old log is overwritten */
+    for (put_size = 0; put_size < size; put_size += len)
+    {
+        len = RTT_BUF_SIZE - rtt_index;
+        len = (size - put_size < len) ? size - put_size : len;
+        memcpy(rtt_buf + rtt_index, log + put_size, len);
+        rtt_index = (rtt_index + len) & (RTT_BUF_SIZE - 1);
+    }
+    output_size += size;
+
+    return size;
+}
+
+/**
+ * reserve output space in RTT like buffer, it is never split
+ *
+ * @param size reserve size
+ * @param span reserved space
+ *
+ * @return true: reserved, false: there is no space, the log will be dropped
+ */
+bool elog_port_output_reserve(size_t size, ElogSpan *span)
+{
+    if (size > RTT_BUF_SIZE)
+    {
+        return false;
+    }
+    span->buf[0]  = rtt_buf;
+    span->size[0] = size;
+    span->buf[1]  = NULL;
+    span->size[1] = 0;
+
+    return true;
+}
+
+/**
+ * commit the output space which is reserved by elog_port_output_reserve
+ *
+ * @param size written size
+ */
+void elog_port_output_commit(size_t size)
+{
+    elog_port_output(rtt_buf, size);
+}
+
+#ifdef ELOG_HEXDUMP_RAW_ENABLE
+/**
+ * output the raw hex dump chunk, the head and data are output together
+ *
+ * @param head chunk head
+ * @param head_size chunk head size
+ * @param data chunk data
+ * @param size chunk data size
+ *
+ * @return true: output
+ */
+bool elog_port_raw_output(const void *head, size_t head_size, const void *data, size_t size)
+{
+    elog_port_output(head, head_size);
+    elog_port_output(data, size);
+
+    return true;
+}
+#endif /* ELOG_HEXDUMP_RAW_ENABLE */
+
+/**
+ * output lock, the simulated interrupts are masked as PRIMASK
+ */
+void elog_port_output_lock(void)
+{
+    sigset_t old_set;
+
+    if (irq_sim)
+    {
+        sigprocmask(SIG_BLOCK, &irq_set, &old_set);
+    }
+    if (lock_nest++ == 0)
+    {
+        if (irq_sim)
+        {
+            lock_irq_set    = old_set;
+            lock_start_time = elog_port_host_now_ns();
+        }
+        lock_stat.num++;
+    }
+    if (lock_nest > lock_stat.max_nest)
+    {
+        lock_stat.max_nest = lock_nest;
+    }
+}
+
+/**
+ * output unlock
+ */
+void elog_port_output_unlock(void)
+{
+    uint64_t elapsed;
+
+    if (--lock_nest == 0 && irq_sim)
+    {
+        elapsed = elog_port_host_now_ns() - lock_start_time;
+        if (elapsed > lock_stat.max_time)
+        {
+            lock_stat.max_time = elapsed;
+        }
+        if (elapsed / HOST_LOCK_HIST_STEP < HOST_LOCK_HIST_NUM - 1)
+        {
+            lock_stat.hist[elapsed / HOST_LOCK_HIST_STEP]++;
+        }
+        else
+        {
+            lock_stat.hist[HOST_LOCK_HIST_NUM - 1]++;
+        }
+        sigprocmask(SIG_SETMASK, &lock_irq_set, NULL);
+    }
+}
+
+/**
+ * get current timestamp interface
+ *
+ * @return current timestamp, unit: microsecond
+ */
+uint64_t elog_port_get_timestamp(void)
+{
+    return elog_port_host_now_ns() / 1000;
+}
+
+/**
+ * render the timestamp to time string interface
+ *
+ * @param buf output buffer, it's size is ELOG_TIME_STR_MAX_LEN at least
+ * @param timestamp timestamp from elog_port_get_timestamp
+ *
+ * @return string length
+ */
+size_t elog_port_timestamp_render(char *buf, uint64_t timestamp)
+{
+    size_t len = elog_u64toa(buf, timestamp);
+
+    buf[len] = '\0';
+
+    return len;
+}
+
+/**
+ * get current process name interface
+ *
+ * @return current process name
+ */
+const char *elog_port_get_p_info(void)
+{
+    return "";
+}
+
+/**
+ * get current thread name interface
+ *
+ * @return current thread name
+ */
+const char *elog_port_get_t_info(void)
+{
+    return "";
+}
+
+/**
+ * capture the output log to the buffer, the log is dropped when the buffer is full
+ *
+ * @param buf capture buffer, NULL: the log is only copied to the RTT like buffer
+ * @param size buffer size
+ */
+void elog_port_host_capture(char *buf, size_t size)
+{
+    capture_buf  = buf;
+    capture_size = size;
+    output_size  = 0;
+}
+
+/**
+ * get the output size since the capture is set
+ *
+ * @return output size
+ */
+size_t elog_port_host_get_output_size(void)
+{
+    return output_size;
+}
+
+/**
+ * Set the signals which are the simulated interrupts. They are masked by the
+ * output lock, and the lock time is measured.
+ *
+ * @param set simulated interrupt signals, NULL: there is no simulated interrupt
+ */
+void elog_port_host_irq_sim(const sigset_t *set)
+{
+    if (set)
+    {
+        irq_set = *set;
+        irq_sim = 1;
+    }
+    else
+    {
+        irq_sim = 0;
+    }
+}
+
+/**
+ * get the output lock statistic
+ *
+ * @param stat statistic
+ */
+void elog_port_host_get_lock_stat(HostLockStat *stat)
+{
+    *stat = lock_stat;
+}
+
+/**
+ * reset the output lock statistic
+ */
+void elog_port_host_reset_lock_stat(void)
+{
+    memset(&lock_stat, 0, sizeof(lock_stat));
+}
+
+/**
+ * get the lock time by the percentile of the lock histogram
+ *
+ * @param stat statistic
+ * @param percent percentile, such as 99.9
+ *
+ * @return the upper bound of the lock time, UINT64_MAX: it is longer than the histogram, unit: ns
+ */
+uint64_t elog_port_host_get_lock_time(const HostLockStat *stat, double percent)
+{
+    uint64_t total = 0, num = 0;
+    size_t i;
+
+    for (i = 0; i < HOST_LOCK_HIST_NUM; i++)
+    {
+        total += stat->hist[i];
+    }
+    for (i = 0; i < HOST_LOCK_HIST_NUM - 1; i++)
+    {
+        num += stat->hist[i];
+        if (num * 100.0 >= total * percent)
+        {
+            return (uint64_t) (i + 1) * HOST_LOCK_HIST_STEP;
+        }
+    }
+
+    return UINT64_MAX;
+}
+
+/**
+ * get the monotonic time
+ *
+ * @return time, unit: ns
+ */
+uint64_t elog_port_host_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
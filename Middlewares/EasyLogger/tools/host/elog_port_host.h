@@ -0,0 +1,60 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Host stub port for the benchmarks and stress tests.
+ * Created on: 2026-10-17
+ */
+
+#ifndef __ELOG_PORT_HOST_H__
+#define __ELOG_PORT_HOST_H__
+
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* lock time histogram step and bucket number, the last bucket counts the longer time, unit: ns */
+#define HOST_LOCK_HIST_STEP     100
+#define HOST_LOCK_HIST_NUM      101
+
+/* lock statistic of the host port */
+typedef struct {
+    /* max time which the simulated interrupts are masked by the output lock, unit: ns */
+    uint64_t max_time;
+    /* max nested lock number */
+    uint32_t max_nest;
+    /* lock number */
+    uint32_t num;
+    /* lock number by the lock time, the max time includes the host scheduling, so the percentile is needed */
+    uint32_t hist[HOST_LOCK_HIST_NUM];
+} HostLockStat;
+
+void elog_port_host_capture(char *buf, size_t size);
+size_t elog_port_host_get_output_size(void);
+void elog_port_host_irq_sim(const sigset_t *irq_set);
+void elog_port_host_get_lock_stat(HostLockStat *stat);
+void elog_port_host_reset_lock_stat(void);
+uint64_t elog_port_host_get_lock_time(const HostLockStat *stat, double percent);
+uint64_t elog_port_host_now_ns(void);
+
+#endif /* __ELOG_PORT_HOST_H__ */
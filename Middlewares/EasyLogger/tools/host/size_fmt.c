@@ -0,0 +1,73 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Formatter code size program for "make size". It is built without
+ *           formatter, with the built-in formatter and with the C library
+ *           vsnprintf, the size more than the one without formatter is the
+ *           formatter's code and data.
+ * Created on: 2026-10-17
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "elog.h"
+
+static char buf[128];
+static volatile int value = 42;
+
+/**
+ * format the log by the formatter which is selected by SIZE_FMT_xxx
+ *
+ * @param buf output buffer
+ * @param size buffer size
+ * @param format output format
+ * @param ... args
+ *
+ * @return formatted length
+ */
+static int format(char *buf, size_t size, const char *format, ...) {
+    va_list args;
+    int result = 0;
+
+    va_start(args, format);
+#if defined(SIZE_FMT_elog)
+    result = elog_vsnprintf(buf, size, format, args);
+#elif defined(SIZE_FMT_libc)
+    result = vsnprintf(buf, size, format, args);
+#else
+    (void) buf;
+    (void) size;
+    (void) format;
+#endif
+    va_end(args);
+
+    return result;
+}
+
+int main(void) {
+    /* the conversions which are used by the logs, the float is not enabled in both */
+    return format(buf, sizeof(buf), "%d %u %x %08X %s %-8s %c %p %ld", value, (unsigned int) value, value,
+            value, "str", "pad", 'c', (void *) buf, (long) value);
+}
@@ -0,0 +1,234 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Nested ISR preemption stress test. Two POSIX timer signals are
+ *           the simulated interrupts, the higher one preempts the lower one,
+ *           and both preempt the main loop logs. The captured lines are
+ *           checked to be whole and in order, and the max time which the
+ *           interrupts are masked by the output lock is reported.
+ * Created on: 2026-10-17
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define LOG_TAG    "stress"
+
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "elog.h"
+#include "bench.h"
+
+/* log contexts: main loop, low priority ISR and high priority ISR */
+#define CTX_MAIN            0
+#define CTX_ISR_LOW         1
+#define CTX_ISR_HIGH        2
+#define CTX_NUM             3
+
+/* simulated interrupt period, unit: ns */
+#define ISR_LOW_PERIOD      37000
+#define ISR_HIGH_PERIOD     101000
+/* stress test time, unit: ms */
+#define RUN_TIME            500
+/* captured output buffer size, the test is stopped before it is full */
+#define CAPTURE_BUF_SIZE    (16 * 1024 * 1024)
+#define CAPTURE_STOP_SIZE   (CAPTURE_BUF_SIZE - 64 * 1024)
+
+/* the log data is a part of the pad string, so the line content is checked */
+static const char pad[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+#define PAD_MAX_OFFSET      (sizeof(pad) - 1)
+
+static char capture_buf[CAPTURE_BUF_SIZE];
+/* next log number of every context */
+static volatile uint32_t log_num[CTX_NUM] = { 0 };
+/* current log context, it is used to count the preemption */
+static volatile int cur_ctx = -1;
+/* the log number which preempts a log of other context */
+static volatile uint32_t preempt_num[CTX_NUM] = { 0 };
+static timer_t isr_timer[CTX_NUM];
+
+/**
+ * output a log of the context
+ *
+ * @param ctx log context
+ */
+static void ctx_log(int ctx) {
+    int last_ctx = cur_ctx;
+    uint32_t n = log_num[ctx]++;
+
+    if (last_ctx >= 0) {
+        preempt_num[ctx]++;
+    }
+    cur_ctx = ctx;
+    log_i("ctx %d n %u data %s", ctx, (unsigned int) n, pad + n % PAD_MAX_OFFSET);
+    cur_ctx = last_ctx;
+}
+
+static void isr_low_handler(int sig) {
+    ctx_log(CTX_ISR_LOW);
+}
+
+static void isr_high_handler(int sig) {
+    ctx_log(CTX_ISR_HIGH);
+}
+
+/**
+ * start the simulated interrupt
+ *
+ * @param ctx log context of the interrupt
+ * @param sig interrupt signal
+ * @param handler interrupt handler
+ * @param mask the signals which can't preempt the handler
+ * @param period interrupt period, unit: ns
+ */
+static void isr_start(int ctx, int sig, void (*handler)(int), const sigset_t *mask, long period) {
+    struct sigaction action;
+    struct sigevent event;
+    struct itimerspec spec;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handler;
+    action.sa_mask = *mask;
+    sigaction(sig, &action, NULL);
+
+    memset(&event, 0, sizeof(event));
+    event.sigev_notify = SIGEV_SIGNAL;
+    event.sigev_signo = sig;
+    timer_create(CLOCK_MONOTONIC, &event, &isr_timer[ctx]);
+    spec.it_value.tv_sec = 0;
+    spec.it_value.tv_nsec = period;
+    spec.it_interval = spec.it_value;
+    timer_settime(isr_timer[ctx], 0, &spec, NULL);
+}
+
+/**
+ * check the captured lines, every line must be whole and the log number of every context is increased
+ *
+ * @param line_num line number of every context
+ * @param lost_num lost log number of every context
+ *
+ * @return broken line number
+ */
+static size_t check_lines(uint32_t *line_num, uint32_t *lost_num) {
+    size_t size = elog_port_host_get_output_size(), broken = 0;
+    char *line = capture_buf, *end, *msg;
+    uint32_t next_num[CTX_NUM] = { 0 };
+    unsigned int n;
+    int ctx, data_pos;
+
+    while (line < capture_buf + size) {
+        end = memchr(line, '\n', capture_buf + size - line);
+        if (end == NULL) {
+            broken++;
+            break;
+        }
+        *end = '\0';
+        if (end > line && end[-1] == '\r') {
+            end[-1] = '\0';
+        }
+        msg = strstr(line, "ctx ");
+        if (msg == NULL) {
+            /* the initialize log */
+            if (strstr(line, "EasyLogger") == NULL) {
+                broken++;
+            }
+        } else if (sscanf(msg, "ctx %d n %u data %n", &ctx, &n, &data_pos) != 2 || ctx < 0 || ctx >= CTX_NUM
+                || strcmp(msg + data_pos, pad + n % PAD_MAX_OFFSET) != 0 || n < next_num[ctx]) {
+            broken++;
+        } else {
+            lost_num[ctx] += n - next_num[ctx];
+            next_num[ctx] = n + 1;
+            line_num[ctx]++;
+        }
+        line = end + 1;
+    }
+    for (ctx = 0; ctx < CTX_NUM; ctx++) {
+        lost_num[ctx] += log_num[ctx] - next_num[ctx];
+    }
+
+    return broken;
+}
+
+int main(void) {
+    static const char *ctx_name[CTX_NUM] = { "main", "isr low", "isr high" };
+    uint32_t line_num[CTX_NUM] = { 0 }, lost_num[CTX_NUM] = { 0 }, lost = 0;
+    sigset_t irq_set, low_mask;
+    HostLockStat lock_stat;
+    uint64_t stop_time;
+    size_t broken;
+    int ctx;
+
+    /* the capture buffer pages are touched first, so the page fault is not in the output lock */
+    memset(capture_buf, 0, sizeof(capture_buf));
+    elog_port_host_capture(capture_buf, sizeof(capture_buf));
+    elog_init();
+    elog_start();
+    /* the logs are output in the log call, the line end is checked without color */
+    elog_deferred_enabled(false);
+    elog_set_text_color_enabled(false);
+
+    /* the high ISR can't be preempted, the low ISR is only preempted by the high ISR */
+    sigemptyset(&irq_set);
+    sigaddset(&irq_set, SIGRTMIN);
+    sigaddset(&irq_set, SIGRTMIN + 1);
+    sigemptyset(&low_mask);
+    sigaddset(&low_mask, SIGRTMIN);
+    elog_port_host_irq_sim(&irq_set);
+    elog_port_host_reset_lock_stat();
+    elog_stat_reset();
+    isr_start(CTX_ISR_LOW, SIGRTMIN, isr_low_handler, &low_mask, ISR_LOW_PERIOD);
+    isr_start(CTX_ISR_HIGH, SIGRTMIN + 1, isr_high_handler, &irq_set, ISR_HIGH_PERIOD);
+
+    stop_time = elog_port_host_now_ns() + RUN_TIME * 1000000ULL;
+    while (elog_port_host_now_ns() < stop_time && elog_port_host_get_output_size() < CAPTURE_STOP_SIZE) {
+        ctx_log(CTX_MAIN);
+    }
+
+    /* stop the simulated interrupts before checking */
+    sigprocmask(SIG_BLOCK, &irq_set, NULL);
+    timer_delete(isr_timer[CTX_ISR_LOW]);
+    timer_delete(isr_timer[CTX_ISR_HIGH]);
+    elog_port_host_irq_sim(NULL);
+    elog_port_host_get_lock_stat(&lock_stat);
+    broken = check_lines(line_num, lost_num);
+
+    printf("nested ISR preemption stress, %u ms\n", RUN_TIME);
+    for (ctx = 0; ctx < CTX_NUM; ctx++) {
+        printf("  %-10s logs %8u, preempting %8u, lost %u\n", ctx_name[ctx], (unsigned int) line_num[ctx],
+                (unsigned int) preempt_num[ctx], (unsigned int) lost_num[ctx]);
+        lost += lost_num[ctx];
+    }
+    printf("  output lock %u times, max nested %u\n", (unsigned int) lock_stat.num, (unsigned int) lock_stat.max_nest);
+    printf("  interrupt masked p99 <= %llu ns, p99.9 <= %llu ns, max %llu ns (with host scheduling)\n",
+            (unsigned long long) elog_port_host_get_lock_time(&lock_stat, 99.0),
+            (unsigned long long) elog_port_host_get_lock_time(&lock_stat, 99.9),
+            (unsigned long long) lock_stat.max_time);
+    printf("  context buffer dropped %u, broken lines %u\n", (unsigned int) elog_get_ctx_drop_num(),
+            (unsigned int) broken);
+
+    /* the lost log must be counted by context buffer drop, no line is broken */
+    return (broken || lost != elog_get_ctx_drop_num() || preempt_num[CTX_ISR_HIGH] == 0) ? EXIT_FAILURE
+            : EXIT_SUCCESS;
+}
@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+#
+# This file is part of the EasyLogger Library.
+#
+# Copyright (c) 2025, Ethan-Hang
+#
+# Function: Binary output round trip test. The stream which is output by
+#           bin_roundtrip is decoded by tools/elog_decode.py with the same ELF
+#           file, then every log is checked with the expected text.
+# Created on: 2026-10-17
+#
+# usage: test_elog_decode.py bin_roundtrip stream.bin expected.txt
+#
+
+import io
+import os
+import re
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+import elog_decode  # noqa: E402
+
+# the log line rebuilt by render_log(): level/tag, sequence, time, location, then the text
+LOG_LINE = re.compile(r"^([AEWIDV?])/(\S*)\s+#(\d+) \[\s*\d+\.\d{6}\] (?:\([^)]*\))?(.*)$")
+
+
+def main():
+    if len(sys.argv) != 4:
+        print("usage: test_elog_decode.py bin_roundtrip stream.bin expected.txt")
+        return 1
+    elf, stream_path, expected_path = sys.argv[1:]
+    sites = elog_decode.Sites(elog_decode.Elf(elf))
+    with open(stream_path, "rb") as f:
+        stream = f.read()
+    with open(expected_path) as f:
+        expected = f.read().splitlines()
+
+    out = io.StringIO()
+    elog_decode.decode(stream, sites, out)
+    decoded = []
+    seqs = []
+    for line in out.getvalue().splitlines():
+        match = LOG_LINE.match(line)
+        if match:
+            decoded.append("%s/%s|%s" % (match.group(1), match.group(2), match.group(4)))
+            seqs.append(int(match.group(3)))
+        else:
+            decoded.append("raw|" + line)
+
+    fail = 0
+    for i in range(max(len(expected), len(decoded))):
+        want = expected[i] if i < len(expected) else None
+        got = decoded[i] if i < len(decoded) else None
+        if want != got:
+            print("log %d mismatched:\n  expected %r\n  decoded  %r" % (i, want, got))
+            fail += 1
+    # every log takes the next sequence number
+    if not seqs or seqs != list(range(seqs[0], seqs[0] + len(seqs))):
+        print("sequence numbers are not continuous: %s" % seqs)
+        fail += 1
+    print("binary output round trip, %d logs, %d bytes, %s" % (len(expected), len(stream),
+                                                               "failed" if fail else "passed"))
+    return 1 if fail else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,91 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Simulated UART_0 peripheral, NVIC and PRIMASK for the host build
+ *           of Driver/Src/bsp_uart.c. It replaces the SysConfig generated
+ *           header, the model is implemented in uart_sim.c.
+ * Created on: 2026-10-17
+ */
+
+#ifndef __TI_MSP_DL_CONFIG_SIM_H__
+#define __TI_MSP_DL_CONFIG_SIM_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* simulated UART_0 instance */
+typedef struct {
+    uint32_t id;
+} UART_Regs;
+
+extern UART_Regs uart_sim_regs;
+
+#define UART_0_INST                             (&uart_sim_regs)
+#define UART_0_INST_FREQUENCY                   40000000U
+#define UART_0_INST_INT_IRQN                    15
+#define UART_0_INST_IRQHandler                  uart_sim_irq_handler
+
+/* TX FIFO depth of the MSPM0G3507 UART */
+#define UART_SIM_FIFO_SIZE                      4
+
+#define DL_UART_MAIN_INTERRUPT_TX               (1U << 0)
+#define DL_UART_MAIN_INTERRUPT_EOT_DONE         (1U << 1)
+#define DL_UART_MAIN_TX_FIFO_LEVEL_1_2_EMPTY    2U
+
+typedef enum {
+    DL_UART_MAIN_IIDX_NO_INTERRUPT = 0,
+    DL_UART_MAIN_IIDX_TX,
+    DL_UART_MAIN_IIDX_EOT_DONE,
+} DL_UART_MAIN_IIDX;
+
+void DL_UART_Main_enable(UART_Regs *uart);
+void DL_UART_Main_disable(UART_Regs *uart);
+void DL_UART_Main_configBaudRate(UART_Regs *uart, uint32_t clock, uint32_t baud_rate);
+void DL_UART_Main_enableFIFOs(UART_Regs *uart);
+void DL_UART_Main_setTXFIFOThreshold(UART_Regs *uart, uint32_t threshold);
+void DL_UART_Main_enableInterrupt(UART_Regs *uart, uint32_t interrupt);
+void DL_UART_Main_disableInterrupt(UART_Regs *uart, uint32_t interrupt);
+bool DL_UART_Main_isTXFIFOFull(UART_Regs *uart);
+void DL_UART_Main_transmitData(UART_Regs *uart, uint8_t data);
+DL_UART_MAIN_IIDX DL_UART_Main_getPendingInterrupt(UART_Regs *uart);
+
+void NVIC_EnableIRQ(int irqn);
+void NVIC_SetPendingIRQ(int irqn);
+void NVIC_ClearPendingIRQ(int irqn);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t primask);
+void __disable_irq(void);
+void __enable_irq(void);
+
+void uart_sim_irq_handler(void);
+void *uart_sim_memcpy(void *dst, const void *src, size_t size);
+
+/* the driver's copy runs with the interrupts enabled, the simulated UART shifts and the
+ * interrupts are taken between the copied bytes */
+#ifndef UART_SIM_MODEL
+#define memcpy                                  uart_sim_memcpy
+#endif
+
+#endif /* __TI_MSP_DL_CONFIG_SIM_H__ */
@@ -0,0 +1,413 @@
+/*
+ * This file is part of the EasyLogger Library.
+ *
+ * Copyright (c) 2025, Ethan-Hang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * 'Software'), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED 'AS IS', WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Function: Driver/Src/bsp_uart.c test with a simulated UART peripheral. The
+ *           model has the 4 bytes TX FIFO with the half empty threshold, the
+ *           TX and EOT interrupts, NVIC pending and PRIMASK. One byte is
+ *           shifted out per tick, the ticks run between the bytes which are
+ *           copied by the driver, and a simulated ISR writes in the tick. The random size writes, forced drops and buffer
+ *           swaps are checked by the output bytes and the driver statistics.
+ * Created on: 2026-10-17
+ */
+
+#define UART_SIM_MODEL
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ti_msp_dl_config.h"
+#include "bsp_uart.h"
+
+/* write number of the test, every write has a sequence number */
+#define WRITE_NUM           60000
+/* write record: magic, 24-bit sequence number, 16-bit size, then the pattern */
+#define RECORD_MAGIC        0xA5
+#define RECORD_HEAD_SIZE    6
+#define RECORD_MAX_SIZE     (BSP_UART_TX_BUF_SIZE + 88)
+/* the simulated ISR writes in a tick by 1 / ISR_WRITE_RATE */
+#define ISR_WRITE_RATE      97
+/* max tick number to drain the driver after the last write */
+#define DRAIN_MAX_TICK      (4 * BSP_UART_TX_BUF_SIZE)
+#define OUTPUT_BUF_SIZE     (WRITE_NUM * (RECORD_MAX_SIZE / 4))
+
+/* execution level, the higher level preempts the lower one. The UART ISR preempts the writer ISR,
+ * so the send buffer goes on while the preempted thread mode write is not copied */
+#define LEVEL_THREAD        0
+#define LEVEL_WRITER_ISR    1
+#define LEVEL_UART_ISR      2
+
+UART_Regs uart_sim_regs;
+
+static struct {
+    uint8_t fifo[UART_SIM_FIFO_SIZE];
+    size_t fifo_head;
+    size_t fifo_num;
+    uint32_t imask;
+    uint32_t ris;
+    bool enabled;
+    bool nvic_enabled;
+    bool nvic_pending;
+    uint32_t primask;
+    int level;
+    /* the shift register is stopped, such as the line is held by flow control */
+    bool stalled;
+    /* the simulated ISR writes in the tick */
+    bool isr_write;
+    uint32_t isr_num;
+    uint32_t fifo_overflow;
+    uint32_t level_error;
+} uart;
+
+static uint8_t output_buf[OUTPUT_BUF_SIZE];
+static size_t output_size;
+
+/* the test's expected result */
+static uint32_t next_seq;
+static bool accepted[WRITE_NUM * 2];
+#define SEQ_MAX_NUM         (sizeof(accepted) / sizeof(accepted[0]))
+static uint32_t accepted_bytes, dropped_bytes, dropped_num, nested_num, oversize_num;
+static uint32_t rand_state = 0x12345678;
+
+static uint32_t sim_rand(void) {
+    /* xorshift32, the test is repeatable */
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+}
+
+/**
+ * take the UART interrupt when it is pending, enabled and not masked
+ */
+static void uart_take_irq(void) {
+    if (uart.ris & uart.imask) {
+        uart.nvic_pending = true;
+    }
+    while (uart.nvic_enabled && uart.nvic_pending && uart.primask == 0 && uart.level < LEVEL_UART_ISR) {
+        int level = uart.level;
+
+        uart.nvic_pending = false;
+        uart.level = LEVEL_UART_ISR;
+        uart.isr_num++;
+        UART_0_INST_IRQHandler();
+        uart.level = level;
+        /* the interrupt is level triggered, the uncleared one is pending again */
+        if (uart.ris & uart.imask) {
+            uart.nvic_pending = true;
+        }
+    }
+}
+
+static void write_record(void);
+
+/**
+ * one byte time of the UART
+ */
+static void uart_tick(void) {
+    if (uart.enabled && !uart.stalled && uart.fifo_num) {
+        output_buf[output_size++] = uart.fifo[uart.fifo_head];
+        uart.fifo_head = (uart.fifo_head + 1) % UART_SIM_FIFO_SIZE;
+        uart.fifo_num--;
+        /* the TX interrupt is set when the level reaches the threshold */
+        if (uart.fifo_num == DL_UART_MAIN_TX_FIFO_LEVEL_1_2_EMPTY) {
+            uart.ris |= DL_UART_MAIN_INTERRUPT_TX;
+        }
+        if (uart.fifo_num == 0) {
+            uart.ris |= DL_UART_MAIN_INTERRUPT_EOT_DONE;
+        }
+    }
+    uart_take_irq();
+    /* the ISR writes, it preempts the thread mode write */
+    if (uart.isr_write && uart.primask == 0 && uart.level == LEVEL_THREAD && sim_rand() % ISR_WRITE_RATE == 0) {
+        uart.level = LEVEL_WRITER_ISR;
+        write_record();
+        uart.level = LEVEL_THREAD;
+        uart_take_irq();
+    }
+}
+
+void DL_UART_Main_enable(UART_Regs *uart_regs) {
+    uart.enabled = true;
+}
+
+void DL_UART_Main_disable(UART_Regs *uart_regs) {
+    uart.enabled = false;
+}
+
+void DL_UART_Main_configBaudRate(UART_Regs *uart_regs, uint32_t clock, uint32_t baud_rate) {
+}
+
+void DL_UART_Main_enableFIFOs(UART_Regs *uart_regs) {
+}
+
+void DL_UART_Main_setTXFIFOThreshold(UART_Regs *uart_regs, uint32_t threshold) {
+}
+
+void DL_UART_Main_enableInterrupt(UART_Regs *uart_regs, uint32_t interrupt) {
+    uart.imask |= interrupt;
+    uart_take_irq();
+}
+
+void DL_UART_Main_disableInterrupt(UART_Regs *uart_regs, uint32_t interrupt) {
+    uart.imask &= ~interrupt;
+}
+
+bool DL_UART_Main_isTXFIFOFull(UART_Regs *uart_regs) {
+    return uart.fifo_num == UART_SIM_FIFO_SIZE;
+}
+
+void DL_UART_Main_transmitData(UART_Regs *uart_regs, uint8_t data) {
+    if (uart.level != LEVEL_UART_ISR) {
+        uart.level_error++;
+    }
+    if (uart.fifo_num == UART_SIM_FIFO_SIZE) {
+        uart.fifo_overflow++;
+        return;
+    }
+    uart.fifo[(uart.fifo_head + uart.fifo_num) % UART_SIM_FIFO_SIZE] = data;
+    uart.fifo_num++;
+}
+
+DL_UART_MAIN_IIDX DL_UART_Main_getPendingInterrupt(UART_Regs *uart_regs) {
+    uint32_t mis = uart.ris & uart.imask;
+
+    /* reading the index clears the highest priority interrupt */
+    if (mis & DL_UART_MAIN_INTERRUPT_TX) {
+        uart.ris &= ~DL_UART_MAIN_INTERRUPT_TX;
+        return DL_UART_MAIN_IIDX_TX;
+    }
+    if (mis & DL_UART_MAIN_INTERRUPT_EOT_DONE) {
+        uart.ris &= ~DL_UART_MAIN_INTERRUPT_EOT_DONE;
+        return DL_UART_MAIN_IIDX_EOT_DONE;
+    }
+    return DL_UART_MAIN_IIDX_NO_INTERRUPT;
+}
+
+void NVIC_EnableIRQ(int irqn) {
+    uart.nvic_enabled = true;
+    uart_take_irq();
+}
+
+void NVIC_SetPendingIRQ(int irqn) {
+    uart.nvic_pending = true;
+    uart_take_irq();
+}
+
+void NVIC_ClearPendingIRQ(int irqn) {
+    uart.nvic_pending = false;
+}
+
+uint32_t __get_PRIMASK(void) {
+    return uart.primask;
+}
+
+void __set_PRIMASK(uint32_t primask) {
+    uart.primask = primask;
+    uart_take_irq();
+}
+
+void __disable_irq(void) {
+    uart.primask = 1;
+}
+
+void __enable_irq(void) {
+    __set_PRIMASK(0);
+}
+
+void *uart_sim_memcpy(void *dst, const void *src, size_t size) {
+    uint8_t *d = dst;
+    const uint8_t *s = src;
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        d[i] = s[i];
+        uart_tick();
+    }
+    return dst;
+}
+
+static uint8_t record_pattern(uint32_t seq, size_t i) {
+    return (uint8_t) (seq * 7 + i);
+}
+
+/**
+ * write a record with the random size, the oversize one is always dropped
+ */
+static void write_record(void) {
+    uint8_t record[RECORD_MAX_SIZE];
+    uint32_t seq = next_seq++;
+    size_t size, i, result;
+
+    if (seq >= SEQ_MAX_NUM) {
+        printf("  too many nested writes\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (sim_rand() % 64 == 0) {
+        size = BSP_UART_TX_BUF_SIZE + 1 + sim_rand() % (RECORD_MAX_SIZE - BSP_UART_TX_BUF_SIZE);
+        oversize_num++;
+    } else {
+        size = RECORD_HEAD_SIZE + sim_rand() % 160;
+    }
+    record[0] = RECORD_MAGIC;
+    record[1] = (uint8_t) seq;
+    record[2] = (uint8_t) (seq >> 8);
+    record[3] = (uint8_t) (seq >> 16);
+    record[4] = (uint8_t) size;
+    record[5] = (uint8_t) (size >> 8);
+    for (i = RECORD_HEAD_SIZE; i < size; i++) {
+        record[i] = record_pattern(seq, i);
+    }
+    if (uart.level == LEVEL_WRITER_ISR) {
+        nested_num++;
+    }
+
+    result = bsp_uart_write(record, size);
+    if (result == size) {
+        accepted[seq] = true;
+        accepted_bytes += size;
+    } else if (result == 0) {
+        dropped_bytes += size;
+        dropped_num++;
+    } else {
+        printf("  write %u returns %u of %u\n", (unsigned int) seq, (unsigned int) result, (unsigned int) size);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * check the output is the accepted records in the write order
+ *
+ * @param record_num output record number
+ *
+ * @return broken record number
+ */
+static uint32_t check_output(uint32_t *record_num) {
+    uint32_t broken = 0, seq, last_seq = 0, expect_num = 0;
+    size_t pos = 0, size, i;
+    bool first = true;
+
+    *record_num = 0;
+    while (pos < output_size) {
+        if (output_size - pos < RECORD_HEAD_SIZE || output_buf[pos] != RECORD_MAGIC) {
+            return broken + 1;
+        }
+        seq = output_buf[pos + 1] | (output_buf[pos + 2] << 8) | ((uint32_t) output_buf[pos + 3] << 16);
+        size = output_buf[pos + 4] | (output_buf[pos + 5] << 8);
+        if (size < RECORD_HEAD_SIZE || size > output_size - pos || seq >= next_seq || !accepted[seq]
+                || (!first && seq <= last_seq)) {
+            return broken + 1;
+        }
+        for (i = RECORD_HEAD_SIZE; i < size; i++) {
+            if (output_buf[pos + i] != record_pattern(seq, i)) {
+                broken++;
+                break;
+            }
+        }
+        first = false;
+        last_seq = seq;
+        pos += size;
+        (*record_num)++;
+    }
+    for (seq = 0; seq < next_seq; seq++) {
+        expect_num += accepted[seq];
+    }
+
+    return broken + (expect_num != *record_num);
+}
+
+int main(void) {
+    bsp_uart_stat_t stat;
+    uint32_t n, tick, record_num, broken, fail = 0;
+
+    bsp_uart_init(921600);
+
+    for (n = 0; n < WRITE_NUM; n++) {
+        switch (n / 1000 % 4) {
+        case 0:
+            /* under the line rate, the ticks are more than the written bytes */
+            uart.isr_write = false;
+            write_record();
+            for (tick = sim_rand() % 200; tick; tick--) {
+                uart_tick();
+            }
+            break;
+        case 1:
+            /* the nested writes in the copy and between the writes */
+            uart.isr_write = true;
+            write_record();
+            for (tick = sim_rand() % 120; tick; tick--) {
+                uart_tick();
+            }
+            break;
+        case 2:
+            /* burst over the line rate, the writes are dropped when the fill buffer is full */
+            uart.isr_write = true;
+            write_record();
+            for (tick = sim_rand() % 8; tick; tick--) {
+                uart_tick();
+            }
+            break;
+        default:
+            /* the line is stalled for some writes, every write is dropped after the buffers are full */
+            uart.isr_write = false;
+            uart.stalled = (n % 200) < 100;
+            write_record();
+            for (tick = sim_rand() % 40; tick; tick--) {
+                uart_tick();
+            }
+            break;
+        }
+    }
+
+    uart.isr_write = false;
+    uart.stalled = false;
+    for (tick = 0; tick < DRAIN_MAX_TICK && !(bsp_uart_is_idle() && uart.fifo_num == 0); tick++) {
+        uart_tick();
+    }
+
+    bsp_uart_get_stat(&stat);
+    broken = check_output(&record_num);
+
+    printf("UART driver with the simulated peripheral, %u writes\n", (unsigned int) next_seq);
+    printf("  output %u records, %u bytes, nested writes %u, UART ISR %u times\n", (unsigned int) record_num,
+            (unsigned int) output_size, (unsigned int) nested_num, (unsigned int) uart.isr_num);
+    printf("  stat tx_bytes %u, drop_num %u, drop_bytes %u, swap_num %u, max_used %u\n",
+            (unsigned int) stat.tx_bytes, (unsigned int) stat.drop_num, (unsigned int) stat.drop_bytes,
+            (unsigned int) stat.swap_num, (unsigned int) stat.max_used);
+    printf("  broken records %u, FIFO overflow %u, drain %u ticks\n", (unsigned int) broken,
+            (unsigned int) uart.fifo_overflow, (unsigned int) tick);
+
+    /* the output is the accepted bytes in the write order */
+    fail |= broken || output_size != accepted_bytes || uart.fifo_overflow || uart.level_error;
+    /* the statistics match the write results */
+    fail |= stat.tx_bytes != accepted_bytes || stat.drop_bytes != dropped_bytes || stat.drop_num != dropped_num;
+    /* every sent byte is in a swapped buffer, and the fill buffer is never over used */
+    fail |= (uint64_t) stat.swap_num * BSP_UART_TX_BUF_SIZE < stat.tx_bytes || stat.max_used > BSP_UART_TX_BUF_SIZE;
+    /* the driver is idle after drain, and the test covers the drops and nested writes */
+    fail |= !bsp_uart_is_idle() || tick == DRAIN_MAX_TICK || dropped_num <= oversize_num || nested_num == 0;
+
+    return fail ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -2206,6 +2206,94 @@ unsigned SEGGER_RTT_GetAvailWriteSpace(unsigned BufferIndex)
     return _GetAvailWriteSpace(pRing);
 }
 
+/*********************************************************************
+ *
+ *       SEGGER_RTT_ReserveNoLock()
+ *
+ *  Function description
+ *    Reserves a region inside an up-buffer, so the application can
+ *    write data into the buffer directly without a copy.
+ *    The region is published to the host by SEGGER_RTT_CommitNoLock().
+ *    Do not lock against interrupts and multiple access.
+ *
+ *  Parameters
+ *    BufferIndex  Index of "Up"-buffer to be used (e.g. 0 for "Terminal").
+ *    NumBytes     Number of bytes to be reserved.
+ *    pResv        Pointer to reservation, it receives 1 or 2 spans.
+ *
+ *  Return value
+ *    Number of bytes which have been reserved, it is 0 if there is not enough space.
+ *
+ *  Notes
+ *    (1) The caller must hold the lock (such as SEGGER_RTT_LOCK()) until
+ *        the reservation is committed, no other write is allowed between.
+ *    (2) For performance reasons this function does not call Init()
+ *        and may only be called after RTT has been initialized.
+ *        Either by calling SEGGER_RTT_Init() or calling another RTT API function first.
+ */
+unsigned SEGGER_RTT_ReserveNoLock(unsigned BufferIndex, unsigned NumBytes, SEGGER_RTT_RESERVATION *pResv)
+{
+    SEGGER_RTT_BUFFER_UP *pRing;
+    unsigned WrOff;
+    unsigned Rem;
+
+    pRing = (SEGGER_RTT_BUFFER_UP *)((char *)&_SEGGER_RTT.aUp[BufferIndex] + SEGGER_RTT_UNCACHED_OFF); // Access uncached to make sure we see changes made by the J-Link side and all of our changes go into HW directly
+    if (_GetAvailWriteSpace(pRing) < NumBytes)
+    {
+        return 0; // No space in buffer
+    }
+    WrOff = pRing->WrOff;
+    Rem = pRing->SizeOfBuffer - WrOff; // Space until end of buffer
+    pResv->BufferIndex = BufferIndex;
+    pResv->WrOff = WrOff;
+    pResv->pData0 = (pRing->pBuffer + WrOff) + SEGGER_RTT_UNCACHED_OFF;
+    if (Rem >= NumBytes)
+    {
+        pResv->NumBytes0 = NumBytes;
+        pResv->pData1 = NULL;
+        pResv->NumBytes1 = 0;
+    }
+    else
+    {
+        //
+        // We reach the end of the buffer, so the 2nd span starts from the beginning
+        //
+        pResv->NumBytes0 = Rem;
+        pResv->pData1 = pRing->pBuffer + SEGGER_RTT_UNCACHED_OFF;
+        pResv->NumBytes1 = NumBytes - Rem;
+    }
+    return NumBytes;
+}
+
+/*********************************************************************
+ *
+ *       SEGGER_RTT_CommitNoLock()
+ *
+ *  Function description
+ *    Publishes the data which is written into a reserved region to the
+ *    host by updating the write pointer of the up-buffer.
+ *    Do not lock against interrupts and multiple access.
+ *
+ *  Parameters
+ *    pResv        Pointer to reservation from SEGGER_RTT_ReserveNoLock().
+ *    NumBytes     Number of bytes which have been written, it must not be
+ *                 more than the reserved size. The rest is released.
+ */
+void SEGGER_RTT_CommitNoLock(const SEGGER_RTT_RESERVATION *pResv, unsigned NumBytes)
+{
+    SEGGER_RTT_BUFFER_UP *pRing;
+    unsigned WrOff;
+
+    pRing = (SEGGER_RTT_BUFFER_UP *)((char *)&_SEGGER_RTT.aUp[pResv->BufferIndex] + SEGGER_RTT_UNCACHED_OFF); // Access uncached to make sure we see changes made by the J-Link side and all of our changes go into HW directly
+    WrOff = pResv->WrOff + NumBytes;
+    if (WrOff >= pRing->SizeOfBuffer)
+    {
+        WrOff -= pRing->SizeOfBuffer;
+    }
+    RTT__DMB(); // Force data write to be complete before writing the <WrOff>, in case CPU is allowed to change the order of memory accesses
+    pRing->WrOff = WrOff;
+}
+
 /*********************************************************************
  *
  *       SEGGER_RTT_GetBytesInBuffer()
@@ -265,6 +265,19 @@ typedef struct {
 #endif
 } SEGGER_RTT_CB;
 
+//
+// Description for a region which is reserved inside an up-buffer.
+// The region is split into 2 spans when it wraps around the end of the buffer.
+//
+typedef struct {
+            char*    pData0;        // Pointer to first span
+            unsigned NumBytes0;     // Size of first span
+            char*    pData1;        // Pointer to second span at start of buffer, NULL if not wrapped
+            unsigned NumBytes1;     // Size of second span
+            unsigned BufferIndex;   // Index of up-buffer
+            unsigned WrOff;         // Position of the reserved region, it is published on commit
+} SEGGER_RTT_RESERVATION;
+
 /*********************************************************************
 *
 *       Global data
@@ -309,6 +322,8 @@ unsigned     SEGGER_RTT_PutCharSkip             (unsigned BufferIndex, char c);
 unsigned     SEGGER_RTT_PutCharSkipNoLock       (unsigned BufferIndex, char c);
 unsigned     SEGGER_RTT_GetAvailWriteSpace      (unsigned BufferIndex);
 unsigned     SEGGER_RTT_GetBytesInBuffer        (unsigned BufferIndex);
+unsigned     SEGGER_RTT_ReserveNoLock           (unsigned BufferIndex, unsigned NumBytes, SEGGER_RTT_RESERVATION* pResv);
+void         SEGGER_RTT_CommitNoLock            (const SEGGER_RTT_RESERVATION* pResv, unsigned NumBytes);
 //
 // Function macro for performance optimization
 //